@@ -238,7 +238,7 @@ void example_production_monitoring() {
     std::cout << "Dropped:     " << snapshot.messages_dropped << " (" 
               << (100.0 * snapshot.messages_dropped / snapshot.messages_logged) << "%)\n";
     std::cout << "Latency (avg): " << snapshot.avg_log_latency_us << " µs\n";
-    std::cout << "Latency (p99): " << snapshot.max_log_latency_us << " µs\n";
+    std::cout << "Latency (p99): " << snapshot.log_latency_p99_ns / 1000.0 << " µs\n";
     std::cout << "Queue Depth: " << snapshot.current_queue_depth << " / " 
               << snapshot.max_queue_depth << "\n";
     
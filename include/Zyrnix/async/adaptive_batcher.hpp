@@ -0,0 +1,62 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+
+namespace Zyrnix {
+
+struct AdaptiveBatchOptions {
+    size_t max_batch = 1024;
+    // Longest a record may wait in the queue so the backend can build a
+    // larger batch. Zero disables lingering: whatever is queued is written.
+    std::chrono::microseconds max_delay{1000};
+};
+
+/**
+ * @brief Chooses backend batch sizes from the observed load (v1.1.3)
+ *
+ * The backend thread reports every batch it writes. From that the batcher
+ * keeps moving averages of the arrival rate and of the write time, and
+ * targets the number of records that arrive within the latency budget
+ * (max_delay minus one write). Under light traffic the target is one
+ * record, so records are written as soon as they arrive; under load the
+ * backend lingers until the target is queued or the oldest record reaches
+ * its deadline, trading a bounded delay for fewer writes and lock
+ * acquisitions.
+ *
+ * Not thread-safe: owned by one backend thread (or guarded by its lock).
+ */
+class AdaptiveBatcher {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit AdaptiveBatcher(const AdaptiveBatchOptions& options = AdaptiveBatchOptions{});
+
+    /**
+     * @brief Records worth waiting for before writing
+     */
+    size_t target() const { return target_; }
+
+    /**
+     * @brief Latest time to start writing a batch whose oldest record was queued at @p oldest
+     */
+    Clock::time_point deadline(Clock::time_point oldest) const;
+
+    /**
+     * @brief Report a written batch
+     * @param records Records in the batch
+     * @param started When the backend took the batch off the queue
+     * @param write_time How long writing it took
+     */
+    void on_batch(size_t records, Clock::time_point started, Clock::duration write_time);
+
+    const AdaptiveBatchOptions& options() const { return options_; }
+
+private:
+    AdaptiveBatchOptions options_;
+    size_t target_ = 1;
+    double arrivals_per_us_ = 0.0;
+    double write_us_ = 0.0;
+    Clock::time_point last_start_{};
+};
+
+}
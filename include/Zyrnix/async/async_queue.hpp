@@ -1,6 +1,12 @@
 #pragma once
 #include "../log_record.hpp"
-#include <queue>
+#include "backend_thread.hpp"
+#include "adaptive_batcher.hpp"
+#include <deque>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
 #include <mutex>
 #include <condition_variable>
 #include <chrono>
@@ -8,6 +14,8 @@
 
 namespace Zyrnix {
 
+class LogMetrics;
+
 /**
  * @brief Thread-safe async queue with flush guarantees
  * 
@@ -39,6 +47,47 @@ public:
      * @return true if a record was popped, false if queue is shutting down
      */
     bool pop(LogRecord& record);
+
+    /**
+     * @brief Pop without waiting (v1.1.3)
+     * @return true if a record was popped
+     */
+    bool try_pop(LogRecord& record);
+
+    /**
+     * @brief Pop, waiting at most @p timeout (v1.1.3)
+     * @return true if a record was popped, false on timeout or shutdown
+     */
+    bool pop_for(LogRecord& record, std::chrono::microseconds timeout);
+
+    /**
+     * @brief Choose how pop() waits for records (v1.1.3)
+     *
+     * With SpinYield or BusySpin the consumer polls before (or instead of)
+     * sleeping, and push() skips the condition variable notify while no
+     * consumer is asleep. Set before consumers start.
+     */
+    void set_wait_options(const WaitOptions& options);
+
+    using BatchWriter = std::function<void(std::span<const LogRecord>)>;
+
+    /**
+     * @brief Pop an adaptively sized batch and hand it to @p write (v1.1.3)
+     *
+     * Waits like pop() for the first record, then, under load, lingers for
+     * more as set_batching() allows. The batch size and each record's
+     * enqueue-to-write latency are recorded in the metrics given to
+     * set_metrics(), and the write time feeds the batch size estimate.
+     * @param batch Reusable buffer that receives the records
+     * @return Records written, 0 if the queue is shutting down and empty
+     */
+    size_t consume_batch(std::vector<LogRecord>& batch, const BatchWriter& write);
+
+    /**
+     * @brief Configure consume_batch() (v1.1.3). Set before consumers start.
+     */
+    void set_batching(const AdaptiveBatchOptions& options);
+    void set_metrics(std::shared_ptr<LogMetrics> metrics);
     
     /**
      * @brief Check if queue is empty
@@ -74,13 +123,29 @@ public:
     size_t dropped_on_shutdown() const;
 
 private:
-    std::queue<LogRecord> queue_;
+    struct Entry {
+        LogRecord record;
+        std::chrono::steady_clock::time_point enqueued;
+    };
+
+    std::deque<Entry> queue_;
     mutable std::mutex mtx_;
     std::condition_variable cv_;
     std::condition_variable drain_cv_;
     std::atomic<bool> shutdown_{false};
     std::atomic<size_t> dropped_count_{0};
     size_t shutdown_timeout_ms_;
+    WaitOptions wait_;
+    std::atomic<size_t> size_{0};     // Mirrors queue_.size() for lock-free polling
+    int sleepers_ = 0;                // Consumers blocked on cv_ (guarded by mtx_)
+    int lingerers_ = 0;               // Of those, consumers lingering for a batch
+    size_t wake_threshold_ = 1;       // Backlog a lingering consumer waits for
+    AdaptiveBatcher batcher_;         // Guarded by mtx_
+    std::shared_ptr<LogMetrics> metrics_;
+
+    bool wait_for_record(std::unique_lock<std::mutex>& lock);
+
+    bool take_locked(LogRecord& record);
 };
 
 }
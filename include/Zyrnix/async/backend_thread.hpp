@@ -0,0 +1,79 @@
+#pragma once
+#include "spin_wait.hpp"
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+namespace Zyrnix {
+
+/**
+ * @brief How a backend thread waits for work (v1.1.3)
+ */
+enum class WaitPolicy {
+    Block,     // Condition variable only: no idle CPU use, highest wake-up latency
+    SpinYield, // Spin, then yield, then block: low latency after bursts
+    BusySpin   // Never sleeps: lowest latency, burns its core (pin it)
+};
+
+struct WaitOptions {
+    WaitPolicy policy = WaitPolicy::Block;
+    uint32_t spin_iterations = 4000;  // PAUSE loops before yielding (SpinYield)
+    uint32_t yield_iterations = 200;  // sched_yield calls before blocking (SpinYield)
+    // Upper bound for one blocking wait; the thread re-checks for work when it
+    // expires. Zero waits until notified.
+    std::chrono::microseconds block_timeout{0};
+};
+
+/**
+ * @brief Placement and wait behaviour of a backend (writer) thread (v1.1.3)
+ *
+ * Used by the AsyncSink and SinkWorker threads. On Linux,
+ * @p cpu pins the thread, @p numa_node makes its memory allocations
+ * prefer that node (and, without @p cpu, restricts it to the node's CPUs).
+ * Queue buffers are allocated on the backend thread after it is placed,
+ * so they land on the chosen node. Unsupported settings are ignored on
+ * other platforms.
+ */
+struct BackendThreadOptions {
+    int cpu = -1;
+    int numa_node = -1;
+    std::string name; // Thread name shown by top/perf (max 15 chars on Linux)
+    WaitOptions wait;
+};
+
+/**
+ * @brief Apply name, CPU affinity and NUMA policy to the calling thread
+ * @return false if a requested setting could not be applied
+ */
+bool configure_backend_thread(const BackendThreadOptions& options);
+
+/**
+ * @brief Spin and/or yield until @p ready returns true, as @p options allow
+ * @return true if ready, false if the caller should block on its condvar
+ *
+ * BusySpin only returns once ready, so @p ready must also observe shutdown.
+ */
+template <typename Ready>
+bool spin_until(const WaitOptions& options, Ready&& ready) {
+    if (options.policy == WaitPolicy::Block) {
+        return ready();
+    }
+    if (options.policy == WaitPolicy::BusySpin) {
+        while (!ready()) {
+            cpu_relax();
+        }
+        return true;
+    }
+    for (uint32_t i = 0; i < options.spin_iterations; ++i) {
+        if (ready()) return true;
+        cpu_relax();
+    }
+    for (uint32_t i = 0; i < options.yield_iterations; ++i) {
+        if (ready()) return true;
+        std::this_thread::yield();
+    }
+    return ready();
+}
+
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <coroutine>
+#include <type_traits>
+#include <utility>
+#include "../log_context.hpp"
+
+namespace Zyrnix {
+
+namespace detail {
+
+template <typename T>
+decltype(auto) get_awaiter(T&& awaitable) {
+    if constexpr (requires { std::forward<T>(awaitable).operator co_await(); }) {
+        return std::forward<T>(awaitable).operator co_await();
+    } else if constexpr (requires { operator co_await(std::forward<T>(awaitable)); }) {
+        return operator co_await(std::forward<T>(awaitable));
+    } else {
+        return std::forward<T>(awaitable);
+    }
+}
+
+}
+
+/**
+ * @brief Awaiter that carries the coroutine's LogContext across a suspension (v1.1.3)
+ *
+ * The context snapshot is taken when the coroutine suspends and installed
+ * on whichever thread resumes it, so request IDs survive hops between
+ * executors. The snapshot is shared by reference count, not copied.
+ *
+ * The resuming thread keeps the coroutine's context after the coroutine
+ * suspends again; executors that also run plain tasks should install their
+ * own context per task (ThreadPool::enqueue with capture_context, or
+ * ContextScope).
+ *
+ * Example:
+ * @code
+ * Task<void> handle(Request req) {
+ *     LogContext::set("request_id", req.id);
+ *     co_await with_context(executor.schedule());  // may resume elsewhere
+ *     logger->info("still tagged with request_id");
+ * }
+ * @endcode
+ */
+template <typename Awaitable>
+class ContextAwaiter {
+public:
+    using Inner = std::remove_cvref_t<decltype(detail::get_awaiter(std::declval<Awaitable>()))>;
+
+    explicit ContextAwaiter(Awaitable&& awaitable)
+        : inner_(detail::get_awaiter(std::forward<Awaitable>(awaitable))) {}
+
+    bool await_ready() { return inner_.await_ready(); }
+
+    template <typename Promise>
+    auto await_suspend(std::coroutine_handle<Promise> handle) {
+        // Captured before the handle can be resumed on another thread
+        context_ = LogContext::snapshot();
+        suspended_ = true;
+        return inner_.await_suspend(handle);
+    }
+
+    decltype(auto) await_resume() {
+        if (suspended_) {
+            LogContext::restore(context_);
+        }
+        return inner_.await_resume();
+    }
+
+private:
+    Inner inner_;
+    ContextSnapshot context_;
+    bool suspended_ = false;
+};
+
+/**
+ * @brief Wrap an awaitable so the caller's LogContext is restored on resume
+ */
+template <typename Awaitable>
+ContextAwaiter<Awaitable> with_context(Awaitable&& awaitable) {
+    return ContextAwaiter<Awaitable>(std::forward<Awaitable>(awaitable));
+}
+
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include "../log_sink.hpp"
+#include "../log_record.hpp"
+#include "backend_thread.hpp"
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Zyrnix {
+
+class SinkMetrics;
+class LogMetrics;
+
+/**
+ * @brief What a full per-sink queue does with a new record (v1.1.3)
+ */
+enum class OverflowPolicy {
+    Block,       // Caller waits for space (no loss, slow sink throttles the caller)
+    DropNewest,  // New record is discarded
+    DropOldest   // Oldest queued record is discarded to make room
+};
+
+struct SinkQueueOptions {
+    size_t capacity = 8192;
+    OverflowPolicy overflow = OverflowPolicy::Block;
+    BackendThreadOptions backend; // Pinning, NUMA node, wait policy of the worker thread
+};
+
+/**
+ * @brief Bounded queue plus dedicated thread in front of one sink (v1.1.3)
+ *
+ * Records are shared immutable copies, so one log call fanned out to
+ * several queued sinks copies the record once. The worker takes everything
+ * queued in one lock acquisition and writes it outside the lock with one
+ * LogSink::log_batch() call.
+ *
+ * Queue depth, drops, writes and write latency are reported to the
+ * SinkMetrics registered under @p metrics_name; sink exceptions are also
+ * counted in @p logger_metrics when given. The destructor writes the
+ * remaining records before joining the thread.
+ */
+class SinkWorker {
+public:
+    using RecordPtr = std::shared_ptr<const LogRecord>;
+
+    SinkWorker(LogSinkPtr sink, const std::string& metrics_name,
+               const SinkQueueOptions& options = SinkQueueOptions{},
+               std::shared_ptr<LogMetrics> logger_metrics = nullptr);
+    ~SinkWorker();
+
+    SinkWorker(const SinkWorker&) = delete;
+    SinkWorker& operator=(const SinkWorker&) = delete;
+
+    /**
+     * @brief Queue a record, applying the overflow policy when full
+     * @return false if the record (or, for DropOldest, an older one) was
+     *         dropped, including records submitted while the worker stops
+     */
+    bool submit(RecordPtr record);
+
+    /**
+     * @brief Block until every record queued so far has been written
+     */
+    void wait_idle();
+
+    size_t depth() const;
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    const SinkQueueOptions& options() const { return options_; }
+    const LogSinkPtr& sink() const { return sink_; }
+    const std::shared_ptr<SinkMetrics>& metrics() const { return metrics_; }
+
+private:
+    void run();
+    void record_drop();
+
+    LogSinkPtr sink_;
+    SinkQueueOptions options_;
+    std::shared_ptr<SinkMetrics> metrics_;
+    std::shared_ptr<LogMetrics> logger_metrics_;
+
+    mutable std::mutex mtx_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::condition_variable idle_;
+    std::deque<RecordPtr> queue_;
+    bool writing_ = false;
+    std::atomic<bool> stop_{false};
+    std::atomic<size_t> pending_{0};          // Mirrors queue_.size() for the spinning worker
+    std::atomic<bool> worker_blocked_{false}; // Worker sleeps on not_empty_
+    std::atomic<uint64_t> dropped_{0};
+
+    std::thread thread_;
+};
+
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include <thread>
+
+namespace Zyrnix {
+
+/**
+ * @brief Hint to the CPU that the caller is spinning (v1.1.3)
+ *
+ * Emits PAUSE/YIELD where available so a spinning thread does not starve
+ * its hyper-thread sibling; falls back to std::this_thread::yield().
+ */
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield" ::: "memory");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+}
@@ -0,0 +1,162 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Zyrnix {
+
+namespace detail {
+
+constexpr size_t TASK_BLOCK_SIZE = 256;
+
+/**
+ * @brief Fixed-size blocks from a per-thread free list
+ *
+ * Used for callables too large for Task's inline buffer and for the pool's
+ * task nodes. Requests larger than TASK_BLOCK_SIZE go to operator new.
+ * Blocks are aligned for std::max_align_t only.
+ */
+void* allocate_task_block(size_t size);
+void deallocate_task_block(void* block, size_t size) noexcept;
+
+}
+
+/**
+ * @brief Move-only void() callable with small-buffer storage (v1.1.3)
+ *
+ * Callables up to inline_capacity bytes (a dispatch lambda holding a
+ * shared_ptr, a LogRecord pointer and a few values) are stored inside the
+ * Task; larger ones come from a pooled block allocator. Submitting a task
+ * therefore does not hit malloc, unlike std::function, which allocates as
+ * soon as a lambda captures more than two pointers.
+ *
+ * Move-only callables (e.g. lambdas capturing a unique_ptr) are accepted.
+ */
+class Task {
+public:
+    static constexpr size_t inline_capacity = 112;
+
+    Task() noexcept = default;
+
+    template <typename F,
+              typename Fn = std::decay_t<F>,
+              typename = std::enable_if_t<!std::is_same_v<Fn, Task> && std::is_invocable_r_v<void, Fn&>>>
+    Task(F&& fn) {
+        if constexpr (fits_inline<Fn>()) {
+            ::new (static_cast<void*>(storage_)) Fn(std::forward<F>(fn));
+            ops_ = &inline_ops<Fn>;
+        } else {
+            void* block = allocate<Fn>();
+            try {
+                ::new (block) Fn(std::forward<F>(fn));
+            } catch (...) {
+                deallocate<Fn>(block);
+                throw;
+            }
+            *reinterpret_cast<void**>(storage_) = block;
+            ops_ = &pooled_ops<Fn>;
+        }
+    }
+
+    Task(Task&& other) noexcept : ops_(other.ops_) {
+        if (ops_) {
+            ops_->move(storage_, other.storage_);
+            other.ops_ = nullptr;
+        }
+    }
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            reset();
+            ops_ = other.ops_;
+            if (ops_) {
+                ops_->move(storage_, other.storage_);
+                other.ops_ = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() { reset(); }
+
+    // An empty Task does nothing
+    void operator()() {
+        if (ops_) ops_->invoke(storage_);
+    }
+
+    explicit operator bool() const noexcept { return ops_ != nullptr; }
+
+    void reset() noexcept {
+        if (ops_) {
+            ops_->destroy(storage_);
+            ops_ = nullptr;
+        }
+    }
+
+private:
+    struct Ops {
+        void (*invoke)(void* storage);
+        void (*move)(void* dst, void* src) noexcept; // leaves src destroyed
+        void (*destroy)(void* storage) noexcept;
+    };
+
+    template <typename Fn>
+    static constexpr bool fits_inline() {
+        return sizeof(Fn) <= inline_capacity &&
+               alignof(Fn) <= alignof(std::max_align_t) &&
+               std::is_nothrow_move_constructible_v<Fn>;
+    }
+
+    // Over-aligned callables bypass the block pool, whose blocks are only
+    // aligned for std::max_align_t
+    template <typename Fn>
+    static void* allocate() {
+        if constexpr (alignof(Fn) > alignof(std::max_align_t)) {
+            return ::operator new(sizeof(Fn), std::align_val_t{alignof(Fn)});
+        } else {
+            return detail::allocate_task_block(sizeof(Fn));
+        }
+    }
+
+    template <typename Fn>
+    static void deallocate(void* block) noexcept {
+        if constexpr (alignof(Fn) > alignof(std::max_align_t)) {
+            ::operator delete(block, std::align_val_t{alignof(Fn)});
+        } else {
+            detail::deallocate_task_block(block, sizeof(Fn));
+        }
+    }
+
+    template <typename Fn>
+    static constexpr Ops inline_ops = {
+        [](void* s) { (*std::launder(static_cast<Fn*>(s)))(); },
+        [](void* dst, void* src) noexcept {
+            Fn* from = std::launder(static_cast<Fn*>(src));
+            ::new (dst) Fn(std::move(*from));
+            from->~Fn();
+        },
+        [](void* s) noexcept { std::launder(static_cast<Fn*>(s))->~Fn(); },
+    };
+
+    template <typename Fn>
+    static constexpr Ops pooled_ops = {
+        [](void* s) { (*static_cast<Fn*>(*static_cast<void**>(s)))(); },
+        [](void* dst, void* src) noexcept {
+            *static_cast<void**>(dst) = *static_cast<void**>(src);
+        },
+        [](void* s) noexcept {
+            void* block = *static_cast<void**>(s);
+            static_cast<Fn*>(block)->~Fn();
+            deallocate<Fn>(block);
+        },
+    };
+
+    alignas(std::max_align_t) unsigned char storage_[inline_capacity];
+    const Ops* ops_ = nullptr;
+};
+
+}
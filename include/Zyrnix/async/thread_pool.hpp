@@ -6,6 +6,8 @@
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
+#include <span>
+#include "task.hpp"
 
 namespace Zyrnix {
 
@@ -13,11 +15,27 @@ class ThreadPool {
 public:
     explicit ThreadPool(size_t threads);
     ~ThreadPool();
-    void enqueue(std::function<void()> task);
+    void enqueue(Task task);
+
+    /**
+     * @brief Enqueue a task, optionally running it with the caller's LogContext (v1.1.3)
+     *
+     * With @p capture_context the submitting thread's context snapshot is
+     * installed for the task's duration (a reference count, not a copy) and
+     * the worker's own context is restored afterwards.
+     */
+    void enqueue(Task task, bool capture_context);
+
+    /**
+     * @brief Enqueue several tasks under one lock acquisition (v1.1.3)
+     *
+     * The tasks are moved out of @p tasks; idle workers are woken once.
+     */
+    void enqueue_batch(std::span<Task> tasks);
 
 private:
     std::vector<std::thread> workers;
-    std::queue<std::function<void()>> tasks;
+    std::queue<Task> tasks;
     std::mutex mtx;
     std::condition_variable cv;
     std::atomic<bool> running;
@@ -0,0 +1,148 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <functional>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <span>
+#include "task.hpp"
+
+namespace Zyrnix {
+
+/**
+ * @brief Work-stealing thread pool (v1.1.3)
+ *
+ * Each worker owns a Chase-Lev deque: tasks submitted from a worker go to
+ * its own deque (push/pop without locks), tasks from other threads go to a
+ * global injection queue. Idle workers take from their deque, then from the
+ * injection queue (moving a batch over), then steal from other workers;
+ * only after a short spin do they park on a condition variable.
+ *
+ * Unlike ThreadPool there is no single queue lock shared by every enqueue
+ * and dequeue, so it keeps scaling with the number of cores. Used for
+ * background compression and MultiSink's parallel fan-out.
+ *
+ * Pending tasks are drained before the destructor returns.
+ */
+class WorkStealingThreadPool {
+public:
+    explicit WorkStealingThreadPool(size_t threads = 0); // 0 = hardware_concurrency
+    ~WorkStealingThreadPool();
+
+    WorkStealingThreadPool(const WorkStealingThreadPool&) = delete;
+    WorkStealingThreadPool& operator=(const WorkStealingThreadPool&) = delete;
+
+    void enqueue(Task task);
+
+    /**
+     * @brief Enqueue a task, optionally running it with the caller's LogContext
+     */
+    void enqueue(Task task, bool capture_context);
+
+    /**
+     * @brief Enqueue several tasks at once (v1.1.3)
+     *
+     * Takes the injection lock (or pushes to the worker's deque) once for
+     * the whole batch and wakes as many workers as needed. The tasks are
+     * moved out of @p tasks.
+     */
+    void enqueue_batch(std::span<Task> tasks);
+
+    /**
+     * @brief Run one pending task on the calling thread, if there is one
+     *
+     * Lets threads that wait for pool work help instead of blocking, which
+     * also keeps nested waits on worker threads from deadlocking.
+     */
+    bool try_run_one();
+
+    /**
+     * @brief Whether the calling thread is one of this pool's workers
+     */
+    bool is_worker_thread() const;
+
+    size_t thread_count() const { return workers_.size(); }
+
+    /**
+     * @brief Tasks enqueued but not yet started (approximate)
+     */
+    size_t pending() const;
+
+    /**
+     * @brief Process-wide pool shared by the library's background work
+     */
+    static WorkStealingThreadPool& instance();
+
+private:
+    struct Worker;
+
+    void worker_loop(size_t index);
+    static Task* make_node(Task&& task);
+    static void free_node(Task* node) noexcept;
+
+    Task* find_task(size_t index);
+    Task* take_injected(Worker* worker);
+    Task* steal(size_t thief);
+    void run(Task* task);
+    void wake(size_t count);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    std::mutex injection_mtx_;
+    std::deque<Task*> injection_;
+    std::atomic<size_t> injection_size_{0};
+
+    std::atomic<int64_t> pending_{0};
+    std::atomic<size_t> sleepers_{0};
+    std::mutex park_mtx_;
+    std::condition_variable park_cv_;
+    std::atomic<bool> stopping_{false};
+};
+
+/**
+ * @brief Fork-join helper over a WorkStealingThreadPool
+ *
+ * wait() returns once every task started through run() has finished.
+ * Other threads block on a condition variable, so a waiter never runs an
+ * unrelated pool task (which could need a lock the waiter holds, or be a
+ * long compression pass). Pool workers help by running pool tasks
+ * instead, which keeps nested fork-joins from starving the pool. The
+ * destructor waits as well, so tasks may safely reference locals of the
+ * enclosing scope.
+ *
+ * Example:
+ * @code
+ * TaskGroup group;
+ * for (auto& sink : sinks) group.run([&] { sink->log_record(record); });
+ * group.wait();
+ * @endcode
+ */
+class TaskGroup {
+public:
+    explicit TaskGroup(WorkStealingThreadPool& pool = WorkStealingThreadPool::instance())
+        : pool_(pool) {}
+    ~TaskGroup() { wait(); }
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    void run(Task task);
+    void wait();
+    bool done() const { return outstanding_.load(std::memory_order_acquire) == 0; }
+
+private:
+    void finish_one();
+
+    WorkStealingThreadPool& pool_;
+    std::atomic<size_t> outstanding_{0};
+    // The last finish_one() notifies under the lock, so a waiter that saw
+    // the count reach zero cannot destroy the group under a finishing task
+    std::mutex done_mtx_;
+    std::condition_variable done_cv_;
+};
+
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace Zyrnix {
+
+/**
+ * @brief Byte-level encoding helpers shared by the binary log formats (v1.1.3)
+ *
+ * All multi-byte integers are LEB128 varints; signed values are zigzag
+ * encoded first. Fixed-width values are little-endian. Buffers are plain
+ * std::string so they can be reused between records without reallocating.
+ */
+namespace binary {
+
+inline void put_u8(std::string& out, uint8_t v) {
+    out.push_back(static_cast<char>(v));
+}
+
+inline void put_varint(std::string& out, uint64_t v) {
+    char buf[10];
+    size_t n = 0;
+    while (v >= 0x80) {
+        buf[n++] = static_cast<char>((v & 0x7F) | 0x80);
+        v >>= 7;
+    }
+    buf[n++] = static_cast<char>(v);
+    out.append(buf, n);
+}
+
+inline uint64_t zigzag_encode(int64_t v) {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+inline int64_t zigzag_decode(uint64_t v) {
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+inline void put_svarint(std::string& out, int64_t v) {
+    put_varint(out, zigzag_encode(v));
+}
+
+inline void put_fixed64(std::string& out, uint64_t v) {
+    char buf[8];
+    for (int i = 0; i < 8; ++i) {
+        buf[i] = static_cast<char>((v >> (8 * i)) & 0xFF);
+    }
+    out.append(buf, 8);
+}
+
+inline void put_double(std::string& out, double v) {
+    uint64_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    put_fixed64(out, bits);
+}
+
+/**
+ * @brief Length-prefixed byte string
+ */
+inline void put_bytes(std::string& out, std::string_view v) {
+    put_varint(out, v.size());
+    out.append(v.data(), v.size());
+}
+
+}
+
+}
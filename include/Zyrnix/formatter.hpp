@@ -5,9 +5,21 @@
 
 namespace Zyrnix {
 
+struct LogRecord;
+
 class Formatter {
 public:
     std::string format(const std::string& logger_name, LogLevel level, const std::string& message);
+
+    /**
+     * @brief Append a formatted line (no newline) to @p out (v1.1.3)
+     *
+     * Same layout as format(), but stamped with the record's creation time
+     * and written into a caller-owned buffer, so batch writers build one
+     * buffer for many records. The date/time text is cached per thread and
+     * only re-rendered when the second changes.
+     */
+    void format_to(std::string& out, const LogRecord& record);
     static std::string redact(const std::string& message, const std::vector<std::string>& patterns);
 };
 
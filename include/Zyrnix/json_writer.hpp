@@ -0,0 +1,116 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <chrono>
+#include <ctime>
+#include <cstdint>
+#include "log_field.hpp"
+
+namespace Zyrnix {
+
+/**
+ * @brief Append a JSON-escaped copy of a string to an output buffer
+ *
+ * Runs of characters that need no escaping are appended in one call, so
+ * plain ASCII/UTF-8 text costs roughly a memcpy.
+ */
+void append_json_escaped(std::string& out, std::string_view str);
+
+/**
+ * @brief Return a JSON-escaped copy of a string
+ */
+std::string json_escape(std::string_view str);
+
+/**
+ * @brief Direct-append JSON line encoder over a reusable buffer (v1.1.3)
+ *
+ * Replaces the ostringstream-based encoding used by structured sinks. The
+ * buffer keeps its capacity between records, so steady-state encoding does
+ * not allocate. The "YYYY-MM-DDTHH:MM:SS" part of the timestamp is cached per
+ * second and only the milliseconds are rendered for each record.
+ *
+ * Not thread-safe: each sink owns one writer and uses it under its own lock.
+ *
+ * Example:
+ * @code
+ * JsonWriter w;
+ * w.begin_object();
+ * w.key_escaped("level");
+ * w.value_string("INFO");
+ * w.end_object();
+ * file.write(w.data(), w.size());
+ * @endcode
+ */
+class JsonWriter {
+public:
+    JsonWriter();
+
+    void clear() { buffer_.clear(); needs_comma_ = false; }
+
+    void begin_object();
+    void end_object();
+
+    /**
+     * @brief Write an object key that is already JSON-escaped
+     *
+     * Use for static keys ("timestamp", "level", ...) and keys that were
+     * escaped once up front.
+     */
+    void key_escaped(std::string_view key);
+
+    /**
+     * @brief Write an object key, escaping it
+     */
+    void key(std::string_view key);
+
+    void value_string(std::string_view value);
+
+    /**
+     * @brief Write a string value that is already JSON-escaped
+     */
+    void value_string_escaped(std::string_view value);
+
+    void value_int(int64_t value);
+    void value_uint(uint64_t value);
+
+    /**
+     * @brief Write a double; NaN and infinities are written as null
+     */
+    void value_double(double value);
+    void value_bool(bool value);
+    void value_null();
+
+    /**
+     * @brief Write a typed field value as the matching JSON type
+     */
+    void value(const FieldValue& value);
+
+    /**
+     * @brief Write an ISO-8601 UTC timestamp with millisecond precision
+     */
+    void value_timestamp(std::chrono::system_clock::time_point tp);
+
+    /**
+     * @brief Append pre-rendered JSON (e.g. a cached `,"k":"v"` fragment)
+     *
+     * The fragment must start with a comma if it follows another member.
+     */
+    void append_raw(std::string_view json);
+
+    void newline() { buffer_.push_back('\n'); }
+
+    const char* data() const { return buffer_.data(); }
+    size_t size() const { return buffer_.size(); }
+    const std::string& str() const { return buffer_; }
+
+private:
+    void separator();
+
+    std::string buffer_;
+    bool needs_comma_ = false;
+
+    std::time_t cached_second_ = -1;
+    char cached_prefix_[20];
+};
+
+}
@@ -1,14 +1,80 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <memory>
 #include <mutex>
 #include <vector>
+#include <utility>
+#include "string_intern.hpp"
 
 namespace Zyrnix {
 
 class Logger;
 
+/**
+ * @brief Immutable view of a thread's context at one point in time (v1.1.3)
+ *
+ * Context entries are kept in a small flat array (insertion order, interned
+ * keys) shared by reference count. Taking a snapshot copies one pointer;
+ * LogContext copies the array only when the thread modifies its context
+ * while a snapshot is still alive (copy-on-write).
+ *
+ * Snapshots are safe to read from any thread, e.g. from a sink worker.
+ */
+class ContextSnapshot {
+public:
+    using Entry = std::pair<InternedString, std::string>;
+    using Entries = std::vector<Entry>;
+
+    ContextSnapshot() = default;
+
+    /**
+     * @brief Snapshot of explicit entries, e.g. a copy with values rewritten
+     */
+    explicit ContextSnapshot(Entries entries)
+        : entries_(std::make_shared<const Entries>(std::move(entries))) {}
+
+    bool empty() const { return !entries_ || entries_->empty(); }
+    size_t size() const { return entries_ ? entries_->size() : 0; }
+
+    /**
+     * @brief Direct lookup without copying
+     * @return Pointer to the value, or nullptr if the key is not set
+     */
+    const std::string* find(const InternedString& key) const;
+    const std::string* find(std::string_view key) const;
+    const std::string* find(const std::string& key) const { return find(std::string_view(key)); }
+    const std::string* find(const char* key) const { return find(std::string_view(key)); }
+
+    bool contains(std::string_view key) const { return find(key) != nullptr; }
+
+    /**
+     * @brief Value for a key, or an empty string if it is not set
+     */
+    std::string get(std::string_view key) const;
+
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        if (!entries_) return;
+        for (const auto& [key, value] : *entries_) {
+            fn(key, value);
+        }
+    }
+
+    Entries::const_iterator begin() const { return entries_ ? entries_->begin() : empty_entries().begin(); }
+    Entries::const_iterator end() const { return entries_ ? entries_->end() : empty_entries().end(); }
+
+    std::unordered_map<std::string, std::string> to_map() const;
+
+private:
+    friend class LogContext;
+    explicit ContextSnapshot(std::shared_ptr<const Entries> entries) : entries_(std::move(entries)) {}
+    static const Entries& empty_entries();
+
+    std::shared_ptr<const Entries> entries_;
+};
+
 class LogContext {
 public:
     using ContextMap = std::unordered_map<std::string, std::string>;
@@ -17,11 +83,88 @@ public:
     static std::string get(const std::string& key);
     static void remove(const std::string& key);
     static void clear();
+
+    /**
+     * @brief Copy of the calling thread's context
+     *
+     * Allocates a map; prefer find(), for_each() or snapshot() on hot paths.
+     */
     static ContextMap get_all();
     static bool contains(const std::string& key);
 
+    /**
+     * @brief Direct lookup in the calling thread's context (v1.1.3)
+     * @return Pointer to the value (valid until the context is next modified),
+     *         or nullptr if the key is not set
+     */
+    static const std::string* find(const InternedString& key);
+    static const std::string* find(std::string_view key);
+    static const std::string* find(const std::string& key) { return find(std::string_view(key)); }
+    static const std::string* find(const char* key) { return find(std::string_view(key)); }
+
+    /**
+     * @brief O(1) capture of the calling thread's context (v1.1.3)
+     */
+    static ContextSnapshot snapshot();
+
+    /**
+     * @brief Make a snapshot the calling thread's context (v1.1.3)
+     *
+     * O(1): the thread shares the snapshot's entries and copies them only
+     * when it modifies its context. Used to carry context across threads;
+     * see ContextScope and ThreadPool::enqueue.
+     */
+    static void restore(const ContextSnapshot& snapshot);
+
+    /**
+     * @brief Visit every context entry of the calling thread without copying
+     * @param fn Callable invoked as fn(const InternedString& key, const std::string& value);
+     *           InternedString also binds to a const std::string& parameter
+     */
+    template <typename Fn>
+    static void for_each(Fn&& fn) {
+        if (!entries_) return;
+        for (const auto& [key, value] : *entries_) {
+            fn(key, value);
+        }
+    }
+
+private:
+    // Returns the thread's entries ready for modification, copying them
+    // first if a snapshot still shares them
+    static ContextSnapshot::Entries& mutable_entries();
+
+    static thread_local std::shared_ptr<ContextSnapshot::Entries> entries_;
+};
+
+/**
+ * @brief Installs a context snapshot for the lifetime of the scope (v1.1.3)
+ *
+ * The thread's previous context is put back on destruction, so a worker
+ * thread does not keep a finished task's context.
+ *
+ * Example:
+ * @code
+ * auto ctx = LogContext::snapshot();
+ * std::thread worker([ctx] {
+ *     ContextScope scope(ctx);
+ *     logger->info("runs with the submitter's request_id");
+ * });
+ * @endcode
+ */
+class ContextScope {
+public:
+    explicit ContextScope(const ContextSnapshot& snapshot)
+        : previous_(LogContext::snapshot()) {
+        LogContext::restore(snapshot);
+    }
+    ~ContextScope() { LogContext::restore(previous_); }
+
+    ContextScope(const ContextScope&) = delete;
+    ContextScope& operator=(const ContextScope&) = delete;
+
 private:
-    static thread_local ContextMap context_;
+    ContextSnapshot previous_;
 };
 
 class ScopedContext {
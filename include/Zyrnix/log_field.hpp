@@ -0,0 +1,164 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include <span>
+#include "string_intern.hpp"
+
+namespace Zyrnix {
+
+/**
+ * @brief Typed structured field value (v1.1.3)
+ *
+ * Small tagged value that keeps numbers and booleans as native types all the
+ * way to the encoder, so JSON output gets real numbers instead of quoted
+ * strings and callers no longer need std::to_string.
+ *
+ * String values are non-owning views; a FieldValue is meant to live for the
+ * duration of a log call. Use FieldSet when a record has to keep its fields.
+ */
+class FieldValue {
+public:
+    enum class Type : uint8_t {
+        Null,
+        Int,
+        UInt,
+        Double,
+        Bool,
+        String
+    };
+
+    FieldValue() : type_(Type::Null), int_(0) {}
+
+    FieldValue(bool v) : type_(Type::Bool), bool_(v) {}
+
+    template <typename T,
+              std::enable_if_t<std::is_integral_v<T> && std::is_signed_v<T> &&
+                               !std::is_same_v<T, bool> && !std::is_same_v<T, char>, int> = 0>
+    FieldValue(T v) : type_(Type::Int), int_(static_cast<int64_t>(v)) {}
+
+    template <typename T,
+              std::enable_if_t<std::is_integral_v<T> && std::is_unsigned_v<T> &&
+                               !std::is_same_v<T, bool>, int> = 0>
+    FieldValue(T v) : type_(Type::UInt), uint_(static_cast<uint64_t>(v)) {}
+
+    FieldValue(double v) : type_(Type::Double), double_(v) {}
+    FieldValue(float v) : type_(Type::Double), double_(static_cast<double>(v)) {}
+
+    FieldValue(std::string_view v) : type_(Type::String), str_(v) {}
+    FieldValue(const char* v) : type_(Type::String), str_(v ? std::string_view(v) : std::string_view()) {}
+    FieldValue(const std::string& v) : type_(Type::String), str_(v) {}
+
+    Type type() const { return type_; }
+    bool is_null() const { return type_ == Type::Null; }
+
+    int64_t as_int() const { return int_; }
+    uint64_t as_uint() const { return uint_; }
+    double as_double() const { return double_; }
+    bool as_bool() const { return bool_; }
+    std::string_view as_string() const { return type_ == Type::String ? str_ : std::string_view(); }
+
+    /**
+     * @brief Append the plain-text rendering (no quoting) to a buffer
+     */
+    void append_text(std::string& out) const;
+
+    /**
+     * @brief Plain-text rendering, e.g. for filters comparing against strings
+     */
+    std::string to_string() const;
+
+private:
+    Type type_;
+    union {
+        int64_t int_;
+        uint64_t uint_;
+        double double_;
+        bool bool_;
+        std::string_view str_;
+    };
+};
+
+/**
+ * @brief Key/value pair passed at the call site
+ *
+ * Example:
+ * @code
+ * slog->info("Request served", {{"status", 200}, {"latency_ms", 12.5}, {"cached", true}});
+ * @endcode
+ */
+struct Field {
+    std::string_view key;
+    FieldValue value;
+};
+
+using FieldSpan = std::span<const Field>;
+
+/**
+ * @brief Owning field storage for records that outlive the log call
+ *
+ * Keeps insertion order and value types. Keys are interned and string values
+ * are packed into one buffer, so a reused FieldSet (e.g. a thread's record)
+ * stops allocating once it has grown to the usual record size. span() views
+ * the stored fields as the Field array sinks receive at the call site.
+ */
+class FieldSet {
+public:
+    FieldSet() = default;
+    FieldSet(const FieldSet& other);
+    FieldSet(FieldSet&& other) noexcept;
+    FieldSet& operator=(const FieldSet& other);
+    FieldSet& operator=(FieldSet&& other) noexcept;
+
+    void set(std::string_view key, const FieldValue& value);
+    void assign(FieldSpan fields);
+
+    FieldValue get(std::string_view key) const;
+    bool contains(std::string_view key) const;
+
+    bool empty() const { return fields_.empty(); }
+    size_t size() const { return fields_.size(); }
+    void clear() { keys_.clear(); offsets_.clear(); fields_.clear(); arena_.clear(); }
+
+    /**
+     * @brief The stored fields; string values point into this set
+     *
+     * Valid until the set is next modified.
+     */
+    FieldSpan span() const { return FieldSpan(fields_.data(), fields_.size()); }
+
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (const auto& field : fields_) {
+            fn(field.key, field.value);
+        }
+    }
+
+    /**
+     * @brief Like for_each, but passes the interned key (with its escaped form)
+     * @param fn Callable invoked as fn(const InternedString& key, FieldValue value)
+     */
+    template <typename Fn>
+    void for_each_interned(Fn&& fn) const {
+        for (size_t i = 0; i < fields_.size(); ++i) {
+            fn(keys_[i], fields_[i].value);
+        }
+    }
+
+private:
+    static constexpr uint32_t NO_TEXT = UINT32_MAX;
+
+    long index_of(std::string_view key) const;
+    void append_value(size_t index, const FieldValue& value);
+    // Re-point string values at arena_ after it moved or reallocated
+    void rebind_strings();
+
+    std::vector<InternedString> keys_;
+    std::vector<uint32_t> offsets_; // Offset of a string value in arena_, or NO_TEXT
+    std::vector<Field> fields_; // Keys view interned storage, strings view arena_
+    std::string arena_;
+};
+
+}
@@ -1,13 +1,18 @@
 #pragma once
 #include <string>
+#include <chrono>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <regex>
 #include <atomic>
 #include <unordered_map>
 #include <mutex>
+#include <vector>
 #include "log_level.hpp"
 #include "log_record.hpp"
+#include "sharded_counter.hpp"
+#include "string_intern.hpp"
 
 namespace Zyrnix {
 
@@ -15,6 +20,41 @@ class LogFilter {
 public:
     virtual ~LogFilter() = default;
     virtual bool should_log(const LogRecord& record) const = 0;
+
+    /**
+     * @brief Stateful second step of the decision (v1.1.3)
+     *
+     * Logger calls this only once should_log() of every filter accepted the
+     * record, so a filter that remembers what it let through (DedupFilter)
+     * never counts a record another filter rejects. should_log() must then
+     * be free of side effects. The default accepts.
+     */
+    virtual bool commit(const LogRecord& record) const {
+        (void)record;
+        return true;
+    }
+
+    /**
+     * @brief Hand over records the filter wants logged itself (v1.1.3)
+     *
+     * Logger calls this for every record that passed all its filters and
+     * logs whatever was appended ahead of that record. DedupFilter uses it
+     * for its "repeated N times" summaries; the default adds nothing.
+     */
+    virtual void take_pending_records(const LogRecord& passed, std::vector<LogRecord>& out) const {
+        (void)passed;
+        (void)out;
+    }
+
+    /**
+     * @brief Hand over everything the filter still holds back (v1.1.3)
+     *
+     * Called by Logger::flush() and on destruction, when no further record
+     * will come by to collect it.
+     */
+    virtual void flush_pending_records(std::vector<LogRecord>& out) const {
+        (void)out;
+    }
 };
 
 class LevelFilter : public LogFilter {
@@ -33,6 +73,7 @@ public:
 
 private:
     std::string field_name_;
+    InternedString field_key_; // Context lookups compare interned pointers
     std::string expected_value_;
 };
 
@@ -53,6 +94,9 @@ public:
     CompositeFilter(Mode mode);
     void add_filter(std::shared_ptr<LogFilter> filter);
     bool should_log(const LogRecord& record) const override;
+    bool commit(const LogRecord& record) const override;
+    void take_pending_records(const LogRecord& passed, std::vector<LogRecord>& out) const override;
+    void flush_pending_records(std::vector<LogRecord>& out) const override;
 
 private:
     Mode mode_;
@@ -60,6 +104,75 @@ private:
 };
 
 
+struct DedupFilterOptions {
+    std::chrono::milliseconds window{1000}; // Repeats within a window are collapsed
+    size_t table_size = 1024;               // Messages tracked at once; rounded up to a power of two
+};
+
+/**
+ * @brief Collapses repeats of the same message into one summary (v1.1.3)
+ *
+ * Records are keyed by logger, level and message text. The first record
+ * of a key passes and opens a window; identical records inside it are
+ * dropped and counted. The first one after the window passes again,
+ * preceded by "<message> (repeated N times)" with a `repeated` field.
+ * Counts of keys that went quiet are flushed, about once per window, by
+ * the next record that passes, and all remaining counts by Logger::flush().
+ *
+ * The decision is taken in commit(), so only records every other filter
+ * accepted open windows or count as repeats.
+ *
+ * Keys live in a fixed-size open-addressed table of atomics, so a repeat
+ * (the hot path in a storm) costs a hash, a short probe and one
+ * fetch_add, and windows use the record's own timestamp instead of
+ * reading the clock. When a probe run is full, a key whose window has
+ * ended is evicted and its count reported; if none has, the record
+ * passes untracked. Summaries are logged by whichever logger collects
+ * them, so give each logger its own DedupFilter.
+ */
+class DedupFilter : public LogFilter {
+public:
+    explicit DedupFilter(const DedupFilterOptions& options = DedupFilterOptions{});
+
+    // Accepts everything; repeats are dropped in commit(), after the other filters
+    bool should_log(const LogRecord& record) const override;
+    bool commit(const LogRecord& record) const override;
+    void take_pending_records(const LogRecord& passed, std::vector<LogRecord>& out) const override;
+    // Reports every counted repeat, also of windows still open
+    void flush_pending_records(std::vector<LogRecord>& out) const override;
+
+    uint64_t suppressed() const { return suppressed_.load(0); }
+    const DedupFilterOptions& options() const { return options_; }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> key{0};          // 0 while empty
+        std::atomic<int64_t> window_end{0};    // ns since the system clock epoch
+        std::atomic<uint64_t> repeats{0};
+        std::atomic_flag busy = ATOMIC_FLAG_INIT; // Guards level and message
+        LogLevel level = LogLevel::Info;
+        std::string message;
+    };
+
+    static constexpr size_t PROBES = 8;
+
+    void claim(Slot& slot, const LogRecord& record, int64_t now) const;
+    // Queues a summary of @p repeats for the key currently in @p slot
+    void report(Slot& slot, uint64_t repeats, const LogRecord& current) const;
+    void sweep(int64_t now, const LogRecord& current) const;
+    void move_pending(std::vector<LogRecord>& out) const;
+
+    DedupFilterOptions options_;
+    int64_t window_ns_;
+    size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    mutable ShardedCounters<1> suppressed_;
+    mutable std::atomic<int64_t> next_sweep_ns_{0};
+    mutable std::atomic<bool> has_pending_{false};
+    mutable std::mutex pending_mtx_;
+    mutable std::vector<LogRecord> pending_; // guarded by pending_mtx_
+};
+
 struct FilterStats {
     uint64_t matches{0};
     uint64_t misses{0};
@@ -98,6 +211,7 @@ private:
     std::string pattern_str_;
     std::regex regex_;
     std::string field_name_;  
+    InternedString field_key_;
     bool invert_;
     bool case_insensitive_;
     bool track_stats_;
@@ -32,12 +32,14 @@ struct HealthCheckResult {
     uint64_t messages_filtered;
     uint64_t errors;
     double messages_per_second;
+    double recent_messages_per_second; // Over HealthCheckConfig::rate_window (v1.1.3)
     double avg_latency_us;
     uint64_t max_latency_us;
     size_t queue_depth;
     size_t max_queue_depth;
     
 
+    // Over HealthCheckConfig::rate_window, so they recover after an incident
     double drop_rate;         
     double error_rate;         
     bool queue_full_warning;   
@@ -54,6 +56,20 @@ struct HealthCheckResult {
 };
 
 
+/**
+ * @brief Window the health drop and error rates are computed over (v1.1.3)
+ *
+ * The moving-average windows of LogMetrics' rate meters. Lifetime ratios
+ * hide a burst of drops behind hours of healthy traffic and stay high
+ * long after an incident; the windows track what is happening now.
+ */
+enum class RateWindow {
+    OneSecond,
+    TenSeconds,
+    OneMinute,
+    Lifetime
+};
+
 struct HealthCheckConfig {
    
     double max_drop_rate_healthy = 0.01; // 1% drop rate = healthy
@@ -64,6 +80,7 @@ struct HealthCheckConfig {
     uint64_t max_latency_us_degraded = 50000; // 50ms = degraded
     double max_queue_usage_healthy = 0.7; // 70% queue usage = healthy
     double max_queue_usage_degraded = 0.9;  // 90% queue usage = degraded
+    RateWindow rate_window = RateWindow::TenSeconds;
 };
 
 struct AggregateHealthResult {
@@ -148,6 +165,11 @@ public:
     
 
     void unregister_logger(const std::string& name);
+
+    /**
+     * @brief Registered logger by name, or nullptr if unknown or expired (v1.1.3)
+     */
+    std::shared_ptr<Logger> find_logger(const std::string& name) const;
     
 
     HealthCheckResult check_logger(const std::string& name) const;
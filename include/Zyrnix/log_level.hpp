@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <string_view>
 
 namespace Zyrnix {
 
@@ -24,4 +25,16 @@ inline std::string to_string(LogLevel lvl) {
     }
 }
 
+inline std::string_view to_string_view(LogLevel lvl) {
+    switch (lvl) {
+        case LogLevel::Trace: return "TRACE";
+        case LogLevel::Debug: return "DEBUG";
+        case LogLevel::Info: return "INFO";
+        case LogLevel::Warn: return "WARN";
+        case LogLevel::Error: return "ERROR";
+        case LogLevel::Critical: return "CRITICAL";
+        default: return "UNKNOWN";
+    }
+}
+
 }
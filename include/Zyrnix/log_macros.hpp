@@ -16,7 +16,7 @@
 #define XLOG_LOG_IF(logger, level, condition, message) \
     do { \
         if (XLOG_LEVEL_ENABLED(logger, level) && (condition)) { \
-            (logger)->log(level, message); \
+            (logger)->log_at(__FILE__, __LINE__, level, message); \
         } \
     } while(0)
 
@@ -39,37 +39,37 @@
     XLOG_LOG_IF(logger, ::Zyrnix::LogLevel::Critical, condition, message)
 
 #if XLOG_ACTIVE_LEVEL <= 0
-    #define XLOG_TRACE(logger, message) (logger)->log(::Zyrnix::LogLevel::Trace, message)
+    #define XLOG_TRACE(logger, message) (logger)->log_at(__FILE__, __LINE__, ::Zyrnix::LogLevel::Trace, message)
 #else
     #define XLOG_TRACE(logger, message) ((void)0)
 #endif
 
 #if XLOG_ACTIVE_LEVEL <= 1
-    #define XLOG_DEBUG(logger, message) (logger)->log(::Zyrnix::LogLevel::Debug, message)
+    #define XLOG_DEBUG(logger, message) (logger)->log_at(__FILE__, __LINE__, ::Zyrnix::LogLevel::Debug, message)
 #else
     #define XLOG_DEBUG(logger, message) ((void)0)
 #endif
 
 #if XLOG_ACTIVE_LEVEL <= 2
-    #define XLOG_INFO(logger, message) (logger)->log(::Zyrnix::LogLevel::Info, message)
+    #define XLOG_INFO(logger, message) (logger)->log_at(__FILE__, __LINE__, ::Zyrnix::LogLevel::Info, message)
 #else
     #define XLOG_INFO(logger, message) ((void)0)
 #endif
 
 #if XLOG_ACTIVE_LEVEL <= 3
-    #define XLOG_WARN(logger, message) (logger)->log(::Zyrnix::LogLevel::Warn, message)
+    #define XLOG_WARN(logger, message) (logger)->log_at(__FILE__, __LINE__, ::Zyrnix::LogLevel::Warn, message)
 #else
     #define XLOG_WARN(logger, message) ((void)0)
 #endif
 
 #if XLOG_ACTIVE_LEVEL <= 4
-    #define XLOG_ERROR(logger, message) (logger)->log(::Zyrnix::LogLevel::Error, message)
+    #define XLOG_ERROR(logger, message) (logger)->log_at(__FILE__, __LINE__, ::Zyrnix::LogLevel::Error, message)
 #else
     #define XLOG_ERROR(logger, message) ((void)0)
 #endif
 
 #if XLOG_ACTIVE_LEVEL <= 5
-    #define XLOG_CRITICAL(logger, message) (logger)->log(::Zyrnix::LogLevel::Critical, message)
+    #define XLOG_CRITICAL(logger, message) (logger)->log_at(__FILE__, __LINE__, ::Zyrnix::LogLevel::Critical, message)
 #else
     #define XLOG_CRITICAL(logger, message) ((void)0)
 #endif
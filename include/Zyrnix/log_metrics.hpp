@@ -1,5 +1,6 @@
 #pragma once
 #include "Zyrnix_features.hpp"
+#include "sharded_counter.hpp"
 #include <string>
 #include <functional>
 #include <map>
@@ -8,24 +9,152 @@
 #include <mutex>
 #include <chrono>
 #include <memory>
+#include <iosfwd>
 
 namespace Zyrnix {
 
+/**
+ * @brief Lock-free log-linear histogram (v1.1.3)
+ *
+ * HdrHistogram-style buckets: values below 32 are counted exactly, and
+ * every power of two above that is split into 16 linear sub-buckets, so a
+ * reported value is within ~6% of the recorded one. Values up to 2^36
+ * (about 69 seconds in nanoseconds) are resolved; larger ones share the
+ * top bucket. A shard is 528 counters (~4KB).
+ *
+ * record() only touches the calling thread's shard (allocated on first
+ * use), so concurrent loggers do not contend on one cache line. Readers
+ * merge all shards; a read racing with writers may miss in-flight samples.
+ *
+ * Counts at a given value are at bucket resolution: count_at_or_below()
+ * and the Prometheus `le` buckets include the whole bucket containing the
+ * bound, i.e. values up to ~6% above it.
+ */
+class Histogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 4;
+    static constexpr unsigned MAX_VALUE_BITS = 36;
+    static constexpr size_t SUB_BUCKETS = size_t{1} << SUB_BUCKET_BITS;
+    static constexpr size_t BUCKETS = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+    static constexpr size_t SHARDS = 8;
+
+    /**
+     * @brief Merged view of all shards
+     */
+    struct Snapshot {
+        std::vector<uint64_t> buckets;
+        uint64_t count = 0;
+        uint64_t sum = 0;
+        uint64_t max = 0;
+
+        double mean() const;
+        uint64_t percentile(double p) const;               // p in [0, 100]
+        uint64_t count_at_or_below(uint64_t value) const;  // Includes value's whole bucket
+    };
+
+    Histogram() = default;
+    ~Histogram();
+    Histogram(const Histogram&) = delete;
+    Histogram& operator=(const Histogram&) = delete;
+
+    void record(uint64_t value);
+
+    Snapshot snapshot() const;
+    void snapshot(Snapshot& out) const; // Reuses out.buckets' storage
+    uint64_t count() const;
+    uint64_t sum() const;
+    uint64_t max() const;
+    double mean() const;
+    uint64_t percentile(double p) const { return snapshot().percentile(p); }
+
+    void reset();
+
+    static size_t bucket_index(uint64_t value);
+    static uint64_t bucket_upper_bound(size_t bucket); // Inclusive
+
+    /**
+     * @brief Write a Prometheus histogram (cumulative buckets, _sum, _count)
+     * @param bounds Bucket boundaries in recorded units, ascending
+     * @param scale Factor applied to boundaries and _sum (e.g. 1e-9 for ns -> seconds)
+     */
+    void export_prometheus(std::ostream& out, const std::string& name, const std::string& help,
+                           const std::vector<uint64_t>& bounds, double scale = 1.0) const;
+    void export_json(std::ostream& out) const;
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> buckets[BUCKETS];
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> sum{0};
+        std::atomic<uint64_t> max{0};
+    };
+
+    Shard& local_shard();
+
+    std::atomic<Shard*> shards_[SHARDS] = {};
+};
+
+/**
+ * @brief Exponentially weighted 1s/10s/60s rates of a growing total (v1.1.3)
+ *
+ * Costs nothing on the hot path: the meter samples the total it tracks
+ * when read (at most every 100ms) and folds the average rate since the
+ * previous sample into each moving average, so idle gaps decay the rates
+ * correctly. Concurrent readers never block: one updates while the others
+ * return the current values. Rates are as fresh as the reads (scrapes,
+ * health checks) that drive them.
+ */
+class RateMeter {
+public:
+    struct Rates {
+        double one_second = 0.0;
+        double ten_seconds = 0.0;
+        double one_minute = 0.0;
+    };
+
+    RateMeter();
+    RateMeter(const RateMeter&) = delete;
+    RateMeter& operator=(const RateMeter&) = delete;
+
+    /**
+     * @brief Update from the current @p total and return the rates (per second)
+     */
+    Rates sample(uint64_t total);
+    Rates rates() const;
+    void reset(uint64_t total = 0);
+
+private:
+    static constexpr size_t WINDOWS = 3;
+
+    std::atomic_flag updating_ = ATOMIC_FLAG_INIT;
+    // Guarded by updating_
+    uint64_t last_total_ = 0;
+    std::chrono::steady_clock::time_point last_time_;
+    bool seeded_ = false;
+    std::atomic<double> rates_[WINDOWS];
+};
+
 class LogMetrics {
 public:
-    struct Counters {
-        std::atomic<uint64_t> messages_logged{0};
-        std::atomic<uint64_t> messages_dropped{0};
-        std::atomic<uint64_t> messages_filtered{0};
-        std::atomic<uint64_t> flushes{0};
-        std::atomic<uint64_t> errors{0};
+    // Hot-path counters, sharded per thread and summed on read (v1.1.3)
+    enum Counter : size_t {
+        MESSAGES_LOGGED,
+        MESSAGES_DROPPED,
+        MESSAGES_FILTERED,
+        FLUSHES,
+        ERRORS,
+        MESSAGES_LEVEL_REJECTED,
+        MESSAGES_RATE_LIMITED,
+        SINK_ERRORS,
+        LOG_TIME_NS,   // Total time spent logging
+        FLUSH_TIME_NS, // Total time spent flushing
+        COUNTER_COUNT
     };
+    using Counters = ShardedCounters<COUNTER_COUNT>;
 
     struct Timings {
-        std::atomic<uint64_t> total_log_time_us{0};  // Total time spent logging (microseconds)
-        std::atomic<uint64_t> total_flush_time_us{0}; // Total time spent flushing
-        std::atomic<uint64_t> max_log_latency_us{0};  // Max single log call latency
-        std::atomic<uint64_t> max_flush_latency_us{0}; // Max single flush latency
+        std::atomic<uint64_t> max_log_latency_ns{0};  // Max single log call latency
+        std::atomic<uint64_t> max_flush_latency_ns{0}; // Max single flush latency
     };
 
     struct QueueMetrics {
@@ -40,23 +169,60 @@ public:
     void record_message_logged();
     void record_message_dropped();
     void record_message_filtered();
+    void record_message_level_rejected();
+    void record_message_rate_limited();
+    void record_sink_error();
     void record_flush();
     void record_error();
     void record_log_duration(uint64_t microseconds);
     void record_flush_duration(uint64_t microseconds);
     void update_queue_depth(size_t depth);
 
-    uint64_t get_messages_logged() const { return counters_.messages_logged.load(std::memory_order_relaxed); }
-    uint64_t get_messages_dropped() const { return counters_.messages_dropped.load(std::memory_order_relaxed); }
-    uint64_t get_messages_filtered() const { return counters_.messages_filtered.load(std::memory_order_relaxed); }
-    uint64_t get_flushes() const { return counters_.flushes.load(std::memory_order_relaxed); }
-    uint64_t get_errors() const { return counters_.errors.load(std::memory_order_relaxed); }
+    /**
+     * @brief Nanosecond latencies, also feeding the latency histograms (v1.1.3)
+     */
+    void record_log_latency_ns(uint64_t nanoseconds);
+    void record_flush_latency_ns(uint64_t nanoseconds);
+
+    /**
+     * @brief Async backend statistics (v1.1.3)
+     *
+     * Records per batch handed to a sink, and the time each record spent
+     * between being queued and its batch being written.
+     */
+    void record_batch_size(size_t records);
+    void record_enqueue_to_write_ns(uint64_t nanoseconds);
+
+    const Histogram& log_latency_histogram() const { return log_latency_ns_; }
+    const Histogram& flush_latency_histogram() const { return flush_latency_ns_; }
+    const Histogram& enqueue_to_write_histogram() const { return enqueue_to_write_ns_; }
+    const Histogram& batch_size_histogram() const { return batch_sizes_; }
+
+    uint64_t get_messages_logged() const { return counters_.load(MESSAGES_LOGGED); }
+    uint64_t get_messages_dropped() const { return counters_.load(MESSAGES_DROPPED); }
+    uint64_t get_messages_filtered() const { return counters_.load(MESSAGES_FILTERED); }
+    uint64_t get_messages_level_rejected() const { return counters_.load(MESSAGES_LEVEL_REJECTED); }
+    uint64_t get_messages_rate_limited() const { return counters_.load(MESSAGES_RATE_LIMITED); }
+    uint64_t get_sink_errors() const { return counters_.load(SINK_ERRORS); }
+    uint64_t get_flushes() const { return counters_.load(FLUSHES); }
+    uint64_t get_errors() const { return counters_.load(ERRORS); }
     
     double get_messages_per_second() const;
     double get_average_log_latency_us() const;
     double get_average_flush_latency_us() const;
-    uint64_t get_max_log_latency_us() const { return timings_.max_log_latency_us.load(std::memory_order_relaxed); }
-    uint64_t get_max_flush_latency_us() const { return timings_.max_flush_latency_us.load(std::memory_order_relaxed); }
+    uint64_t get_max_log_latency_us() const { return timings_.max_log_latency_ns.load(std::memory_order_relaxed) / 1000; }
+    uint64_t get_max_flush_latency_us() const { return timings_.max_flush_latency_ns.load(std::memory_order_relaxed) / 1000; }
+    uint64_t get_log_latency_percentile_ns(double p) const { return log_latency_ns_.percentile(p); }
+
+    /**
+     * @brief Recent rates per second (v1.1.3)
+     *
+     * Unlike get_messages_per_second(), which averages over the whole
+     * lifetime, these follow bursts. Errors include sink errors.
+     */
+    RateMeter::Rates get_logged_rates() const { return logged_rate_.sample(get_messages_logged()); }
+    RateMeter::Rates get_dropped_rates() const { return dropped_rate_.sample(get_messages_dropped()); }
+    RateMeter::Rates get_error_rates() const { return error_rate_.sample(get_errors() + get_sink_errors()); }
     
     size_t get_current_queue_depth() const { return queue_metrics_.current_depth.load(std::memory_order_relaxed); }
     size_t get_max_queue_depth() const { return queue_metrics_.max_depth.load(std::memory_order_relaxed); }
@@ -67,13 +233,22 @@ public:
         uint64_t messages_logged;
         uint64_t messages_dropped;
         uint64_t messages_filtered;
+        uint64_t messages_level_rejected;
+        uint64_t messages_rate_limited;
+        uint64_t sink_errors;
         uint64_t flushes;
         uint64_t errors;
         double messages_per_second;
+        RateMeter::Rates logged_rates;
+        RateMeter::Rates dropped_rates;
+        RateMeter::Rates error_rates;
         double avg_log_latency_us;
         double avg_flush_latency_us;
         uint64_t max_log_latency_us;
         uint64_t max_flush_latency_us;
+        uint64_t log_latency_p50_ns;
+        uint64_t log_latency_p99_ns;
+        uint64_t log_latency_p999_ns;
         size_t current_queue_depth;
         size_t max_queue_depth;
         std::chrono::steady_clock::time_point timestamp;
@@ -82,6 +257,14 @@ public:
     Snapshot get_snapshot() const;
 
     std::string export_prometheus(const std::string& prefix = "Zyrnix") const;
+    /**
+     * @brief Append the exposition text to @p out (v1.1.3)
+     *
+     * Metric names and help text are rendered once per prefix and cached;
+     * a call only formats the values, so reusing @p out across scrapes
+     * avoids reallocating.
+     */
+    void export_prometheus(std::string& out, const std::string& prefix) const;
 
     std::string export_json() const;
 
@@ -89,6 +272,13 @@ private:
     Counters counters_;
     Timings timings_;
     QueueMetrics queue_metrics_;
+    Histogram log_latency_ns_;
+    Histogram flush_latency_ns_;
+    Histogram enqueue_to_write_ns_;
+    Histogram batch_sizes_;
+    mutable RateMeter logged_rate_;
+    mutable RateMeter dropped_rate_;
+    mutable RateMeter error_rate_;
     std::chrono::steady_clock::time_point start_time_;
     mutable std::mutex mutex_;
 };
@@ -102,22 +292,36 @@ public:
     void record_error();
     void record_write_duration(uint64_t microseconds);
 
+    /**
+     * @brief Queue statistics for sinks behind a SinkWorker (v1.1.3)
+     */
+    void record_drop();
+    void update_queue_depth(size_t depth);
+
     std::string get_name() const { return name_; }
-    uint64_t get_writes() const { return writes_.load(std::memory_order_relaxed); }
-    uint64_t get_bytes_written() const { return bytes_written_.load(std::memory_order_relaxed); }
-    uint64_t get_flushes() const { return flushes_.load(std::memory_order_relaxed); }
-    uint64_t get_errors() const { return errors_.load(std::memory_order_relaxed); }
+    uint64_t get_writes() const { return counters_.load(WRITES); }
+    uint64_t get_bytes_written() const { return counters_.load(BYTES_WRITTEN); }
+    uint64_t get_flushes() const { return counters_.load(FLUSHES); }
+    uint64_t get_errors() const { return counters_.load(ERRORS); }
     double get_average_write_latency_us() const;
+    uint64_t get_total_write_time_us() const { return counters_.load(WRITE_TIME_US); }
+    uint64_t get_dropped() const { return counters_.load(DROPPED); }
+    size_t get_queue_depth() const { return queue_depth_.load(std::memory_order_relaxed); }
+    size_t get_max_queue_depth() const { return max_queue_depth_.load(std::memory_order_relaxed); }
+    RateMeter::Rates get_bytes_written_rates() const { return bytes_rate_.sample(get_bytes_written()); }
+    RateMeter::Rates get_error_rates() const { return error_rate_.sample(get_errors()); }
 
     std::string export_prometheus(const std::string& prefix = "Zyrnix") const;
+    void export_prometheus(std::string& out, const std::string& prefix) const;
 
 private:
     std::string name_;
-    std::atomic<uint64_t> writes_{0};
-    std::atomic<uint64_t> bytes_written_{0};
-    std::atomic<uint64_t> flushes_{0};
-    std::atomic<uint64_t> errors_{0};
-    std::atomic<uint64_t> total_write_time_us_{0};
+    enum Counter : size_t { WRITES, BYTES_WRITTEN, FLUSHES, ERRORS, WRITE_TIME_US, DROPPED, COUNTER_COUNT };
+    ShardedCounters<COUNTER_COUNT> counters_;
+    mutable RateMeter bytes_rate_;
+    mutable RateMeter error_rate_;
+    std::atomic<size_t> queue_depth_{0};
+    std::atomic<size_t> max_queue_depth_{0};
 };
 
 class MetricsRegistry {
@@ -129,7 +333,16 @@ public:
 
     std::map<std::string, LogMetrics::Snapshot> get_all_logger_snapshots() const;
 
+    /**
+     * @brief Export every logger and sink (v1.1.3)
+     *
+     * Each metric family is written once, with one sample per logger or
+     * sink labelled `logger="<name>"` or `sink="<name>"`. The registry lock
+     * is only held to copy the list of metrics; the rendering runs outside
+     * it, so scrapes never stall get_*_metrics().
+     */
     std::string export_all_prometheus(const std::string& prefix = "Zyrnix") const;
+    void export_all_prometheus(std::string& out, const std::string& prefix) const;
 
     std::string export_all_json() const;
 
@@ -137,6 +350,12 @@ public:
 
 private:
     MetricsRegistry() = default;
+
+    struct Entries {
+        std::vector<std::pair<std::string, std::shared_ptr<LogMetrics>>> loggers;
+        std::vector<std::pair<std::string, std::shared_ptr<SinkMetrics>>> sinks;
+    };
+    Entries entries() const;
     
     mutable std::mutex mutex_;
     std::map<std::string, std::shared_ptr<LogMetrics>> logger_metrics_;
@@ -1,26 +1,86 @@
 #pragma once
 #include "log_level.hpp"
+#include "log_field.hpp"
+#include "string_intern.hpp"
+#include "log_context.hpp"
 #include <string>
 #include <chrono>
-#include <unordered_map>
+#include <cstddef>
+#include <iterator>
+#include <span>
 
 namespace Zyrnix {
 
 struct LogRecord {
-    std::string logger_name;
+    // Interned (v1.1.3): assigning a logger's name is a pointer copy
+    InternedString logger_name;
     LogLevel level;
     std::string message;
     std::chrono::system_clock::time_point timestamp;
-    std::unordered_map<std::string, std::string> fields;
+    // Typed structured fields (v1.1.3); numbers stay numbers until encoded
+    FieldSet fields;
+    // Caller's LogContext at record creation (v1.1.3). Read context from here,
+    // not from LogContext, so sinks running on other threads see the caller's.
+    ContextSnapshot context;
     
     bool has_field(const std::string& key) const {
-        return fields.find(key) != fields.end();
+        return fields.contains(key);
     }
     
     std::string get_field(const std::string& key) const {
-        auto it = fields.find(key);
-        return (it != fields.end()) ? it->second : "";
+        return fields.get(key).to_string();
     }
 };
 
+/**
+ * @brief Records handed to LogSink::log_batch() (v1.1.3)
+ *
+ * A read-only view over either a contiguous array of records (AsyncSink
+ * batches) or an array of pointers to records shared with other sinks
+ * (SinkWorker queues), so queued records reach the sink without another
+ * copy. Iterates and indexes like a span of records.
+ */
+class LogRecordBatch {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = LogRecord;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const LogRecord*;
+        using reference = const LogRecord&;
+
+        iterator() = default;
+        iterator(const LogRecordBatch* batch, size_t index) : batch_(batch), index_(index) {}
+
+        reference operator*() const { return (*batch_)[index_]; }
+        pointer operator->() const { return &(*batch_)[index_]; }
+        iterator& operator++() { ++index_; return *this; }
+        iterator operator++(int) { iterator old = *this; ++index_; return old; }
+        bool operator==(const iterator& other) const { return index_ == other.index_; }
+
+    private:
+        const LogRecordBatch* batch_ = nullptr;
+        size_t index_ = 0;
+    };
+
+    LogRecordBatch() = default;
+    LogRecordBatch(std::span<const LogRecord> records)
+        : records_(records.data()), size_(records.size()) {}
+    LogRecordBatch(std::span<const LogRecord* const> records)
+        : pointers_(records.data()), size_(records.size()) {}
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const LogRecord& operator[](size_t i) const { return pointers_ ? *pointers_[i] : records_[i]; }
+
+    iterator begin() const { return iterator(this, 0); }
+    iterator end() const { return iterator(this, size_); }
+
+private:
+    const LogRecord* records_ = nullptr;
+    const LogRecord* const* pointers_ = nullptr;
+    size_t size_ = 0;
+};
+
 }
@@ -1,8 +1,11 @@
 #pragma once
 #include <memory>
 #include <string>
+#include <span>
 #include "log_level.hpp"
 #include "formatter.hpp"
+#include "log_field.hpp"
+#include "log_record.hpp"
 
 namespace Zyrnix {
 
@@ -11,6 +14,39 @@ public:
     virtual ~LogSink() = default;
     virtual void log(const std::string& name, LogLevel level, const std::string& message) = 0;
 
+    // Typed structured fields (v1.1.3)
+    // Called instead of log() when the record carries fields. Sinks that can
+    // encode typed values (JSON, binary) override it; the default drops the
+    // fields and falls back to log().
+    virtual void log_fields(const std::string& name, LogLevel level, const std::string& message,
+                            FieldSpan fields) {
+        (void)fields;
+        log(name, level, message);
+    }
+
+    // Record-based entry point (v1.1.3)
+    // Logger hands every sink the complete record: timestamp, fields and the
+    // caller's context snapshot. Sinks that need context or the creation
+    // timestamp override this; the default forwards to log_fields()/log().
+    virtual void log_record(const LogRecord& record) {
+        if (record.fields.empty()) {
+            log(record.logger_name.str(), record.level, record.message);
+        } else {
+            log_fields(record.logger_name.str(), record.level, record.message, record.fields.span());
+        }
+    }
+
+    // Batch entry point (v1.1.3)
+    // Queueing front ends (AsyncSink, queued sink dispatch) hand over
+    // everything they drained in one call, without copying the records. The
+    // default forwards each record to log_record(); sinks that can write a
+    // batch under one lock with one write override it.
+    virtual void log_batch(LogRecordBatch records) {
+        for (const auto& record : records) {
+            log_record(record);
+        }
+    }
+
     // Cloud-aware sinks (v1.1.3)
     // Override in cloud sinks (e.g., Loki, CloudWatch, Azure) to enable
     // per-sink redaction routing and health reporting.
@@ -10,15 +10,33 @@
 #include <deque>
 #include <map>
 #include <shared_mutex>
+#include <source_location>
 #include "log_sink.hpp"
 #include "log_level.hpp"
 #include "log_record.hpp"
+#include "log_field.hpp"
+#include "string_intern.hpp"
+#ifndef XLOG_NO_ASYNC
+#include "async/sink_worker.hpp"
+#endif
+#include <initializer_list>
 
 namespace Zyrnix {
 
 #ifndef XLOG_NO_FILTERS
 class LogFilter;
 #endif
+#ifndef XLOG_NO_METRICS
+class LogMetrics;
+#endif
+#ifndef XLOG_NO_RATE_LIMITING
+class RateLimiter;
+class KeyedRateLimiter;
+struct KeyedRateLimitOptions;
+class AdaptiveSampler;
+struct AdaptiveSamplingOptions;
+class SinkMetrics;
+#endif
 
 struct LevelChangeEntry {
     LogLevel old_level;
@@ -41,6 +59,10 @@ struct SinkEntry {
     std::string name;
     std::atomic<bool> marked_for_removal{false};
     std::atomic<int> ref_count{0};
+#ifndef XLOG_NO_ASYNC
+    // Set when the sink is fed through its own queue (v1.1.3)
+    std::shared_ptr<SinkWorker> worker;
+#endif
     
     SinkEntry(LogSinkPtr s, std::string n = "") 
         : sink(std::move(s)), name(std::move(n)) {}
@@ -91,6 +113,16 @@ private:
     SinkEntryPtr entry_;
 };
 
+#ifndef XLOG_NO_ASYNC
+/**
+ * @brief How Logger::log hands records to its sinks (v1.1.3)
+ */
+enum class SinkDispatchMode {
+    Sequential, // Every sink is called on the logging thread, one after another
+    Queued      // Every sink gets its own bounded queue and worker thread
+};
+#endif
+
 class Logger {
 public:
     explicit Logger(std::string name);
@@ -101,7 +133,8 @@ public:
     void clear_sinks();
     bool remove_sink(const std::string& name, bool wait_for_completion = true);
 
-    // PII/Sensitive data redaction
+    // PII/Sensitive data redaction. Patterns apply to the message, string
+    // field values and context values of each record.
     void set_redact_patterns(const std::vector<std::string>& patterns);
     void clear_redact_patterns();
     // Regex-based redaction (v1.1.3)
@@ -124,15 +157,87 @@ public:
      * @brief Get number of active sinks
      */
     size_t sink_count() const;
+
+#ifndef XLOG_NO_ASYNC
+    /**
+     * @brief Give every sink its own queue and worker thread (v1.1.3)
+     *
+     * In Queued mode log() copies the record once, queues it for each sink
+     * and returns, so a slow sink (Loki, syslog) no longer delays the
+     * caller or the other sinks. @p options sets the capacity and overflow
+     * policy of each queue; queue depth and drops are reported through
+     * MetricsRegistry::get_sink_metrics("<logger>.<sink name or sinkN>").
+     * Applies to existing sinks and to sinks added later.
+     */
+    void set_sink_dispatch(SinkDispatchMode mode, const SinkQueueOptions& options = SinkQueueOptions{});
+    SinkDispatchMode get_sink_dispatch() const;
+
+    /**
+     * @brief Queue only the named sink, with its own options (v1.1.3)
+     *
+     * Lets a slow remote sink run behind a queue while fast local sinks
+     * stay synchronous.
+     * @return false if no sink has that name
+     */
+    bool set_sink_queue(const std::string& sink_name, const SinkQueueOptions& options);
+
+    /**
+     * @brief Block until every queued record has been written (v1.1.3)
+     */
+    void flush_sink_queues();
+#endif
+
+    /**
+     * @brief Log pending summaries, then wait for queued records (v1.1.3)
+     *
+     * Rate-limit and DedupFilter counts are otherwise reported only when a
+     * later message comes by after their interval, so the last ones of a
+     * burst would be lost. The destructor calls this too.
+     */
+    void flush();
     
-    void log(LogLevel level, const std::string& message);
+    /**
+     * @brief Log a message (v1.1.3)
+     * @param where Defaults to the caller's file:line, which keys the
+     *        callsite rate limit; the level helpers below forward theirs
+     */
+    void log(LogLevel level, const std::string& message, std::source_location where = std::source_location::current());
+
+    /**
+     * @brief Log with typed structured fields (v1.1.3)
+     *
+     * Sinks that understand typed values (StructuredJsonSink, BinaryFileSink)
+     * receive the fields through LogSink::log_fields(); other sinks get the
+     * plain message.
+     */
+    void log(LogLevel level, const std::string& message, FieldSpan fields,
+             std::source_location where = std::source_location::current());
 
-    void trace(const std::string& msg);
-    void debug(const std::string& msg);
-    void info(const std::string& msg);
-    void warn(const std::string& msg);
-    void error(const std::string& msg);
-    void critical(const std::string& msg);
+    /**
+     * @brief Log from a known callsite; used by the XLOG_* macros (v1.1.3)
+     * @param file Must outlive the logger, e.g. __FILE__
+     */
+    void log_at(const char* file, int line, LogLevel level, const std::string& message);
+
+    void trace(const std::string& msg, std::source_location where = std::source_location::current());
+    void debug(const std::string& msg, std::source_location where = std::source_location::current());
+    void info(const std::string& msg, std::source_location where = std::source_location::current());
+    void warn(const std::string& msg, std::source_location where = std::source_location::current());
+    void error(const std::string& msg, std::source_location where = std::source_location::current());
+    void critical(const std::string& msg, std::source_location where = std::source_location::current());
+
+    void trace(const std::string& msg, std::initializer_list<Field> fields,
+               std::source_location where = std::source_location::current());
+    void debug(const std::string& msg, std::initializer_list<Field> fields,
+               std::source_location where = std::source_location::current());
+    void info(const std::string& msg, std::initializer_list<Field> fields,
+              std::source_location where = std::source_location::current());
+    void warn(const std::string& msg, std::initializer_list<Field> fields,
+              std::source_location where = std::source_location::current());
+    void error(const std::string& msg, std::initializer_list<Field> fields,
+               std::source_location where = std::source_location::current());
+    void critical(const std::string& msg, std::initializer_list<Field> fields,
+                  std::source_location where = std::source_location::current());
     
     void set_level(LogLevel level);
     LogLevel get_level() const;
@@ -163,6 +268,72 @@ public:
     void clear_filters();
     void set_filter_func(std::function<bool(const LogRecord&)> func);
 #endif
+
+#ifndef XLOG_NO_RATE_LIMITING
+    /**
+     * @brief Drop messages beyond @p messages_per_second (token bucket) (v1.1.3)
+     * @param burst Bucket size; defaults to one second's worth of messages
+     *
+     * Applied after level and filter checks; dropped messages are counted
+     * as rate limited in metrics().
+     */
+    void set_rate_limit(size_t messages_per_second, size_t burst = 0);
+    void clear_rate_limit();
+
+    /**
+     * @brief Rate limit each callsite on its own (v1.1.3)
+     *
+     * Callsites are the file:line of the log()/info()/... call or of the
+     * XLOG_* macro (log_at()); log_at() without a file keys by the message
+     * text. One noisy line
+     * then cannot use up the budget of every other line. Suppressed
+     * messages are counted as rate limited, and every
+     * options.summary_interval the logger emits one
+     * "Suppressed N messages from file:line" record per affected key.
+     */
+    void set_callsite_rate_limit(const KeyedRateLimitOptions& options);
+
+    /**
+     * @brief Rate limit per value of a field, e.g. "tenant" or "user_id" (v1.1.3)
+     *
+     * The value is taken from the message's fields, else from LogContext.
+     * Messages without the field are not limited per key. Summaries read
+     * "Suppressed N messages with field=value".
+     */
+    void set_field_rate_limit(const std::string& field, const KeyedRateLimitOptions& options);
+    void clear_keyed_rate_limit();
+
+    /**
+     * @brief Sample Trace..Warn messages while sinks are backed up (v1.1.3)
+     *
+     * See AdaptiveSampler. With no options.sinks given, the sampler watches
+     * this logger's queued sinks (set_sink_dispatch(), set_sink_queue()) and
+     * AsyncSink-wrapped sinks, looked up again on every adjustment so sinks
+     * added or re-queued later count too. A logger with neither (plain
+     * Sequential dispatch) gives it nothing to measure, and nothing is
+     * sampled until it has one. Sampled-out messages are counted as rate
+     * limited.
+     */
+    void set_adaptive_sampling(const AdaptiveSamplingOptions& options);
+    void clear_adaptive_sampling();
+    std::shared_ptr<AdaptiveSampler> adaptive_sampler() const;
+#endif
+
+#ifndef XLOG_NO_METRICS
+    /**
+     * @brief Built-in logger metrics (v1.1.3)
+     *
+     * Each logger records into MetricsRegistry::get_logger_metrics(name),
+     * looked up once at construction: messages logged, rejected by level,
+     * filtered, rate limited, dropped by full sink queues and sink errors,
+     * plus log-call latency sampled on every 16th call per thread. All of
+     * it is per-thread sharded, so it stays on by default; disabling skips
+     * even those counter increments.
+     */
+    void set_metrics_enabled(bool enabled);
+    bool metrics_enabled() const { return metrics_enabled_.load(std::memory_order_relaxed); }
+    const std::shared_ptr<LogMetrics>& metrics() const { return metrics_; }
+#endif
     
     static std::shared_ptr<Logger> create_stdout_logger(const std::string& name);
     
@@ -170,9 +341,18 @@ public:
     static std::shared_ptr<Logger> create_async(const std::string& name);
 #endif
     
-    std::string name;
+    // Fixed at construction: records carry the interned copy below
+    const std::string name;
+
+    /**
+     * @brief Interned copy of the name taken at construction (v1.1.3)
+     *
+     * Records and sinks receive this instead of copies of `name`.
+     */
+    const InternedString& interned_name() const { return interned_name_; }
 
 private:
+    InternedString interned_name_;
     std::vector<std::string> redact_patterns_;
     std::vector<std::string> redact_regex_patterns_;
     std::vector<std::string> redact_pii_presets_;
@@ -182,14 +362,45 @@ private:
     void record_level_change(LogLevel old_level, LogLevel new_level, const std::string& reason);
     void cleanup_removed_sinks(); 
     void wait_for_sink_drain(SinkEntryPtr& entry); 
+    // is_summary: summaries from the rate limiters or filters, which skip the filters and rate limiters
+    void log_impl(LogLevel level, const std::string& message, FieldSpan fields,
+                  const char* file, int line, bool is_summary);
     
 
     std::vector<SinkEntryPtr> sink_entries_;
     mutable std::shared_mutex sinks_mtx_;  
+#ifndef XLOG_NO_ASYNC
+    std::shared_ptr<SinkWorker> make_sink_worker(const SinkEntry& entry, size_t index,
+                                                 const SinkQueueOptions& options) const;
+    std::string sink_metrics_name(const SinkEntry& entry, size_t index) const;
+
+    SinkDispatchMode dispatch_mode_ = SinkDispatchMode::Sequential;  // guarded by sinks_mtx_
+    SinkQueueOptions dispatch_options_;
+#endif
     
 #ifndef XLOG_NO_FILTERS
     std::vector<std::shared_ptr<LogFilter>> filters_;
     std::function<bool(const LogRecord&)> filter_func_;
+#endif
+#ifndef XLOG_NO_RATE_LIMITING
+    std::shared_ptr<RateLimiter> rate_limiter_; // guarded by mtx_
+    std::shared_ptr<AdaptiveSampler> sampler_;  // guarded by mtx_
+    // Source for a sampler without fixed sinks: queued and AsyncSink metrics
+    void collect_pressure_sources(std::vector<std::shared_ptr<SinkMetrics>>& out) const;
+    void replace_sampler(std::shared_ptr<AdaptiveSampler> sampler);
+    struct KeyedRateLimit;
+    std::shared_ptr<const KeyedRateLimit> keyed_rate_limit_; // guarded by mtx_
+    void replace_keyed_rate_limit(std::shared_ptr<const KeyedRateLimit> keyed);
+    // drain: report every count now instead of only when the interval is due
+    void emit_rate_limit_summaries(const KeyedRateLimit& keyed, bool drain = false);
+#endif
+#ifndef XLOG_NO_METRICS
+    // Cached so the log path never touches the registry map or its mutex
+    std::shared_ptr<LogMetrics> metrics_;
+    std::atomic<bool> metrics_enabled_{true};
+    LogMetrics* active_metrics() const {
+        return metrics_enabled_.load(std::memory_order_relaxed) ? metrics_.get() : nullptr;
+    }
 #endif
     std::atomic<LogLevel> min_level_;
     std::vector<LogLevelChangeCallback> level_change_callbacks_;
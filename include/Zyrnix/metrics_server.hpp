@@ -0,0 +1,126 @@
+#pragma once
+#include "Zyrnix_features.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Zyrnix {
+
+class Logger;
+
+struct MetricsServerOptions {
+    std::string bind_address = "127.0.0.1"; // Loopback only unless asked otherwise
+    uint16_t port = 9464;                    // 0 picks a free port, see MetricsServer::port()
+    std::string prometheus_prefix = "Zyrnix";
+    size_t max_connections = 16;             // Further clients are accepted and closed
+    size_t max_request_bytes = 8192;         // Larger requests get 413
+    std::chrono::milliseconds idle_timeout{30000};
+    bool enable_level_control = true;        // Serve POST /loglevel
+    // Resolves the logger named by /loglevel; defaults to HealthRegistry::find_logger
+    std::function<std::shared_ptr<Logger>(const std::string&)> logger_lookup;
+};
+
+/**
+ * @brief Embedded HTTP/1.1 endpoint for metrics, health and log levels (v1.1.3)
+ *
+ * One thread multiplexes all connections with epoll (Linux only; start()
+ * returns false elsewhere). No external dependencies.
+ *
+ * - `GET /metrics`: MetricsRegistry::export_all_prometheus()
+ * - `GET /health[?logger=name]`: HealthRegistry JSON, 503 when unhealthy
+ * - `POST /loglevel?logger=name&level=debug[&duration=60][&reason=...]`:
+ *   handle_level_change_request(); parameters may also be sent as a
+ *   form-encoded body
+ *
+ * The server only reads metrics and registries, which the log path never
+ * locks, so a slow or stuck scraper cannot block logging threads.
+ * Connection slots and their request/response buffers are allocated once
+ * in start() and reused, so steady scraping does not churn the allocator.
+ *
+ * Example:
+ * @code
+ * Zyrnix::MetricsServer server;
+ * server.start(); // http://127.0.0.1:9464/metrics
+ * @endcode
+ */
+class MetricsServer {
+public:
+    explicit MetricsServer(const MetricsServerOptions& options = MetricsServerOptions{});
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    /**
+     * @brief Bind, listen and start the server thread
+     * @return false if the socket could not be set up (or not on Linux)
+     */
+    bool start();
+    void stop();
+    bool running() const { return running_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Port actually bound (differs from the option when it was 0)
+     */
+    uint16_t port() const { return bound_port_; }
+
+    struct Response {
+        int status = 200;
+        std::string content_type = "text/plain; charset=utf-8";
+        std::string body;
+    };
+
+    /**
+     * @brief Route one request; used by the server thread, public for embedding
+     * @param target Path with optional query string, e.g. "/health?logger=app"
+     */
+    void handle(const std::string& method, const std::string& target, const std::string& body,
+                Response& response) const;
+
+private:
+    struct Connection {
+        int fd = -1;
+        std::string in;
+        std::string out;
+        size_t out_pos = 0;
+        bool close_after_write = false;
+        bool watching_write = false; // Registered for EPOLLOUT rather than EPOLLIN
+        bool peer_closed = false;    // Client shut down its side; close once answered
+        std::chrono::steady_clock::time_point last_active;
+    };
+
+    void run();
+    void accept_clients();
+    void on_readable(Connection& conn);
+    void on_writable(Connection& conn);
+    // Writes pending output and answers buffered requests until one is incomplete
+    void serve(Connection& conn);
+    // Parses a complete request out of conn.in, if there is one
+    // @return true if a response (possibly an error) was queued
+    bool process_request(Connection& conn);
+    void queue_response(Connection& conn, const Response& response, bool keep_alive);
+    // @return false if the connection closed or is waiting to become writable
+    bool write_pending(Connection& conn);
+    // Answers with @p status and closes the connection
+    void reject(Connection& conn, int status);
+    void watch(Connection& conn, bool writing);
+    void close_connection(Connection& conn);
+    void close_idle();
+
+    MetricsServerOptions options_;
+    std::vector<Connection> connections_; // Server thread only after start()
+    Response response_;                   // Reused by the server thread
+    int listen_fd_ = -1;
+    int epoll_fd_ = -1;
+    int wake_fd_ = -1;
+    uint16_t bound_port_ = 0;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+};
+
+}
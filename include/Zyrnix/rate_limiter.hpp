@@ -3,10 +3,34 @@
 #include <chrono>
 #include <functional>
 #include <atomic>
+#include <cstdint>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "log_level.hpp"
+#include "sharded_counter.hpp"
 
 namespace Zyrnix {
 
+class SinkMetrics;
+
+/**
+ * @brief Lock-free token bucket (v1.1.3)
+ *
+ * The whole bucket is one 64-bit atomic: the time, in nanoseconds since
+ * construction, at which it would be full again (GCRA). Taking a token
+ * moves that time forward by 1/rate with a CAS, so the token count and
+ * refill are updated together without a mutex, and refill has nanosecond
+ * resolution instead of whole milliseconds.
+ *
+ * For extreme rates set_thread_cache() lets each thread take several
+ * tokens per CAS and spend them locally. Each thread has eight cache
+ * slots, one per limiter it logs through, so cached tokens per limiter are
+ * bounded by threads x batch and can briefly exceed the burst by that much.
+ */
 class RateLimiter {
 public:
     explicit RateLimiter(size_t messages_per_second = 0, size_t burst_capacity = 0);
@@ -21,15 +45,134 @@ public:
 
     bool is_enabled() const { return max_tokens_ > 0; }
 
+    /**
+     * @brief Tokens a thread takes per refill of its local cache; 0 or 1 disables
+     *
+     * Each thread caches tokens for up to eight limiters at once.
+     */
+    void set_thread_cache(size_t tokens_per_thread);
+
 private:
-    void refill_tokens();
-
-    size_t max_tokens_;                  
-    size_t refill_rate_;                  
-    std::atomic<double> tokens_;          
-    std::chrono::steady_clock::time_point last_refill_;
-    std::atomic<uint64_t> dropped_count_; 
-    mutable std::mutex mutex_;
+    // Takes up to @p wanted tokens; returns how many were granted (0 or wanted, else 1)
+    uint64_t acquire(uint64_t wanted);
+    int64_t now_ns() const;
+
+    size_t max_tokens_;
+    size_t refill_rate_;
+    int64_t interval_ns_;     // Time per token
+    int64_t burst_ns_;        // Time to refill the whole bucket
+    std::chrono::steady_clock::time_point epoch_;
+    std::atomic<int64_t> full_at_{0}; // Bucket is full from this time on (ns since epoch_)
+    std::atomic<uint64_t> dropped_count_;
+    std::atomic<uint64_t> cache_id_;  // Changes on reset() to void thread caches
+    std::atomic<uint32_t> thread_cache_{0};
+};
+
+struct KeyedRateLimitOptions {
+    size_t messages_per_second = 10;          // Per key
+    size_t burst = 0;                         // Defaults to messages_per_second
+    size_t max_keys = 4096;
+    std::chrono::milliseconds summary_interval{10000};
+};
+
+/**
+ * @brief Independent token buckets per key, e.g. per callsite or tenant (v1.1.3)
+ *
+ * Keys are 64-bit hashes chosen by the caller. At most @p max_keys buckets
+ * are kept; the least recently used key is evicted when a new one arrives.
+ * The table is split into shards with their own mutex and preallocated
+ * slots, so threads logging from different keys rarely meet and a flood
+ * of new keys recycles slots instead of growing the table. An evicted
+ * key starts again with a full burst, so size @p max_keys above the
+ * number of keys active within one refill period.
+ *
+ * Rejected messages are counted per key. collect_summaries() hands out
+ * those counts once per summary interval (and for evicted keys), so the
+ * caller can log "suppressed N messages" instead of losing them silently.
+ */
+class KeyedRateLimiter {
+public:
+    struct Summary {
+        std::string label; // As given when the key was first seen; empty for the evicted-key overflow
+        int line;          // As given with the label, or -1
+        uint64_t suppressed;
+        LogLevel level;    // Highest level among the suppressed messages
+    };
+
+    explicit KeyedRateLimiter(const KeyedRateLimitOptions& options = KeyedRateLimitOptions{});
+
+    /**
+     * @brief Take a token for @p key
+     * @param label Human-readable key (e.g. a file name), copied only when the key is new
+     * @param line Optional line number kept with the label
+     * @param summaries_due If given, set when collect_summaries() is due,
+     *        which spares the caller a clock read per message
+     */
+    bool try_log(uint64_t key, LogLevel level, std::string_view label, int line = -1,
+                 bool* summaries_due = nullptr);
+
+    /**
+     * @brief Append summaries for keys with suppressed messages, if due
+     *
+     * Cheap when not due: one clock read and an atomic load. Exactly one
+     * caller per interval collects.
+     * @return true if anything was appended
+     */
+    bool collect_summaries(std::vector<Summary>& out);
+
+    /**
+     * @brief Append summaries for every key with suppressed messages, due or not
+     *
+     * For shutdown and explicit flushes, so the last counts are not lost.
+     * @return true if anything was appended
+     */
+    bool drain_summaries(std::vector<Summary>& out);
+
+    size_t key_count() const;
+    uint64_t suppressed_total() const { return suppressed_total_.load(std::memory_order_relaxed); }
+    const KeyedRateLimitOptions& options() const { return options_; }
+
+private:
+    static constexpr size_t SHARDS = 16;
+    static constexpr uint32_t NONE = UINT32_MAX;
+    static constexpr size_t MAX_PENDING = 64; // Evicted summaries kept per shard
+
+    struct Entry {
+        uint64_t key = 0;
+        std::string label;
+        int line = -1;
+        int64_t full_at = 0;   // GCRA state, as in RateLimiter
+        uint64_t suppressed = 0;
+        LogLevel level = LogLevel::Trace;
+        uint32_t prev = NONE;  // LRU list, most recent at head
+        uint32_t next = NONE;
+    };
+
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<uint64_t, uint32_t> index;
+        std::vector<Entry> entries;
+        uint32_t head = NONE;
+        uint32_t tail = NONE;
+        uint32_t used = 0;
+        std::vector<Summary> pending; // Suppressed counts of evicted keys
+        uint64_t pending_overflow = 0;
+        LogLevel pending_overflow_level = LogLevel::Trace;
+    };
+
+    int64_t now_ns() const;
+    static void unlink(Shard& shard, uint32_t slot);
+    static void push_front(Shard& shard, uint32_t slot);
+    bool take_summaries(std::vector<Summary>& out);
+
+    KeyedRateLimitOptions options_;
+    int64_t interval_ns_;
+    int64_t burst_ns_;
+    size_t capacity_per_shard_;
+    std::chrono::steady_clock::time_point epoch_;
+    std::atomic<int64_t> next_summary_ns_;
+    std::atomic<uint64_t> suppressed_total_{0};
+    Shard shards_[SHARDS];
 };
 
 class SamplingLimiter {
@@ -51,6 +194,111 @@ private:
     std::atomic<uint64_t> counter_;
 };
 
+struct AdaptiveSamplingOptions {
+    // Fixed pressure sources. When empty, Logger::set_adaptive_sampling()
+    // watches the logger's queued and AsyncSink-wrapped sinks as they come and go.
+    std::vector<std::shared_ptr<SinkMetrics>> sinks;
+    size_t queue_depth_high = 1024;          // Tighten when any queue is deeper
+    size_t queue_depth_low = 128;            // Relax when all are at most this deep
+    uint64_t write_latency_high_us = 20000;  // Average sink write time over the last interval
+    uint64_t write_latency_low_us = 5000;
+    size_t max_sample_rate = 64;             // Keep at least 1 in N of every level
+    std::chrono::milliseconds adjust_interval{250};
+};
+
+/**
+ * @brief Sampling that follows sink backpressure (v1.1.3)
+ *
+ * Once per adjust interval the sampler reads queue depth and recent
+ * write latency from the watched SinkMetrics. While either is above its
+ * high mark the pressure step rises by one; once both are back under
+ * their low marks it falls by one per elapsed interval. In between it
+ * holds, so the sampler does not flap around a single threshold.
+ *
+ * Each step doubles the sampling ratio, lowest levels first: step 1
+ * keeps 1 in 2 Trace messages, step 2 also starts on Debug, and Warn is
+ * sampled from step 4 on, all capped at 1 in @p max_sample_rate.
+ * Error and Critical always pass.
+ *
+ * Unpressured, should_log() costs a thread-local counter and a clock
+ * read every 64 calls; while sampling it reads the clock on each call.
+ * Adjusting runs on whichever caller finds it due.
+ *
+ * With neither options.sinks nor a source (set_source()) to read, or a
+ * source that currently yields nothing, there is no pressure to measure:
+ * the sampler stays at step 0 and passes everything. watched_sinks()
+ * tells how many sinks the last adjustment looked at.
+ */
+class AdaptiveSampler {
+public:
+    // Appends the SinkMetrics to watch right now
+    using Source = std::function<void(std::vector<std::shared_ptr<SinkMetrics>>&)>;
+
+    explicit AdaptiveSampler(const AdaptiveSamplingOptions& options = AdaptiveSamplingOptions{});
+
+    /**
+     * @brief Resolve the pressure sources on every adjustment (v1.1.3)
+     *
+     * Used when options.sinks is empty, so sinks added or re-queued later
+     * are watched too. Pass nullptr to detach; that waits for an
+     * adjustment in progress, so the source may then be destroyed.
+     */
+    void set_source(Source source);
+
+    bool should_log(LogLevel level);
+
+    /**
+     * @brief Current pressure step; 0 means nothing is sampled
+     */
+    unsigned pressure() const { return step_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Current ratio for @p level: 1 in N messages pass
+     */
+    size_t sample_rate(LogLevel level) const;
+
+    uint64_t sampled_out() const { return sampled_out_.load(0); }
+
+    /**
+     * @brief Re-read the pressure sources now instead of on the next due call
+     */
+    void adjust();
+
+    const AdaptiveSamplingOptions& options() const { return options_; }
+
+    /**
+     * @brief Sinks the last adjustment read; 0 means nothing is watched
+     */
+    size_t watched_sinks() const { return watched_count_.load(std::memory_order_relaxed); }
+
+private:
+    struct SinkState {
+        std::shared_ptr<SinkMetrics> sink;
+        uint64_t writes = 0;
+        uint64_t write_time_us = 0;
+    };
+
+    int64_t now_ns() const;
+    void maybe_adjust();
+    void adjust_at(int64_t now);
+    unsigned shift_for(unsigned step, LogLevel level) const;
+
+    AdaptiveSamplingOptions options_;
+    unsigned max_shift_;  // log2(max_sample_rate)
+    unsigned max_step_;
+    int64_t interval_ns_;
+    std::chrono::steady_clock::time_point epoch_;
+    std::atomic<unsigned> step_{0};
+    std::atomic<int64_t> next_adjust_ns_;
+    std::mutex adjust_mtx_;               // Held by the caller doing the adjusting
+    int64_t last_adjust_ns_ = 0;          // guarded by adjust_mtx_
+    Source source_;                       // guarded by adjust_mtx_
+    std::vector<SinkState> sink_states_;  // guarded by adjust_mtx_; last sinks read
+    std::vector<std::shared_ptr<SinkMetrics>> resolved_; // guarded by adjust_mtx_
+    std::atomic<size_t> watched_count_{0};
+    ShardedCounters<1> sampled_out_;
+};
+
 class CombinedLimiter {
 public:
     explicit CombinedLimiter(
@@ -0,0 +1,68 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Zyrnix {
+
+/**
+ * @brief Stable per-thread index for picking a shard (v1.1.3)
+ *
+ * Threads are numbered round-robin on first use; callers reduce the
+ * index modulo their shard count. Unlike the current CPU number this
+ * never changes under the thread, so a shard is only shared when there
+ * are more threads than shards.
+ */
+inline size_t thread_shard_index() {
+    static std::atomic<size_t> next{0};
+    // Constant-initialized, so reading it needs no TLS init guard
+    thread_local size_t index = SIZE_MAX;
+    if (index == SIZE_MAX) {
+        index = next.fetch_add(1, std::memory_order_relaxed);
+    }
+    return index;
+}
+
+/**
+ * @brief Group of hot-path counters, sharded per thread (v1.1.3)
+ *
+ * Each shard holds all N counters in its own cache line(s), so threads
+ * that bump several counters per log call touch one line of their own
+ * instead of contending on a shared one. add() is a single uncontended
+ * relaxed fetch_add; load() sums the shards and is meant for snapshots
+ * and exporters.
+ */
+template <size_t N>
+class ShardedCounters {
+public:
+    static constexpr size_t SHARDS = 32;
+
+    void add(size_t counter, uint64_t n = 1) {
+        shards_[thread_shard_index() % SHARDS].values[counter].fetch_add(n, std::memory_order_relaxed);
+    }
+
+    uint64_t load(size_t counter) const {
+        uint64_t total = 0;
+        for (const auto& shard : shards_) {
+            total += shard.values[counter].load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    void reset() {
+        for (auto& shard : shards_) {
+            for (auto& value : shard.values) {
+                value.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> values[N] = {};
+    };
+
+    Shard shards_[SHARDS];
+};
+
+}
@@ -0,0 +1,119 @@
+#pragma once
+#include "../log_sink.hpp"
+#include "../log_record.hpp"
+#include "../async/sink_worker.hpp"
+#include "../async/backend_thread.hpp"
+#include "../async/adaptive_batcher.hpp"
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <memory>
+#include <string>
+
+namespace Zyrnix {
+
+class SinkMetrics;
+class LogMetrics;
+
+struct AsyncSinkOptions {
+    size_t capacity = 8192;                          // Records held in the ring
+    OverflowPolicy overflow = OverflowPolicy::Block;
+    size_t max_batch = 1024;                         // Records per log_batch() call
+    std::string metrics_name;                        // Defaults to "async_sink.<Wrapped>.<N>", unique per instance
+    BackendThreadOptions backend;                    // Pinning, NUMA node, wait policy (v1.1.3)
+    // Latency budget for adaptive batching; zero writes whatever is queued
+    std::chrono::microseconds max_delay{1000};
+    // Receives batch size and enqueue-to-write histograms, e.g. the owning
+    // logger's metrics; defaults to a private instance (see batch_metrics())
+    std::shared_ptr<LogMetrics> log_metrics;
+};
+
+/**
+ * @brief Makes any sink asynchronous (v1.1.3)
+ *
+ * Wraps a sink (syslog, UDP, Loki, ...) with a bounded ring of records and
+ * a dedicated thread that hands everything queued to the wrapped sink's
+ * log_batch() in one call, so only the expensive sinks of a logger need to
+ * be async while e.g. stdout stays synchronous.
+ *
+ * Ring slots are reused: once warmed up, queueing a record copies it into
+ * an existing slot without allocating. The writer swaps a batch out of the
+ * ring into its own reusable buffer, so the ring is free again while the
+ * wrapped sink is still writing. The backlog (queued records) and
+ * drops are reported to MetricsRegistry::get_sink_metrics(metrics_name).
+ *
+ * Batch sizes adapt to the load (see AdaptiveBatcher): a lone record is
+ * written immediately, while under load the writer waits up to max_delay
+ * for a larger batch. flush() and shutdown never wait for the budget.
+ *
+ * Example:
+ * @code
+ * auto syslog = std::make_shared<SyslogSink>("myapp");
+ * logger->add_sink(std::make_shared<AsyncSink>(syslog));
+ * @endcode
+ */
+class AsyncSink : public LogSink {
+public:
+    explicit AsyncSink(LogSinkPtr inner, const AsyncSinkOptions& options = AsyncSinkOptions{});
+    ~AsyncSink() override;
+
+    void log(const std::string& name, LogLevel level, const std::string& message) override;
+    void log_fields(const std::string& name, LogLevel level, const std::string& message,
+                    FieldSpan fields) override;
+    void log_record(const LogRecord& record) override;
+    void log_batch(LogRecordBatch records) override;
+    bool is_cloud_sink() const override { return inner_->is_cloud_sink(); }
+
+    /**
+     * @brief Block until every queued record has been written
+     */
+    void flush();
+
+    size_t backlog() const;
+    uint64_t dropped() const;
+    const LogSinkPtr& inner() const { return inner_; }
+    const std::string& metrics_name() const { return options_.metrics_name; }
+    // Backlog, drops and write times, as registered under metrics_name()
+    const std::shared_ptr<SinkMetrics>& sink_metrics() const { return metrics_; }
+    // Batch size and enqueue-to-write histograms (options.log_metrics if given)
+    const std::shared_ptr<LogMetrics>& batch_metrics() const { return log_metrics_; }
+
+private:
+    // Copies the record into the ring (called with mtx_ held)
+    bool push_locked(std::unique_lock<std::mutex>& lock, const LogRecord& record,
+                     std::chrono::steady_clock::time_point now);
+    bool writer_wants_wake() const { return writer_blocked_ && count_ >= wake_threshold_; }
+    void run();
+
+    LogSinkPtr inner_;
+    AsyncSinkOptions options_;
+    std::shared_ptr<SinkMetrics> metrics_;
+    std::shared_ptr<LogMetrics> log_metrics_;
+    AdaptiveBatcher batcher_; // Writer thread only
+
+    mutable std::mutex mtx_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::condition_variable idle_;
+    std::vector<LogRecord> ring_;
+    std::vector<LogRecord> batch_; // Writer thread only
+    std::vector<std::chrono::steady_clock::time_point> enqueued_;       // Parallel to ring_
+    std::vector<std::chrono::steady_clock::time_point> batch_enqueued_; // Parallel to batch_
+    size_t head_ = 0;      // Oldest queued record
+    size_t count_ = 0;     // Records in the ring
+    size_t in_flight_ = 0; // Records handed to the wrapped sink
+    uint64_t dropped_ = 0;
+    bool ready_ = false;          // Ring allocated by the writer thread
+    bool writer_blocked_ = false; // Writer sleeps on not_empty_
+    size_t wake_threshold_ = 1;   // Backlog the sleeping writer waits for
+    size_t flush_waiters_ = 0;    // Pending flush() calls cut lingering short
+    std::atomic<bool> stop_{false};
+    std::atomic<size_t> pending_{0}; // Mirrors count_ for the spinning writer
+
+    std::thread thread_;
+};
+
+}
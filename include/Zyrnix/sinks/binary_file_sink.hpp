@@ -0,0 +1,118 @@
+#pragma once
+#include "../log_sink.hpp"
+#include "../log_field.hpp"
+#include "../string_intern.hpp"
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+
+namespace Zyrnix {
+
+struct BinaryLogOptions {
+    size_t buffer_size = 64 * 1024; // Bytes buffered before a write to the file
+    size_t sync_interval = 4096; // Records per block; each block restarts the dictionary
+    size_t max_dictionary_entries = 4096; // Dictionary IDs per block available to repeated messages
+    size_t max_dictionary_message_len = 256; // Longer messages are always written inline
+    LogLevel flush_level = LogLevel::Error; // Records at or above this level are flushed at once
+};
+
+/**
+ * @brief Compact binary log sink (v1.1.3)
+ *
+ * Writes a self-describing binary stream instead of formatted text. Records
+ * carry a delta-encoded nanosecond timestamp, the level, a dictionary ID for
+ * the logger name, the message and typed field payloads (see log_field.hpp).
+ * Logger names and field keys are written once per block into a string
+ * dictionary; messages that repeat within a block (i.e. constant call-site
+ * messages) are promoted to the dictionary on their second occurrence.
+ *
+ * Every `sync_interval` records a new block starts with an absolute
+ * timestamp and an empty dictionary, which bounds the dictionary's size.
+ * Blocks carry no sync marker, so a reader must decode from the start of
+ * the file; a truncated tail only loses the last partial record.
+ *
+ * Use `tools/zyrnix_decode.py` to render a file back to the usual text or
+ * JSON Lines layout:
+ * @code
+ * python3 tools/zyrnix_decode.py app.zlog          # text
+ * python3 tools/zyrnix_decode.py --json app.zlog   # JSON Lines
+ * @endcode
+ *
+ * Stream layout (all integers are LEB128 varints, svarint = zigzag varint):
+ * @code
+ * header  : "ZYRNIXB" u8(version=1)              -- only at file offset 0
+ * block   : u8(0x01) varint(abs_timestamp_ns)
+ * string  : u8(0x02) varint(id) varint(len) bytes
+ * record  : u8(0x03) svarint(ts_delta_ns) u8(flags) varint(logger_id)
+ *           message varint(field_count) field*
+ *   flags   : bits 0-2 level, bit 3 message is a dictionary reference
+ *   message : varint(id) | varint(len) bytes
+ *   field   : varint(key_id) u8(type) payload
+ *   payload : Null: -, Int: svarint, UInt: varint, Double: fixed64 LE,
+ *             Bool: u8, String: varint(len) bytes
+ * @endcode
+ */
+class BinaryFileSink : public LogSink {
+public:
+    static constexpr uint8_t FORMAT_VERSION = 1;
+
+    explicit BinaryFileSink(const std::string& filename,
+                            const BinaryLogOptions& options = BinaryLogOptions{});
+    ~BinaryFileSink() override;
+
+    BinaryFileSink(const BinaryFileSink&) = delete;
+    BinaryFileSink& operator=(const BinaryFileSink&) = delete;
+
+    void log(const std::string& name, LogLevel level, const std::string& message) override;
+    void log_fields(const std::string& name, LogLevel level, const std::string& message,
+                    FieldSpan fields) override;
+
+    /**
+     * @brief Write buffered records to the file
+     */
+    void flush();
+
+    bool is_open() const { return file_.is_open(); }
+    uint64_t records_written() const;
+    uint64_t bytes_written() const;
+
+private:
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+    };
+    using Dictionary = std::unordered_map<std::string, uint32_t, StringHash, std::equal_to<>>;
+
+    void write_record(const std::string& name, LogLevel level, const std::string& message,
+                      FieldSpan fields);
+    void begin_block(int64_t timestamp_ns);
+    uint32_t dictionary_ref(std::string_view str);
+    uint32_t message_ref(const std::string& message);
+    void write_field(const Field& field);
+    void flush_buffer();
+
+    static constexpr uint32_t NOT_DEFINED = UINT32_MAX;
+
+    std::string filename_;
+    BinaryLogOptions options_;
+    std::ofstream file_;
+    std::string buffer_;
+
+    // Interned string ID -> block-local dictionary ID
+    std::unordered_map<uint32_t, uint32_t> dictionary_;
+    Dictionary message_ids_;
+    uint32_t next_id_ = 0;
+    size_t records_in_block_ = 0;
+    int64_t last_timestamp_ns_ = 0;
+    bool block_open_ = false;
+
+    uint64_t records_written_ = 0;
+    uint64_t bytes_written_ = 0;
+    mutable std::mutex mtx_;
+};
+
+}
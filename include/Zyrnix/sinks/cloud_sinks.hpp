@@ -33,6 +33,11 @@ public:
     ~CloudWatchSink() override;
 
     void log(const std::string& name, LogLevel level, const std::string& message) override;
+
+    /**
+     * @brief Queue a batch under one lock with a single worker wake-up (v1.1.3)
+     */
+    void log_batch(LogRecordBatch records) override;
     void flush();
 
     bool is_cloud_sink() const override { return true; }
@@ -54,6 +59,8 @@ private:
         int64_t timestamp_ms;
     };
 
+    LogEvent make_event(const std::string& name, LogLevel level, const std::string& message,
+                        std::chrono::system_clock::time_point timestamp);
     void worker_thread();
     void send_batch(const std::vector<LogEvent>& events);
     bool send_to_cloudwatch(const std::vector<LogEvent>& events);
@@ -96,6 +103,11 @@ public:
     ~AzureMonitorSink() override;
 
     void log(const std::string& name, LogLevel level, const std::string& message) override;
+
+    /**
+     * @brief Queue a batch under one lock with a single worker wake-up (v1.1.3)
+     */
+    void log_batch(LogRecordBatch records) override;
     void flush();
 
     bool is_cloud_sink() const override { return true; }
@@ -119,6 +131,8 @@ private:
         std::string logger_name;
     };
 
+    TelemetryEvent make_event(const std::string& name, LogLevel level, const std::string& message,
+                              std::chrono::system_clock::time_point timestamp);
     void worker_thread();
     void send_batch(const std::vector<TelemetryEvent>& events);
     bool send_to_azure(const std::vector<TelemetryEvent>& events);
@@ -0,0 +1,115 @@
+#pragma once
+#include "../log_sink.hpp"
+#include "../log_field.hpp"
+#include "../string_intern.hpp"
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+namespace Zyrnix {
+
+struct ColumnarLogOptions {
+    size_t block_records = 8192; // Records buffered per column block
+    LogLevel flush_level = LogLevel::Critical; // Records at or above this level close the block at once
+};
+
+/**
+ * @brief Column-oriented structured log sink for analytics (v1.1.3)
+ *
+ * Buffers `block_records` records and writes them as one column block:
+ * timestamp, level, logger and message columns followed by one column per
+ * structured field key seen in the block. Rows without a value for a field
+ * key are marked in a per-column validity bitmap.
+ *
+ * Encodings are chosen per column and block:
+ * - timestamps are delta-encoded nanoseconds
+ * - logger names are always dictionary-encoded
+ * - messages and string fields are dictionary-encoded when at most half of
+ *   the values are distinct, otherwise written plain
+ * - integer fields are zigzag varints, doubles raw little-endian
+ * - fields whose type changes between rows fall back to a per-row type tag
+ *
+ * Each block starts with its row count, min/max timestamp and byte length,
+ * so readers can skip blocks outside a time range without decoding them.
+ * `tools/zyrnix_decode.py` reads these files (see `--since`/`--until`).
+ *
+ * Stream layout (integers are LEB128 varints, svarint = zigzag varint):
+ * @code
+ * header : "ZYRNIXC" u8(version=1)                 -- only at file offset 0
+ * block  : u8(0x01) varint(rows) varint(min_ts_ns) varint(max_ts_ns)
+ *          varint(body_len) body
+ * body   : column(timestamp) column(level) column(logger) column(message)
+ *          varint(field_columns) column*
+ * column : varint(len) name u8(encoding) u8(type) u8(has_validity)
+ *          [bitmap: ceil(rows/8) bytes, LSB first] values for valid rows
+ *   encoding 0 plain   : Int svarint | UInt varint | Double fixed64 |
+ *                        Bool u8 | String varint(len) bytes
+ *   encoding 1 dict    : varint(n) n*(varint(len) bytes) varint(index)*
+ *   encoding 2 delta   : svarint(first) svarint(delta)*
+ *   encoding 3 variant : (u8(type) plain value)*
+ *   type               : FieldValue::Type, 0xFF for variant columns
+ * @endcode
+ */
+class ColumnarFileSink : public LogSink {
+public:
+    static constexpr uint8_t FORMAT_VERSION = 1;
+
+    explicit ColumnarFileSink(const std::string& filename,
+                              const ColumnarLogOptions& options = ColumnarLogOptions{});
+    ~ColumnarFileSink() override;
+
+    ColumnarFileSink(const ColumnarFileSink&) = delete;
+    ColumnarFileSink& operator=(const ColumnarFileSink&) = delete;
+
+    void log(const std::string& name, LogLevel level, const std::string& message) override;
+    void log_fields(const std::string& name, LogLevel level, const std::string& message,
+                    FieldSpan fields) override;
+
+    /**
+     * @brief Write the pending (possibly partial) block to the file
+     */
+    void flush();
+
+    bool is_open() const { return file_.is_open(); }
+    uint64_t blocks_written() const;
+
+private:
+    // Buffered values of one field key; one entry per row of the block
+    struct FieldColumn {
+        InternedString name;
+        std::vector<FieldValue::Type> types;
+        std::vector<uint64_t> scalars; // Int/UInt/Double bits/Bool
+        std::vector<std::string> strings; // String values, "" for other rows
+    };
+
+    // Index into fields_, or fields_.size() if the key has no column yet
+    size_t find_column(const InternedString& key) const;
+    void write_block();
+    void encode_field_column(const FieldColumn& column);
+    template <typename Strings>
+    void encode_strings(const Strings& values, const std::vector<FieldValue::Type>* types,
+                        bool force_dictionary);
+
+    std::string filename_;
+    ColumnarLogOptions options_;
+    std::ofstream file_;
+
+    size_t rows_ = 0;
+    std::vector<int64_t> timestamps_;
+    std::vector<uint8_t> levels_;
+    std::vector<InternedString> loggers_;
+    std::vector<std::string> messages_;
+    std::vector<FieldColumn> fields_;
+    std::unordered_map<uint32_t, size_t> field_index_; // Pooled key ID -> column
+
+    std::string body_;
+    std::string block_;
+    uint64_t blocks_written_ = 0;
+    mutable std::mutex mtx_;
+};
+
+}
@@ -2,10 +2,13 @@
 #include "../Zyrnix_features.hpp"
 #include "../log_sink.hpp"
 #include "../log_record.hpp"
+#include "../async/work_stealing_pool.hpp"
 #include <string>
 #include <memory>
+#include <atomic>
 #include <mutex>
 #include <fstream>
+#include <chrono>
 
 namespace Zyrnix {
 
@@ -20,6 +23,16 @@ struct CompressionOptions {
     int level = 6; 
     bool compress_on_rotate = true; 
     bool auto_tune = false;
+    /**
+     * @brief Compress rotated files on the shared work-stealing pool (v1.1.3)
+     *
+     * rotate() then only renames files, so the logging thread is not held
+     * up for the duration of a gzip/zstd pass. If the previous pass is
+     * still running when the file fills up again, the sink keeps writing
+     * and the next call waits for it before taking the sink lock. flush()
+     * and the destructor wait for an in-flight compression.
+     */
+    bool background = true;
 };
 
 class CompressedFileSink : public LogSink {
@@ -34,6 +47,11 @@ public:
     ~CompressedFileSink() override;
 
     void log(const std::string& name, LogLevel level, const std::string& message) override;
+
+    /**
+     * @brief Writes a batch with one lock, rotating between chunks as needed (v1.1.3)
+     */
+    void log_batch(LogRecordBatch records) override;
     void flush();
 
     size_t current_size() const { return current_size_; }
@@ -50,13 +68,20 @@ public:
     
     void enable_auto_tune(bool enable = true);
     bool is_auto_tune_enabled() const { return options_.auto_tune; }
-    int get_current_compression_level() const { return current_level_; }
+    int get_current_compression_level() const {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        return current_level_;
+    }
 
 private:
     void rotate();
-    void compress_file(const std::string& source_path, const std::string& dest_path);
-    bool compress_gzip(const std::string& source, const std::string& dest);
-    bool compress_zstd(const std::string& source, const std::string& dest);
+    // False (and a rotation is left pending) while the last compression still runs
+    bool compression_idle();
+    void compress_rotated(const std::string& source, int level);
+    void wait_for_compression();
+    void compress_file(const std::string& source_path, const std::string& dest_path, int level);
+    bool compress_gzip(const std::string& source, const std::string& dest, int level);
+    bool compress_zstd(const std::string& source, const std::string& dest, int level);
     std::string get_rotated_filename(size_t index) const;
     std::string get_compressed_extension() const;
     
@@ -72,6 +97,7 @@ private:
     
     std::ofstream file_;
     size_t current_size_;
+    std::string batch_buffer_;
     
     mutable std::mutex stats_mutex_;
     uint64_t files_compressed_;
@@ -83,7 +109,13 @@ private:
     std::chrono::steady_clock::time_point last_compression_time_;
     uint64_t last_compression_duration_us_;
     size_t compression_count_;
-    
+
+    // Set up front when compressing in the background, so it can be
+    // waited on without mutex_. A rotation waits for the previous pass,
+    // which may still be reading the file the rotation renames.
+    std::unique_ptr<TaskGroup> compression_tasks_;
+    std::atomic<bool> rotation_pending_{false};
+
     std::mutex mutex_;
 };
 
@@ -11,9 +11,15 @@ public:
     explicit FileSink(const std::string& filename);
     void log(const std::string& logger_name, LogLevel level, const std::string& message) override;
 
+    /**
+     * @brief One lock, one buffer, one write and one flush per batch (v1.1.3)
+     */
+    void log_batch(LogRecordBatch records) override;
+
 private:
     std::ofstream file;
     std::mutex mtx;
+    std::string batch_buffer;
 };
 
 }
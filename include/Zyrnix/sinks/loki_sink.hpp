@@ -20,6 +20,11 @@ class LokiSink : public LogSink {
 public:
     LokiSink(const std::string& url, const std::string& labels = "", const LokiOptions& opts = LokiOptions());
     void log(const std::string& name, LogLevel level, const std::string& message) override;
+
+    /**
+     * @brief Append a whole batch and push it in one request if a trigger fired (v1.1.3)
+     */
+    void log_batch(LogRecordBatch records) override;
     void flush();
     const char* name_str() const noexcept { return "LokiSink"; }
 
@@ -35,6 +40,9 @@ private:
     std::mutex mutex_;
     std::chrono::system_clock::time_point last_flush_time_{};
 
+    void append_entry(std::string_view logger_name, LogLevel level, const std::string& message,
+                      std::chrono::system_clock::time_point timestamp);
+    void maybe_send(std::chrono::system_clock::time_point now);
     void send_batch();
 };
 
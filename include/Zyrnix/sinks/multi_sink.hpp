@@ -1,5 +1,6 @@
 #pragma once
 #include "Zyrnix/log_sink.hpp"
+#include "Zyrnix/async/work_stealing_pool.hpp"
 #include <vector>
 #include <memory>
 
@@ -14,14 +15,56 @@ public:
         sinks.push_back(sink);
     }
 
+    /**
+     * @brief Write each record to all sinks concurrently (v1.1.3)
+     *
+     * log_record() hands every sink but the first to the shared
+     * WorkStealingThreadPool, writes the first one itself and returns once
+     * all have finished (fork-join), so the caller's record stays valid.
+     * Pays off when several slow sinks (network, compression) are combined;
+     * sinks must tolerate calls from pool threads.
+     */
+    void set_parallel(bool parallel) { parallel_ = parallel; }
+    bool is_parallel() const { return parallel_; }
+
     void log(const std::string& logger_name, LogLevel level, const std::string& message) override {
         for (auto& sink : sinks) {
             sink->log(logger_name, level, message);
         }
     }
 
+    void log_fields(const std::string& logger_name, LogLevel level, const std::string& message,
+                    FieldSpan fields) override {
+        for (auto& sink : sinks) {
+            sink->log_fields(logger_name, level, message, fields);
+        }
+    }
+
+    void log_record(const LogRecord& record) override {
+        if (parallel_ && sinks.size() > 1) {
+            TaskGroup group;
+            for (size_t i = 1; i < sinks.size(); ++i) {
+                LogSink* sink = sinks[i].get();
+                group.run([sink, &record] { sink->log_record(record); });
+            }
+            sinks[0]->log_record(record);
+            group.wait();
+            return;
+        }
+        for (auto& sink : sinks) {
+            sink->log_record(record);
+        }
+    }
+
+    void log_batch(LogRecordBatch records) override {
+        for (auto& sink : sinks) {
+            sink->log_batch(records);
+        }
+    }
+
 private:
     std::vector<LogSinkPtr> sinks;
+    bool parallel_ = false;
 };
 
 }
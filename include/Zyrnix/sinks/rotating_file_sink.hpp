@@ -10,6 +10,11 @@ public:
     RotatingFileSink(const std::string& base_name, size_t max_size, size_t max_files);
     void log(const std::string& logger_name, LogLevel level, const std::string& message) override;
 
+    /**
+     * @brief Writes a batch with one lock, rotating between chunks as needed (v1.1.3)
+     */
+    void log_batch(LogRecordBatch records) override;
+
 private:
     std::string base_name;
     size_t max_size;
@@ -17,6 +22,7 @@ private:
     size_t current_size = 0;
     std::ofstream file;
     std::mutex mtx;
+    std::string batch_buffer;
     void rotate();
     void open_file();
 };
@@ -1,11 +1,16 @@
 #pragma once
 #include "../log_sink.hpp"
 #include "../log_level.hpp"
+#include "../json_writer.hpp"
+#include "../log_field.hpp"
+#include "../log_record.hpp"
+#include "../log_context.hpp"
 #include <string>
 #include <map>
 #include <fstream>
 #include <mutex>
 #include <memory>
+#include <chrono>
 
 namespace Zyrnix {
 
@@ -23,6 +28,27 @@ public:
     void log_with_fields(const std::string& logger_name, LogLevel level, 
                          const std::string& message,
                          const std::map<std::string, std::string>& fields);
+
+    /**
+     * @brief Log with typed fields (v1.1.3)
+     *
+     * Numbers and booleans are written as JSON numbers/booleans.
+     */
+    void log_with_fields(const std::string& logger_name, LogLevel level,
+                         const std::string& message, FieldSpan fields);
+
+    void log_fields(const std::string& logger_name, LogLevel level, const std::string& message,
+                    FieldSpan fields) override {
+        log_with_fields(logger_name, level, message, fields);
+    }
+
+    /**
+     * @brief Encode a record with its own timestamp and captured context (v1.1.3)
+     *
+     * Used by Logger; context comes from the record, not from the thread
+     * that happens to run the sink.
+     */
+    void log_record(const LogRecord& record) override;
     
 
     void clear_context();
@@ -30,12 +56,20 @@ public:
 private:
     std::string filename;
     std::map<std::string, std::string> global_context;
+    // Pre-rendered `,"key":"value"` members for global_context, rebuilt on change
+    std::string global_context_json;
     std::ofstream file;
     std::mutex mtx;
+    JsonWriter writer;
     
-    std::string build_json(const std::string& logger_name, LogLevel level,
-                          const std::string& message,
-                          const std::map<std::string, std::string>& fields);
+    void begin_record(const std::string& logger_name, LogLevel level,
+                      const std::string& message,
+                      std::chrono::system_clock::time_point timestamp,
+                      const ContextSnapshot& context);
+    void write_fields(FieldSpan fields);
+    void write_record();
+    void end_record();
+    void rebuild_global_context_json();
 };
 
 }
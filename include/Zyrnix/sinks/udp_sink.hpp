@@ -15,6 +15,11 @@ public:
     ~UdpSink();
     void log(const std::string& logger_name, LogLevel level, const std::string& message) override;
 
+    /**
+     * @brief One datagram per record, sent with a single sendmmsg() on Linux (v1.1.3)
+     */
+    void log_batch(LogRecordBatch records) override;
+
 private:
     int sockfd;
     struct ::sockaddr_storage dest;
@@ -0,0 +1,154 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace Zyrnix {
+
+/**
+ * @brief Handle to a string stored in the global intern table (v1.1.3)
+ *
+ * Logger names, field keys and context keys repeat on every record. Interning
+ * them once gives a pointer-sized handle with a stable ID, a precomputed hash
+ * and a precomputed JSON-escaped form, so the hot path can compare, hash and
+ * encode them without touching the characters again.
+ *
+ * Interned strings live for the rest of the process. Intern names and keys,
+ * never per-record values. The table is bounded (see
+ * StringInterner::set_capacity); strings arriving once it is full get an
+ * unpooled handle instead, which owns its own copy and is freed with its
+ * last handle.
+ *
+ * Example:
+ * @code
+ * InternedString key = StringInterner::intern("request_id");
+ * writer.key_escaped(key.escaped());
+ * @endcode
+ */
+class InternedString {
+public:
+    // id() of a string that did not fit in the table
+    static constexpr uint32_t UNPOOLED_ID = UINT32_MAX;
+
+    struct Entry {
+        std::string value;
+        std::string escaped; // JSON-escaped, without quotes
+        size_t hash;
+        uint32_t id;
+        mutable std::atomic<uint32_t> refs{0}; // Handles to an unpooled entry
+    };
+
+    // Empty string (ID 0)
+    InternedString();
+
+    InternedString(const InternedString& other) noexcept : entry_(other.entry_) { retain(); }
+    InternedString& operator=(const InternedString& other) noexcept {
+        other.retain();
+        release();
+        entry_ = other.entry_;
+        return *this;
+    }
+    ~InternedString() { release(); }
+
+    // Interning conversions, so existing std::string call sites keep working
+    InternedString(std::string_view str);
+    InternedString(const std::string& str) : InternedString(std::string_view(str)) {}
+    InternedString(const char* str) : InternedString(std::string_view(str ? str : "")) {}
+
+    const std::string& str() const { return entry_->value; }
+    std::string_view view() const { return entry_->value; }
+    const std::string& escaped() const { return entry_->escaped; }
+    const char* c_str() const { return entry_->value.c_str(); }
+    uint32_t id() const { return entry_->id; }
+    size_t hash() const { return entry_->hash; }
+    bool pooled() const { return entry_->id != UNPOOLED_ID; }
+    bool empty() const { return entry_->value.empty(); }
+    size_t size() const { return entry_->value.size(); }
+
+    operator const std::string&() const { return entry_->value; }
+
+    // One table entry per distinct string, so identity is equality unless
+    // either side overflowed the table
+    bool operator==(const InternedString& other) const {
+        if (entry_ == other.entry_) return true;
+        if (entry_->id != UNPOOLED_ID && other.entry_->id != UNPOOLED_ID) return false;
+        return entry_->value == other.entry_->value;
+    }
+
+    // Exact overloads: each of these types also converts to both
+    // InternedString and std::string_view. C++20 derives != and the
+    // reversed forms.
+    bool operator==(std::string_view other) const { return view() == other; }
+    bool operator==(const std::string& other) const { return view() == other; }
+    bool operator==(const char* other) const { return view() == std::string_view(other ? other : ""); }
+
+    struct Hash {
+        size_t operator()(const InternedString& s) const { return s.hash(); }
+    };
+
+private:
+    friend class StringInterner;
+    // Adopts the caller's reference to an unpooled entry
+    explicit InternedString(const Entry* entry) : entry_(entry) {}
+
+    void retain() const {
+        if (entry_->id == UNPOOLED_ID) entry_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+    void release() const {
+        if (entry_->id == UNPOOLED_ID) release_unpooled();
+    }
+    void release_unpooled() const;
+
+    const Entry* entry_;
+};
+
+/**
+ * @brief Process-wide intern table
+ *
+ * Lookups first check a small per-thread cache keyed by the caller's
+ * character pointer, so interning a string literal or a long-lived
+ * std::string (e.g. a logger name) again costs a pointer compare and a
+ * memcmp instead of a hash and a shared lock.
+ */
+class StringInterner {
+public:
+    static InternedString intern(std::string_view str);
+
+    /**
+     * @brief Look up an already interned string without adding it
+     * @return true and sets @p out if the string is interned
+     */
+    static bool find(std::string_view str, InternedString& out);
+
+    /**
+     * @brief Resolve an ID returned by InternedString::id()
+     *
+     * Unknown IDs, including UNPOOLED_ID, resolve to the empty string.
+     */
+    static InternedString from_id(uint32_t id);
+
+    static size_t size();
+
+    /**
+     * @brief Limit the number of distinct strings the table holds (v1.1.3)
+     *
+     * Interning a new string once the table is full returns an unpooled
+     * handle: it compares by text, reports UNPOOLED_ID and is not cached, so
+     * keys built at runtime cost an allocation per handle instead of growing
+     * the table forever. Defaults to DEFAULT_CAPACITY; lowering it never
+     * evicts strings already interned.
+     */
+    static void set_capacity(size_t max_strings);
+    static size_t capacity();
+
+    static constexpr size_t DEFAULT_CAPACITY = 65536;
+
+private:
+    static const InternedString::Entry* lookup(std::string_view str, bool insert);
+    static const InternedString::Entry* empty_entry();
+    friend class InternedString;
+};
+
+}
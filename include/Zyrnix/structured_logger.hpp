@@ -1,6 +1,8 @@
 #pragma once
 #include "logger.hpp"
 #include "sinks/structured_json_sink.hpp"
+#include "log_field.hpp"
+#include <initializer_list>
 #include <map>
 #include <memory>
 
@@ -21,12 +23,32 @@ public:
     void clear_context();
     
    
-    void trace(const std::string& message, const std::map<std::string, std::string>& fields = {});
-    void debug(const std::string& message, const std::map<std::string, std::string>& fields = {});
-    void info(const std::string& message, const std::map<std::string, std::string>& fields = {});
-    void warn(const std::string& message, const std::map<std::string, std::string>& fields = {});
-    void error(const std::string& message, const std::map<std::string, std::string>& fields = {});
-    void critical(const std::string& message, const std::map<std::string, std::string>& fields = {});
+    /**
+     * @brief Log with typed fields (v1.1.3)
+     *
+     * Field values keep their type (int, double, bool, string) through to the
+     * JSON encoder, and the braced list lives on the stack, so no map or
+     * std::to_string allocations are needed:
+     * @code
+     * slog->info("Request served", {{"status", 200}, {"latency_ms", 12.5}, {"cached", true}});
+     * @endcode
+     */
+    void trace(const std::string& message, std::initializer_list<Field> fields = {});
+    void debug(const std::string& message, std::initializer_list<Field> fields = {});
+    void info(const std::string& message, std::initializer_list<Field> fields = {});
+    void warn(const std::string& message, std::initializer_list<Field> fields = {});
+    void error(const std::string& message, std::initializer_list<Field> fields = {});
+    void critical(const std::string& message, std::initializer_list<Field> fields = {});
+
+    void log(LogLevel level, const std::string& message, FieldSpan fields);
+
+    // String-map overloads kept for existing callers; values are written as JSON strings
+    void trace(const std::string& message, const std::map<std::string, std::string>& fields);
+    void debug(const std::string& message, const std::map<std::string, std::string>& fields);
+    void info(const std::string& message, const std::map<std::string, std::string>& fields);
+    void warn(const std::string& message, const std::map<std::string, std::string>& fields);
+    void error(const std::string& message, const std::map<std::string, std::string>& fields);
+    void critical(const std::string& message, const std::map<std::string, std::string>& fields);
 
 private:
     std::shared_ptr<Logger> logger;
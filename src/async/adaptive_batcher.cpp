@@ -0,0 +1,51 @@
+#include "Zyrnix/async/adaptive_batcher.hpp"
+#include <algorithm>
+
+namespace Zyrnix {
+
+namespace {
+// Weight of the newest sample in the moving averages
+constexpr double EWMA_ALPHA = 0.2;
+}
+
+AdaptiveBatcher::AdaptiveBatcher(const AdaptiveBatchOptions& options)
+    : options_(options) {
+    if (options_.max_batch == 0) {
+        options_.max_batch = 1;
+    }
+}
+
+AdaptiveBatcher::Clock::time_point AdaptiveBatcher::deadline(Clock::time_point oldest) const {
+    double budget_us = static_cast<double>(options_.max_delay.count()) - write_us_;
+    if (budget_us <= 0.0) {
+        return oldest;
+    }
+    return oldest + std::chrono::microseconds(static_cast<int64_t>(budget_us));
+}
+
+void AdaptiveBatcher::on_batch(size_t records, Clock::time_point started, Clock::duration write_time) {
+    double write_us = std::chrono::duration<double, std::micro>(write_time).count();
+    write_us_ = write_us_ == 0.0 ? write_us : write_us_ + EWMA_ALPHA * (write_us - write_us_);
+
+    if (last_start_ != Clock::time_point{}) {
+        double interval_us = std::chrono::duration<double, std::micro>(started - last_start_).count();
+        if (interval_us > 0.0) {
+            double rate = static_cast<double>(records) / interval_us;
+            arrivals_per_us_ += EWMA_ALPHA * (rate - arrivals_per_us_);
+        }
+    }
+    last_start_ = started;
+
+    double budget_us = static_cast<double>(options_.max_delay.count()) - write_us_;
+    if (options_.max_delay.count() == 0) {
+        target_ = 1;
+    } else if (budget_us <= 0.0) {
+        // Writes alone exceed the budget: take everything, never linger
+        target_ = options_.max_batch;
+    } else {
+        double expected = arrivals_per_us_ * budget_us;
+        target_ = static_cast<size_t>(std::clamp(expected, 1.0, static_cast<double>(options_.max_batch)));
+    }
+}
+
+}
@@ -2,6 +2,8 @@
 #include "Zyrnix/logger.hpp"
 #include "Zyrnix/log_sink.hpp"
 #include "Zyrnix/formatter.hpp"
+#include "Zyrnix/log_metrics.hpp"
+#include <algorithm>
 
 namespace Zyrnix {
 
@@ -18,28 +20,29 @@ bool AsyncQueue::push(LogRecord&& record) {
         return false;
     }
     
+    auto now = std::chrono::steady_clock::now();
+    bool wake;
     {
         std::lock_guard<std::mutex> lock(mtx_);
-        queue_.push(std::move(record));
+        queue_.push_back(Entry{std::move(record), now});
+        size_.store(queue_.size(), std::memory_order_release);
+        // Lingering consumers only need waking once their target is queued
+        wake = sleepers_ > lingerers_ || (sleepers_ > 0 && queue_.size() >= wake_threshold_);
+    }
+    if (wake) {
+        cv_.notify_one();
     }
-    cv_.notify_one();
     return true;
 }
 
-bool AsyncQueue::pop(LogRecord& record) {
-    std::unique_lock<std::mutex> lock(mtx_);
-    
-    cv_.wait(lock, [this] {
-        return !queue_.empty() || shutdown_.load(std::memory_order_acquire);
-    });
-    
+bool AsyncQueue::take_locked(LogRecord& record) {
     if (queue_.empty()) {
         return false;
     }
     
-    record = std::move(queue_.front());
-    queue_.pop();
-    
+    record = std::move(queue_.front().record);
+    queue_.pop_front();
+    size_.store(queue_.size(), std::memory_order_release);
 
     if (queue_.empty()) {
         drain_cv_.notify_all();
@@ -48,6 +51,132 @@ bool AsyncQueue::pop(LogRecord& record) {
     return true;
 }
 
+bool AsyncQueue::wait_for_record(std::unique_lock<std::mutex>& lock) {
+    auto ready = [this] {
+        return !queue_.empty() || shutdown_.load(std::memory_order_acquire);
+    };
+    if (!ready()) {
+        ++sleepers_;
+        while (!ready()) {
+            if (wait_.block_timeout.count() > 0) {
+                cv_.wait_for(lock, wait_.block_timeout);
+            } else {
+                cv_.wait(lock);
+            }
+        }
+        --sleepers_;
+    }
+    return !queue_.empty();
+}
+
+bool AsyncQueue::pop(LogRecord& record) {
+    spin_until(wait_, [this] {
+        return size_.load(std::memory_order_acquire) > 0 || shutdown_.load(std::memory_order_acquire);
+    });
+
+    std::unique_lock<std::mutex> lock(mtx_);
+    wait_for_record(lock);
+    return take_locked(record);
+}
+
+bool AsyncQueue::try_pop(LogRecord& record) {
+    if (size_.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mtx_);
+    return take_locked(record);
+}
+
+bool AsyncQueue::pop_for(LogRecord& record, std::chrono::microseconds timeout) {
+    std::unique_lock<std::mutex> lock(mtx_);
+    ++sleepers_;
+    cv_.wait_for(lock, timeout, [this] {
+        return !queue_.empty() || shutdown_.load(std::memory_order_acquire);
+    });
+    --sleepers_;
+    return take_locked(record);
+}
+
+size_t AsyncQueue::consume_batch(std::vector<LogRecord>& batch, const BatchWriter& write) {
+    using Clock = std::chrono::steady_clock;
+    // Per consumer thread, reused across calls
+    thread_local std::vector<Clock::time_point> enqueued;
+
+    spin_until(wait_, [this] {
+        return size_.load(std::memory_order_acquire) > 0 || shutdown_.load(std::memory_order_acquire);
+    });
+
+    size_t n;
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        if (!wait_for_record(lock)) {
+            return 0;
+        }
+
+        size_t max_batch = batcher_.options().max_batch;
+        size_t target = std::min(batcher_.target(), max_batch);
+        if (queue_.size() < target && !shutdown_.load(std::memory_order_acquire)) {
+            auto deadline = batcher_.deadline(queue_.front().enqueued);
+            ++sleepers_;
+            ++lingerers_;
+            wake_threshold_ = target;
+            while (queue_.size() < target && !shutdown_.load(std::memory_order_acquire)) {
+                if (cv_.wait_until(lock, deadline) == std::cv_status::timeout) {
+                    break;
+                }
+            }
+            wake_threshold_ = 1;
+            --lingerers_;
+            --sleepers_;
+        }
+
+        n = std::min(queue_.size(), max_batch);
+        if (batch.size() < n) {
+            batch.resize(n);
+        }
+        enqueued.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            batch[i] = std::move(queue_.front().record);
+            enqueued[i] = queue_.front().enqueued;
+            queue_.pop_front();
+        }
+        size_.store(queue_.size(), std::memory_order_release);
+        if (queue_.empty()) {
+            drain_cv_.notify_all();
+        }
+    }
+
+    auto started = Clock::now();
+    write(std::span<const LogRecord>(batch.data(), n));
+    auto written = Clock::now();
+
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        batcher_.on_batch(n, started, written - started);
+    }
+    if (metrics_) {
+        metrics_->record_batch_size(n);
+        for (size_t i = 0; i < n; ++i) {
+            metrics_->record_enqueue_to_write_ns(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(written - enqueued[i]).count()));
+        }
+    }
+    return n;
+}
+
+void AsyncQueue::set_wait_options(const WaitOptions& options) {
+    wait_ = options;
+}
+
+void AsyncQueue::set_batching(const AdaptiveBatchOptions& options) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    batcher_ = AdaptiveBatcher(options);
+}
+
+void AsyncQueue::set_metrics(std::shared_ptr<LogMetrics> metrics) {
+    metrics_ = std::move(metrics);
+}
+
 bool AsyncQueue::empty() const {
     std::lock_guard<std::mutex> lock(mtx_);
     return queue_.empty();
@@ -59,7 +188,11 @@ size_t AsyncQueue::size() const {
 }
 
 bool AsyncQueue::shutdown(bool wait_for_drain) {
-    shutdown_.store(true, std::memory_order_release);
+    {
+        // Under the lock so a consumer between its check and its wait sees it
+        std::lock_guard<std::mutex> lock(mtx_);
+        shutdown_.store(true, std::memory_order_release);
+    }
     cv_.notify_all();
     
     if (!wait_for_drain) {
@@ -76,8 +209,9 @@ bool AsyncQueue::shutdown(bool wait_for_drain) {
     if (!drained) {
         dropped_count_.store(queue_.size(), std::memory_order_release);
         while (!queue_.empty()) {
-            queue_.pop();
+            queue_.pop_front();
         }
+        size_.store(0, std::memory_order_release);
     }
     
     return drained;
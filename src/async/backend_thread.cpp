@@ -0,0 +1,91 @@
+#include "Zyrnix/async/backend_thread.hpp"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#endif
+
+namespace Zyrnix {
+
+#ifdef __linux__
+namespace {
+
+// From <numaif.h>; set_mempolicy is called directly to avoid a libnuma dependency
+constexpr int MPOL_PREFERRED_MODE = 1;
+
+// Parses a sysfs cpulist such as "0-3,8-11"
+std::vector<int> node_cpus(int node) {
+    std::vector<int> cpus;
+    std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    std::string list;
+    if (!std::getline(in, list)) {
+        return cpus;
+    }
+    std::stringstream ss(list);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        if (range.empty()) continue;
+        size_t dash = range.find('-');
+        try {
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        } catch (...) {
+            return {};
+        }
+    }
+    return cpus;
+}
+
+bool set_affinity(const std::vector<int>& cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+        CPU_SET(cpu, &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+bool prefer_node(int node) {
+    constexpr unsigned long BITS = sizeof(unsigned long) * 8;
+    if (node < 0 || static_cast<unsigned long>(node) >= BITS * 16) return false;
+    unsigned long mask[16] = {};
+    mask[node / BITS] = 1UL << (node % BITS);
+    return syscall(SYS_set_mempolicy, MPOL_PREFERRED_MODE, mask, BITS * 16) == 0;
+}
+
+}
+#endif
+
+bool configure_backend_thread(const BackendThreadOptions& options) {
+    bool ok = true;
+#ifdef __linux__
+    if (!options.name.empty()) {
+        std::string name = options.name.substr(0, 15);
+        ok &= pthread_setname_np(pthread_self(), name.c_str()) == 0;
+    }
+    if (options.numa_node >= 0) {
+        ok &= prefer_node(options.numa_node);
+        if (options.cpu < 0) {
+            std::vector<int> cpus = node_cpus(options.numa_node);
+            ok &= !cpus.empty() && set_affinity(cpus);
+        }
+    }
+    if (options.cpu >= 0) {
+        ok &= set_affinity({options.cpu});
+    }
+#else
+    ok = options.cpu < 0 && options.numa_node < 0;
+#endif
+    return ok;
+}
+
+}
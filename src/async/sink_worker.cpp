@@ -0,0 +1,160 @@
+#include "Zyrnix/async/sink_worker.hpp"
+#include "Zyrnix/log_metrics.hpp"
+#include <chrono>
+#include <span>
+
+namespace Zyrnix {
+
+SinkWorker::SinkWorker(LogSinkPtr sink, const std::string& metrics_name,
+                       const SinkQueueOptions& options,
+                       std::shared_ptr<LogMetrics> logger_metrics)
+    : sink_(std::move(sink))
+    , options_(options)
+    , metrics_(MetricsRegistry::instance().get_sink_metrics(metrics_name))
+    , logger_metrics_(std::move(logger_metrics)) {
+    if (options_.capacity == 0) {
+        options_.capacity = 1;
+    }
+    thread_ = std::thread([this] { run(); });
+}
+
+SinkWorker::~SinkWorker() {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        stop_.store(true, std::memory_order_release);
+    }
+    not_empty_.notify_all();
+    not_full_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void SinkWorker::record_drop() {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    metrics_->record_drop();
+}
+
+bool SinkWorker::submit(RecordPtr record) {
+    bool accepted = true;
+    size_t depth;
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        if (queue_.size() >= options_.capacity) {
+            switch (options_.overflow) {
+                case OverflowPolicy::Block:
+                    not_full_.wait(lock, [this] { return queue_.size() < options_.capacity || stop_; });
+                    break;
+                case OverflowPolicy::DropNewest:
+                    lock.unlock();
+                    record_drop();
+                    return false;
+                case OverflowPolicy::DropOldest:
+                    queue_.pop_front();
+                    record_drop();
+                    accepted = false;
+                    break;
+            }
+        }
+        if (stop_.load(std::memory_order_relaxed)) {
+            // Shutting down: the worker may already have drained its last
+            // batch, so the record would never be written
+            lock.unlock();
+            record_drop();
+            return false;
+        }
+        queue_.push_back(std::move(record));
+        depth = queue_.size();
+        pending_.store(depth, std::memory_order_release);
+    }
+    metrics_->update_queue_depth(depth);
+    // worker_blocked_ is set under mtx_ before the worker's last emptiness check
+    if (worker_blocked_.load(std::memory_order_seq_cst)) {
+        not_empty_.notify_one();
+    }
+    return accepted;
+}
+
+void SinkWorker::wait_idle() {
+    std::unique_lock<std::mutex> lock(mtx_);
+    idle_.wait(lock, [this] { return (queue_.empty() && !writing_) || stop_; });
+}
+
+size_t SinkWorker::depth() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return queue_.size();
+}
+
+void SinkWorker::run() {
+    configure_backend_thread(options_.backend);
+    const WaitOptions& wait = options_.backend.wait;
+    auto has_work = [this] {
+        return pending_.load(std::memory_order_acquire) > 0 || stop_.load(std::memory_order_acquire);
+    };
+
+    std::deque<RecordPtr> batch;
+    // The shared records themselves go to the sink, no copies; the vector
+    // keeps its capacity, so steady state does not allocate
+    std::vector<const LogRecord*> records;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            writing_ = false;
+            if (queue_.empty()) {
+                idle_.notify_all();
+                if (wait.policy != WaitPolicy::Block) {
+                    lock.unlock();
+                    spin_until(wait, has_work);
+                    lock.lock();
+                }
+            }
+            if (queue_.empty() && !stop_) {
+                worker_blocked_.store(true, std::memory_order_seq_cst);
+                while (queue_.empty() && !stop_) {
+                    if (wait.block_timeout.count() > 0) {
+                        not_empty_.wait_for(lock, wait.block_timeout);
+                    } else {
+                        not_empty_.wait(lock);
+                    }
+                }
+                worker_blocked_.store(false, std::memory_order_relaxed);
+            }
+            if (queue_.empty()) {
+                return; // stop_ and fully drained
+            }
+            batch.swap(queue_);
+            pending_.store(0, std::memory_order_relaxed);
+            writing_ = true;
+        }
+        not_full_.notify_all();
+        metrics_->update_queue_depth(0);
+
+        records.clear();
+        for (const auto& record : batch) {
+            records.push_back(record.get());
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        try {
+            sink_->log_batch(std::span<const LogRecord* const>(records.data(), records.size()));
+            for (const LogRecord* record : records) {
+                metrics_->record_write(record->message.size());
+            }
+        } catch (...) {
+            metrics_->record_error();
+            if (logger_metrics_) {
+                logger_metrics_->record_sink_error();
+            }
+        }
+        metrics_->record_write_duration(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count()));
+
+        // Dropping the references lets the records (and the context
+        // snapshots they pin) go as soon as every sink has written them
+        records.clear();
+        batch.clear();
+    }
+}
+
+}
@@ -0,0 +1,131 @@
+#include "Zyrnix/async/task.hpp"
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace Zyrnix {
+namespace detail {
+
+namespace {
+
+// Blocks move between a thread's cache and the shared depot in chains of
+// this many, so producer/consumer pairs (one thread allocates, a worker
+// frees) recycle blocks with one lock per chain instead of a malloc each
+constexpr uint32_t CHAIN_LENGTH = 64;
+constexpr uint32_t MAX_CACHED_BLOCKS = 2 * CHAIN_LENGTH;
+constexpr size_t MAX_DEPOT_CHAINS = 64;
+
+constexpr std::align_val_t BLOCK_ALIGN{alignof(std::max_align_t)};
+
+struct FreeBlock {
+    FreeBlock* next;
+};
+
+struct Depot {
+    Depot() { chains.reserve(MAX_DEPOT_CHAINS); }
+
+    std::mutex mtx;
+    std::vector<FreeBlock*> chains; // each CHAIN_LENGTH blocks long
+};
+
+Depot& depot() {
+    static Depot* instance = new Depot(); // leaked: used during thread exit
+    return *instance;
+}
+
+// Trivially destructible so it stays usable after the thread's
+// destructors ran (a task freed during static destruction)
+struct BlockCache {
+    FreeBlock* head;
+    uint32_t count;
+    bool closed;
+};
+
+thread_local BlockCache block_cache{nullptr, 0, false};
+
+void free_chain(FreeBlock* block) {
+    while (block) {
+        FreeBlock* next = block->next;
+        ::operator delete(block, BLOCK_ALIGN);
+        block = next;
+    }
+}
+
+struct BlockCacheReleaser {
+    ~BlockCacheReleaser() {
+        free_chain(block_cache.head);
+        block_cache.head = nullptr;
+        block_cache.count = 0;
+        block_cache.closed = true;
+    }
+};
+
+thread_local BlockCacheReleaser block_cache_releaser;
+
+// Detaches CHAIN_LENGTH blocks from the front of the cache
+FreeBlock* take_chain(BlockCache& cache) {
+    FreeBlock* head = cache.head;
+    FreeBlock* tail = head;
+    for (uint32_t i = 1; i < CHAIN_LENGTH; ++i) {
+        tail = tail->next;
+    }
+    cache.head = tail->next;
+    cache.count -= CHAIN_LENGTH;
+    tail->next = nullptr;
+    return head;
+}
+
+}
+
+void* allocate_task_block(size_t size) {
+    if (size > TASK_BLOCK_SIZE) {
+        return ::operator new(size, BLOCK_ALIGN);
+    }
+    BlockCache& cache = block_cache;
+    if (!cache.head && !cache.closed) {
+        Depot& d = depot();
+        std::lock_guard<std::mutex> lock(d.mtx);
+        if (!d.chains.empty()) {
+            cache.head = d.chains.back();
+            cache.count = CHAIN_LENGTH;
+            d.chains.pop_back();
+        }
+    }
+    if (cache.head) {
+        FreeBlock* block = cache.head;
+        cache.head = block->next;
+        --cache.count;
+        return block;
+    }
+    return ::operator new(TASK_BLOCK_SIZE, BLOCK_ALIGN);
+}
+
+void deallocate_task_block(void* block, size_t size) noexcept {
+    BlockCache& cache = block_cache;
+    if (size > TASK_BLOCK_SIZE || cache.closed) {
+        ::operator delete(block, BLOCK_ALIGN);
+        return;
+    }
+    (void)&block_cache_releaser; // registers the thread exit cleanup
+
+    FreeBlock* free_block = static_cast<FreeBlock*>(block);
+    free_block->next = cache.head;
+    cache.head = free_block;
+    ++cache.count;
+
+    if (cache.count >= MAX_CACHED_BLOCKS) {
+        FreeBlock* chain = take_chain(cache);
+        Depot& d = depot();
+        {
+            std::lock_guard<std::mutex> lock(d.mtx);
+            if (d.chains.size() < MAX_DEPOT_CHAINS) {
+                d.chains.push_back(chain);
+                chain = nullptr;
+            }
+        }
+        free_chain(chain);
+    }
+}
+
+}
+}
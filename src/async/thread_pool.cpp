@@ -2,6 +2,7 @@
 #include "Zyrnix/logger.hpp"
 #include "Zyrnix/log_sink.hpp"
 #include "Zyrnix/async/async_logger.hpp"
+#include "Zyrnix/log_context.hpp"
 
 namespace Zyrnix {
 
@@ -17,7 +18,7 @@ ThreadPool::~ThreadPool() {
     for (auto& t : workers) if (t.joinable()) t.join();
 }
 
-void ThreadPool::enqueue(std::function<void()> task) {
+void ThreadPool::enqueue(Task task) {
     {
         std::lock_guard<std::mutex> lock(mtx);
         tasks.push(std::move(task));
@@ -25,9 +26,35 @@ void ThreadPool::enqueue(std::function<void()> task) {
     cv.notify_one();
 }
 
+void ThreadPool::enqueue(Task task, bool capture_context) {
+    if (!capture_context) {
+        enqueue(std::move(task));
+        return;
+    }
+    enqueue([context = LogContext::snapshot(), task = std::move(task)]() mutable {
+        ContextScope scope(context);
+        task();
+    });
+}
+
+void ThreadPool::enqueue_batch(std::span<Task> batch) {
+    if (batch.empty()) return;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        for (auto& task : batch) {
+            tasks.push(std::move(task));
+        }
+    }
+    if (batch.size() == 1) {
+        cv.notify_one();
+    } else {
+        cv.notify_all();
+    }
+}
+
 void ThreadPool::worker() {
     while (running) {
-        std::function<void()> task;
+        Task task;
         {
             std::unique_lock<std::mutex> lock(mtx);
             cv.wait(lock, [this]{ return !tasks.empty() || !running; });
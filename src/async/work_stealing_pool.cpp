@@ -0,0 +1,403 @@
+#include "Zyrnix/async/work_stealing_pool.hpp"
+#include "Zyrnix/async/spin_wait.hpp"
+#include "Zyrnix/log_context.hpp"
+
+namespace Zyrnix {
+
+namespace {
+
+using TaskPtr = Task*;
+
+constexpr int SPIN_ROUNDS = 64;
+constexpr size_t INJECTION_BATCH = 32;
+
+// Chase-Lev work-stealing deque (Le, Pop, Cohen, Zappa Nardelli, PPoPP'13
+// memory orderings). The owner pushes and pops at the bottom, thieves take
+// from the top. Grown arrays are retired, not freed, until the deque dies:
+// a thief may still be reading the old one. Slots are release/acquire on
+// top of the paper's fences (free on x86) so the task handoff is also
+// visible to ThreadSanitizer, which does not model fences.
+class ChaseLevDeque {
+public:
+    ChaseLevDeque() {
+        retired_.push_back(std::make_unique<Ring>(64));
+        ring_.store(retired_.back().get(), std::memory_order_relaxed);
+    }
+
+    ~ChaseLevDeque() {
+        Ring* ring = ring_.load(std::memory_order_relaxed);
+        int64_t top = top_.load(std::memory_order_relaxed);
+        int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        for (int64_t i = top; i < bottom; ++i) {
+            Task* task = ring->get(i);
+            task->~Task();
+            detail::deallocate_task_block(task, sizeof(Task));
+        }
+    }
+
+    // Owner only
+    void push(TaskPtr task) {
+        int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        int64_t top = top_.load(std::memory_order_acquire);
+        Ring* ring = ring_.load(std::memory_order_relaxed);
+        if (bottom - top > static_cast<int64_t>(ring->capacity) - 1) {
+            ring = grow(ring, top, bottom);
+        }
+        ring->put(bottom, task);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    // Owner only
+    TaskPtr pop() {
+        int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        Ring* ring = ring_.load(std::memory_order_relaxed);
+        bottom_.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = top_.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        TaskPtr task = ring->get(bottom);
+        if (top == bottom) {
+            // Last element: race the thieves for it
+            if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                              std::memory_order_relaxed)) {
+                task = nullptr;
+            }
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+
+    // Any thread
+    TaskPtr steal() {
+        int64_t top = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t bottom = bottom_.load(std::memory_order_acquire);
+        if (top >= bottom) {
+            return nullptr;
+        }
+        Ring* ring = ring_.load(std::memory_order_acquire);
+        TaskPtr task = ring->get(top);
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return task;
+    }
+
+    bool empty() const {
+        return top_.load(std::memory_order_relaxed) >= bottom_.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Ring {
+        explicit Ring(size_t cap)
+            : capacity(cap), mask(cap - 1), slots(new std::atomic<TaskPtr>[cap]) {}
+
+        TaskPtr get(int64_t i) const {
+            return slots[static_cast<size_t>(i) & mask].load(std::memory_order_acquire);
+        }
+        void put(int64_t i, TaskPtr task) {
+            slots[static_cast<size_t>(i) & mask].store(task, std::memory_order_release);
+        }
+
+        size_t capacity;
+        size_t mask;
+        std::unique_ptr<std::atomic<TaskPtr>[]> slots;
+    };
+
+    Ring* grow(Ring* old, int64_t top, int64_t bottom) {
+        retired_.push_back(std::make_unique<Ring>(old->capacity * 2));
+        Ring* ring = retired_.back().get();
+        for (int64_t i = top; i < bottom; ++i) {
+            ring->put(i, old->get(i));
+        }
+        ring_.store(ring, std::memory_order_release);
+        return ring;
+    }
+
+    alignas(64) std::atomic<int64_t> top_{0};
+    alignas(64) std::atomic<int64_t> bottom_{0};
+    std::atomic<Ring*> ring_{nullptr};
+    std::vector<std::unique_ptr<Ring>> retired_; // owner only
+};
+
+thread_local WorkStealingThreadPool* current_pool = nullptr;
+thread_local size_t current_index = 0;
+
+}
+
+struct WorkStealingThreadPool::Worker {
+    ChaseLevDeque deque;
+    std::thread thread;
+    uint64_t rng = 0;
+};
+
+WorkStealingThreadPool::WorkStealingThreadPool(size_t threads) {
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+        if (threads == 0) threads = 2;
+    }
+    workers_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+        workers_.back()->rng = 0x9E3779B97F4A7C15ull * (i + 1);
+    }
+    // Started only once every deque exists, since workers steal from all of them
+    for (size_t i = 0; i < threads; ++i) {
+        workers_[i]->thread = std::thread([this, i] { worker_loop(i); });
+    }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    stopping_.store(true, std::memory_order_seq_cst);
+    {
+        std::lock_guard<std::mutex> lock(park_mtx_);
+        park_cv_.notify_all();
+    }
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) worker->thread.join();
+    }
+    for (TaskPtr task : injection_) {
+        free_node(task);
+    }
+}
+
+WorkStealingThreadPool& WorkStealingThreadPool::instance() {
+    // Leaked so sinks destroyed during static destruction can still wait
+    // for their background work
+    static WorkStealingThreadPool* pool = new WorkStealingThreadPool();
+    return *pool;
+}
+
+Task* WorkStealingThreadPool::make_node(Task&& task) {
+    // Nodes come from the task block cache: no malloc per task in steady state
+    static_assert(sizeof(Task) <= detail::TASK_BLOCK_SIZE);
+    return ::new (detail::allocate_task_block(sizeof(Task))) Task(std::move(task));
+}
+
+void WorkStealingThreadPool::free_node(Task* node) noexcept {
+    node->~Task();
+    detail::deallocate_task_block(node, sizeof(Task));
+}
+
+void WorkStealingThreadPool::enqueue(Task task) {
+    TaskPtr item = make_node(std::move(task));
+    if (current_pool == this) {
+        workers_[current_index]->deque.push(item);
+    } else {
+        std::lock_guard<std::mutex> lock(injection_mtx_);
+        injection_.push_back(item);
+        injection_size_.fetch_add(1, std::memory_order_relaxed);
+    }
+    pending_.fetch_add(1, std::memory_order_seq_cst);
+    wake(1);
+}
+
+void WorkStealingThreadPool::enqueue_batch(std::span<Task> tasks) {
+    if (tasks.empty()) return;
+    if (current_pool == this) {
+        Worker* self = workers_[current_index].get();
+        for (auto& task : tasks) {
+            self->deque.push(make_node(std::move(task)));
+        }
+    } else {
+        std::lock_guard<std::mutex> lock(injection_mtx_);
+        for (auto& task : tasks) {
+            injection_.push_back(make_node(std::move(task)));
+        }
+        injection_size_.fetch_add(tasks.size(), std::memory_order_relaxed);
+    }
+    pending_.fetch_add(static_cast<int64_t>(tasks.size()), std::memory_order_seq_cst);
+    wake(tasks.size());
+}
+
+void WorkStealingThreadPool::enqueue(Task task, bool capture_context) {
+    if (!capture_context) {
+        enqueue(std::move(task));
+        return;
+    }
+    enqueue([context = LogContext::snapshot(), task = std::move(task)]() mutable {
+        ContextScope scope(context);
+        task();
+    });
+}
+
+size_t WorkStealingThreadPool::pending() const {
+    int64_t n = pending_.load(std::memory_order_relaxed);
+    return n > 0 ? static_cast<size_t>(n) : 0;
+}
+
+void WorkStealingThreadPool::wake(size_t count) {
+    // Pairs with the seq_cst sleepers_ increment in worker_loop: either the
+    // parking worker sees pending_ > 0, or we see it as a sleeper
+    size_t sleepers = sleepers_.load(std::memory_order_seq_cst);
+    if (sleepers == 0) return;
+    std::lock_guard<std::mutex> lock(park_mtx_);
+    if (count >= sleepers) {
+        park_cv_.notify_all();
+    } else {
+        for (size_t i = 0; i < count; ++i) park_cv_.notify_one();
+    }
+}
+
+bool WorkStealingThreadPool::try_run_one() {
+    TaskPtr task = nullptr;
+    if (current_pool == this) {
+        task = find_task(current_index);
+    } else {
+        task = take_injected(nullptr);
+        if (!task) task = steal(workers_.size());
+    }
+    if (!task) {
+        return false;
+    }
+    pending_.fetch_sub(1, std::memory_order_relaxed);
+    run(task);
+    return true;
+}
+
+Task* WorkStealingThreadPool::take_injected(Worker* worker) {
+    if (injection_size_.load(std::memory_order_relaxed) == 0) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(injection_mtx_);
+    if (injection_.empty()) {
+        return nullptr;
+    }
+    TaskPtr task = injection_.front();
+    injection_.pop_front();
+    size_t taken = 1;
+
+    // A worker moves a share of the backlog to its own deque, where other
+    // workers can steal it without touching the injection lock
+    if (worker) {
+        size_t batch = std::min(INJECTION_BATCH, injection_.size() / workers_.size());
+        for (size_t i = 0; i < batch; ++i) {
+            worker->deque.push(injection_.front());
+            injection_.pop_front();
+        }
+        taken += batch;
+    }
+    injection_size_.fetch_sub(taken, std::memory_order_relaxed);
+    return task;
+}
+
+Task* WorkStealingThreadPool::steal(size_t thief) {
+    size_t count = workers_.size();
+    uint64_t r;
+    if (thief < count) {
+        // xorshift64, per worker
+        uint64_t& s = workers_[thief]->rng;
+        s ^= s << 13;
+        s ^= s >> 7;
+        s ^= s << 17;
+        r = s;
+    } else {
+        r = reinterpret_cast<uintptr_t>(&r) >> 4;
+    }
+    size_t start = static_cast<size_t>(r % count);
+    for (size_t i = 0; i < count; ++i) {
+        size_t victim = (start + i) % count;
+        if (victim == thief) continue;
+        if (TaskPtr task = workers_[victim]->deque.steal()) {
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+Task* WorkStealingThreadPool::find_task(size_t index) {
+    Worker* self = workers_[index].get();
+    if (TaskPtr task = self->deque.pop()) return task;
+    if (TaskPtr task = take_injected(self)) return task;
+    return steal(index);
+}
+
+void WorkStealingThreadPool::run(Task* task) {
+    try {
+        (*task)();
+    } catch (...) {
+        // A throwing task must not take the worker down
+    }
+    free_node(task);
+}
+
+void WorkStealingThreadPool::worker_loop(size_t index) {
+    current_pool = this;
+    current_index = index;
+
+    while (true) {
+        TaskPtr task = find_task(index);
+        for (int spin = 0; !task && spin < SPIN_ROUNDS; ++spin) {
+            if (pending_.load(std::memory_order_relaxed) <= 0) {
+                cpu_relax();
+                continue;
+            }
+            task = find_task(index);
+        }
+        if (task) {
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+            run(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(park_mtx_);
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        park_cv_.wait(lock, [this] {
+            return pending_.load(std::memory_order_seq_cst) > 0 ||
+                   stopping_.load(std::memory_order_relaxed);
+        });
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+        if (stopping_.load(std::memory_order_relaxed) &&
+            pending_.load(std::memory_order_seq_cst) <= 0) {
+            return;
+        }
+    }
+}
+
+bool WorkStealingThreadPool::is_worker_thread() const {
+    return current_pool == this;
+}
+
+void TaskGroup::run(Task task) {
+    outstanding_.fetch_add(1, std::memory_order_relaxed);
+    pool_.enqueue([this, task = std::move(task)]() mutable {
+        struct Done {
+            TaskGroup& group;
+            ~Done() { group.finish_one(); }
+        } done{*this};
+        task();
+    });
+}
+
+void TaskGroup::finish_one() {
+    std::lock_guard<std::mutex> lock(done_mtx_);
+    if (outstanding_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        done_cv_.notify_all();
+    }
+}
+
+void TaskGroup::wait() {
+    if (pool_.is_worker_thread()) {
+        int idle = 0;
+        while (!done()) {
+            if (pool_.try_run_one()) {
+                idle = 0;
+            } else if (++idle < 64) {
+                cpu_relax();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+    // Also taken after helping: returns only once the last finish_one() has unlocked
+    std::unique_lock<std::mutex> lock(done_mtx_);
+    done_cv_.wait(lock, [this] { return done(); });
+}
+
+}
@@ -1,6 +1,8 @@
 #include "Zyrnix/formatter.hpp"
 #include "Zyrnix/log_level.hpp"
+#include "Zyrnix/log_record.hpp"
 #include <chrono>
+#include <ctime>
 #include <iomanip>
 #include <sstream>
 
@@ -18,6 +20,28 @@ std::string Formatter::format(const std::string& logger_name, LogLevel level, co
     return ss.str();
 }
 
+void Formatter::format_to(std::string& out, const LogRecord& record) {
+    thread_local std::time_t cached_second = -1;
+    thread_local char cached_text[32];
+    thread_local size_t cached_len = 0;
+
+    std::time_t t = std::chrono::system_clock::to_time_t(record.timestamp);
+    if (t != cached_second) {
+        std::tm buf;
+        localtime_r(&t, &buf);
+        cached_len = std::strftime(cached_text, sizeof(cached_text), "%Y-%m-%d %H:%M:%S", &buf);
+        cached_second = t;
+    }
+
+    out.append(cached_text, cached_len);
+    out += " [";
+    out += to_string_view(record.level);
+    out += "] ";
+    out += record.logger_name.view();
+    out += ": ";
+    out += record.message;
+}
+
 std::string Formatter::redact(const std::string& message, const std::vector<std::string>& patterns) {
     std::string redacted = message;
     for (const auto& pat : patterns) {
@@ -0,0 +1,205 @@
+#include "Zyrnix/json_writer.hpp"
+#include <cstring>
+#include <charconv>
+#include <cmath>
+
+namespace Zyrnix {
+
+namespace {
+
+constexpr char hex_digits[] = "0123456789abcdef";
+
+inline bool needs_escape(unsigned char c) {
+    return c < 0x20 || c == '"' || c == '\\';
+}
+
+inline void append_2digits(std::string& out, unsigned v) {
+    out.push_back(static_cast<char>('0' + v / 10));
+    out.push_back(static_cast<char>('0' + v % 10));
+}
+
+inline void write_2digits(char* p, unsigned v) {
+    p[0] = static_cast<char>('0' + v / 10);
+    p[1] = static_cast<char>('0' + v % 10);
+}
+
+}
+
+void append_json_escaped(std::string& out, std::string_view str) {
+    const char* p = str.data();
+    const char* end = p + str.size();
+    const char* run = p;
+
+    while (p != end) {
+        unsigned char c = static_cast<unsigned char>(*p);
+        if (!needs_escape(c)) {
+            ++p;
+            continue;
+        }
+
+        out.append(run, p - run);
+        switch (c) {
+            case '"': out.append("\\\"", 2); break;
+            case '\\': out.append("\\\\", 2); break;
+            case '\b': out.append("\\b", 2); break;
+            case '\f': out.append("\\f", 2); break;
+            case '\n': out.append("\\n", 2); break;
+            case '\r': out.append("\\r", 2); break;
+            case '\t': out.append("\\t", 2); break;
+            default: {
+                char esc[6] = {'\\', 'u', '0', '0', hex_digits[c >> 4], hex_digits[c & 0xF]};
+                out.append(esc, sizeof(esc));
+                break;
+            }
+        }
+        run = ++p;
+    }
+
+    out.append(run, end - run);
+}
+
+std::string json_escape(std::string_view str) {
+    std::string result;
+    result.reserve(str.size());
+    append_json_escaped(result, str);
+    return result;
+}
+
+JsonWriter::JsonWriter() {
+    buffer_.reserve(512);
+    std::memset(cached_prefix_, 0, sizeof(cached_prefix_));
+}
+
+void JsonWriter::separator() {
+    if (needs_comma_) {
+        buffer_.push_back(',');
+    }
+    needs_comma_ = true;
+}
+
+void JsonWriter::begin_object() {
+    buffer_.push_back('{');
+    needs_comma_ = false;
+}
+
+void JsonWriter::end_object() {
+    buffer_.push_back('}');
+    needs_comma_ = true;
+}
+
+void JsonWriter::key_escaped(std::string_view key) {
+    separator();
+    buffer_.push_back('"');
+    buffer_.append(key.data(), key.size());
+    buffer_.append("\":", 2);
+}
+
+void JsonWriter::key(std::string_view key) {
+    separator();
+    buffer_.push_back('"');
+    append_json_escaped(buffer_, key);
+    buffer_.append("\":", 2);
+}
+
+void JsonWriter::value_string(std::string_view value) {
+    buffer_.push_back('"');
+    append_json_escaped(buffer_, value);
+    buffer_.push_back('"');
+}
+
+void JsonWriter::value_string_escaped(std::string_view value) {
+    buffer_.push_back('"');
+    buffer_.append(value.data(), value.size());
+    buffer_.push_back('"');
+}
+
+void JsonWriter::value_int(int64_t value) {
+    char buf[24];
+    auto res = std::to_chars(buf, buf + sizeof(buf), value);
+    buffer_.append(buf, res.ptr);
+}
+
+void JsonWriter::value_uint(uint64_t value) {
+    char buf[24];
+    auto res = std::to_chars(buf, buf + sizeof(buf), value);
+    buffer_.append(buf, res.ptr);
+}
+
+void JsonWriter::value_double(double value) {
+    if (!std::isfinite(value)) {
+        value_null();
+        return;
+    }
+    char buf[32];
+    auto res = std::to_chars(buf, buf + sizeof(buf), value);
+    buffer_.append(buf, res.ptr);
+}
+
+void JsonWriter::value_bool(bool value) {
+    if (value) {
+        buffer_.append("true", 4);
+    } else {
+        buffer_.append("false", 5);
+    }
+}
+
+void JsonWriter::value_null() {
+    buffer_.append("null", 4);
+}
+
+void JsonWriter::value(const FieldValue& value) {
+    switch (value.type()) {
+        case FieldValue::Type::Null: value_null(); break;
+        case FieldValue::Type::Int: value_int(value.as_int()); break;
+        case FieldValue::Type::UInt: value_uint(value.as_uint()); break;
+        case FieldValue::Type::Double: value_double(value.as_double()); break;
+        case FieldValue::Type::Bool: value_bool(value.as_bool()); break;
+        case FieldValue::Type::String: value_string(value.as_string()); break;
+    }
+}
+
+void JsonWriter::value_timestamp(std::chrono::system_clock::time_point tp) {
+    auto since_epoch = tp.time_since_epoch();
+    auto secs = std::chrono::duration_cast<std::chrono::seconds>(since_epoch);
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(since_epoch - secs).count();
+    if (ms < 0) {
+        secs -= std::chrono::seconds(1);
+        ms += 1000;
+    }
+
+    std::time_t t = static_cast<std::time_t>(secs.count());
+    if (t != cached_second_) {
+        std::tm tm_buf;
+        gmtime_r(&t, &tm_buf);
+
+        unsigned year = static_cast<unsigned>(tm_buf.tm_year + 1900);
+        write_2digits(cached_prefix_, year / 100);
+        write_2digits(cached_prefix_ + 2, year % 100);
+        cached_prefix_[4] = '-';
+        write_2digits(cached_prefix_ + 5, static_cast<unsigned>(tm_buf.tm_mon + 1));
+        cached_prefix_[7] = '-';
+        write_2digits(cached_prefix_ + 8, static_cast<unsigned>(tm_buf.tm_mday));
+        cached_prefix_[10] = 'T';
+        write_2digits(cached_prefix_ + 11, static_cast<unsigned>(tm_buf.tm_hour));
+        cached_prefix_[13] = ':';
+        write_2digits(cached_prefix_ + 14, static_cast<unsigned>(tm_buf.tm_min));
+        cached_prefix_[16] = ':';
+        write_2digits(cached_prefix_ + 17, static_cast<unsigned>(tm_buf.tm_sec));
+        cached_prefix_[19] = '.';
+        cached_second_ = t;
+    }
+
+    buffer_.push_back('"');
+    buffer_.append(cached_prefix_, sizeof(cached_prefix_));
+    unsigned millis = static_cast<unsigned>(ms);
+    buffer_.push_back(static_cast<char>('0' + millis / 100));
+    append_2digits(buffer_, millis % 100);
+    buffer_.append("Z\"", 2);
+}
+
+void JsonWriter::append_raw(std::string_view json) {
+    buffer_.append(json.data(), json.size());
+    needs_comma_ = true;
+}
+
+}
@@ -1,36 +1,145 @@
 #include "Zyrnix/log_context.hpp"
 #include <algorithm>
+#include <atomic>
 
 namespace Zyrnix {
 
-thread_local LogContext::ContextMap LogContext::context_;
+namespace {
+
+const std::string* find_entry(const ContextSnapshot::Entries& entries, const InternedString& key) {
+    // Interned keys compare by pointer; contexts are small, so a linear scan
+    // beats hashing
+    for (const auto& entry : entries) {
+        if (entry.first == key) {
+            return &entry.second;
+        }
+    }
+    return nullptr;
+}
+
+const std::string* find_entry(const ContextSnapshot::Entries* entries, std::string_view key) {
+    if (!entries) {
+        return nullptr;
+    }
+    InternedString interned;
+    if (StringInterner::find(key, interned)) {
+        return find_entry(*entries, interned);
+    }
+    // Not in the table: only an unpooled key (table full) can match
+    for (const auto& entry : *entries) {
+        if (!entry.first.pooled() && entry.first == key) {
+            return &entry.second;
+        }
+    }
+    return nullptr;
+}
+
+}
+
+const std::string* ContextSnapshot::find(const InternedString& key) const {
+    return entries_ ? find_entry(*entries_, key) : nullptr;
+}
+
+const std::string* ContextSnapshot::find(std::string_view key) const {
+    return find_entry(entries_.get(), key);
+}
+
+std::string ContextSnapshot::get(std::string_view key) const {
+    const std::string* value = find(key);
+    return value ? *value : std::string();
+}
+
+std::unordered_map<std::string, std::string> ContextSnapshot::to_map() const {
+    std::unordered_map<std::string, std::string> all;
+    all.reserve(size());
+    for_each([&all](const InternedString& key, const std::string& value) {
+        all.emplace(key.str(), value);
+    });
+    return all;
+}
+
+const ContextSnapshot::Entries& ContextSnapshot::empty_entries() {
+    static const Entries empty;
+    return empty;
+}
+
+thread_local std::shared_ptr<ContextSnapshot::Entries> LogContext::entries_;
+
+ContextSnapshot::Entries& LogContext::mutable_entries() {
+    if (!entries_) {
+        entries_ = std::make_shared<ContextSnapshot::Entries>();
+    } else if (entries_.use_count() > 1) {
+        // A snapshot holds the current entries: copy before writing. Only
+        // this thread owns the pointer, so the count cannot grow meanwhile.
+        entries_ = std::make_shared<ContextSnapshot::Entries>(*entries_);
+    } else {
+        // Pairs with the release in the last snapshot's reference drop, so its
+        // reads happen before our writes
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    return *entries_;
+}
 
 void LogContext::set(const std::string& key, const std::string& value) {
-    context_[key] = value;
+    InternedString interned = StringInterner::intern(key);
+    auto& entries = mutable_entries();
+    for (auto& entry : entries) {
+        if (entry.first == interned) {
+            entry.second = value;
+            return;
+        }
+    }
+    entries.emplace_back(interned, value);
 }
 
 std::string LogContext::get(const std::string& key) {
-    auto it = context_.find(key);
-    if (it != context_.end()) {
-        return it->second;
-    }
-    return "";
+    const std::string* value = find(key);
+    return value ? *value : std::string();
 }
 
 void LogContext::remove(const std::string& key) {
-    context_.erase(key);
+    if (!find_entry(entries_.get(), key)) {
+        return;
+    }
+
+    auto& entries = mutable_entries();
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        if (it->first == key) {
+            entries.erase(it);
+            return;
+        }
+    }
 }
 
 void LogContext::clear() {
-    context_.clear();
+    // Dropping the reference leaves any outstanding snapshot intact
+    entries_.reset();
 }
 
 LogContext::ContextMap LogContext::get_all() {
-    return context_;
+    return snapshot().to_map();
 }
 
 bool LogContext::contains(const std::string& key) {
-    return context_.find(key) != context_.end();
+    return find(key) != nullptr;
+}
+
+const std::string* LogContext::find(const InternedString& key) {
+    return entries_ ? find_entry(*entries_, key) : nullptr;
+}
+
+const std::string* LogContext::find(std::string_view key) {
+    return find_entry(entries_.get(), key);
+}
+
+ContextSnapshot LogContext::snapshot() {
+    return ContextSnapshot(entries_);
+}
+
+void LogContext::restore(const ContextSnapshot& snapshot) {
+    // Writes go through mutable_entries(), which copies while the snapshot
+    // is still shared, so the snapshot itself is never modified
+    entries_ = std::const_pointer_cast<ContextSnapshot::Entries>(snapshot.entries_);
 }
 
 ScopedContext::ScopedContext() = default;
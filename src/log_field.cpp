@@ -0,0 +1,159 @@
+#include "Zyrnix/log_field.hpp"
+#include <charconv>
+#include <cmath>
+
+namespace Zyrnix {
+
+void FieldValue::append_text(std::string& out) const {
+    char buf[32];
+    switch (type_) {
+        case Type::Null:
+            break;
+        case Type::Int: {
+            auto res = std::to_chars(buf, buf + sizeof(buf), int_);
+            out.append(buf, res.ptr);
+            break;
+        }
+        case Type::UInt: {
+            auto res = std::to_chars(buf, buf + sizeof(buf), uint_);
+            out.append(buf, res.ptr);
+            break;
+        }
+        case Type::Double: {
+            if (std::isnan(double_)) {
+                out += "nan";
+            } else if (std::isinf(double_)) {
+                out += double_ < 0 ? "-inf" : "inf";
+            } else {
+                auto res = std::to_chars(buf, buf + sizeof(buf), double_);
+                out.append(buf, res.ptr);
+            }
+            break;
+        }
+        case Type::Bool:
+            out += bool_ ? "true" : "false";
+            break;
+        case Type::String:
+            out.append(str_.data(), str_.size());
+            break;
+    }
+}
+
+std::string FieldValue::to_string() const {
+    std::string out;
+    append_text(out);
+    return out;
+}
+
+FieldSet::FieldSet(const FieldSet& other)
+    : keys_(other.keys_), offsets_(other.offsets_), fields_(other.fields_), arena_(other.arena_) {
+    rebind_strings();
+}
+
+FieldSet::FieldSet(FieldSet&& other) noexcept
+    : keys_(std::move(other.keys_)), offsets_(std::move(other.offsets_)),
+      fields_(std::move(other.fields_)), arena_(std::move(other.arena_)) {
+    rebind_strings(); // Short strings do not keep their address across a move
+}
+
+FieldSet& FieldSet::operator=(const FieldSet& other) {
+    if (this != &other) {
+        keys_ = other.keys_;
+        offsets_ = other.offsets_;
+        fields_ = other.fields_;
+        arena_ = other.arena_;
+        rebind_strings();
+    }
+    return *this;
+}
+
+FieldSet& FieldSet::operator=(FieldSet&& other) noexcept {
+    if (this != &other) {
+        keys_ = std::move(other.keys_);
+        offsets_ = std::move(other.offsets_);
+        fields_ = std::move(other.fields_);
+        arena_ = std::move(other.arena_);
+        rebind_strings();
+    }
+    return *this;
+}
+
+void FieldSet::rebind_strings() {
+    for (size_t i = 0; i < fields_.size(); ++i) {
+        if (offsets_[i] != NO_TEXT) {
+            size_t length = fields_[i].value.as_string().size();
+            fields_[i].value = FieldValue(std::string_view(arena_.data() + offsets_[i], length));
+        }
+    }
+}
+
+long FieldSet::index_of(std::string_view key) const {
+    for (size_t i = 0; i < fields_.size(); ++i) {
+        if (fields_[i].key == key) {
+            return static_cast<long>(i);
+        }
+    }
+    return -1;
+}
+
+void FieldSet::append_value(size_t index, const FieldValue& value) {
+    if (value.type() == FieldValue::Type::String) {
+        std::string_view str = value.as_string();
+        offsets_[index] = static_cast<uint32_t>(arena_.size());
+        arena_.append(str.data(), str.size());
+        // Temporarily records only the length; rebind_strings() sets the pointer
+        fields_[index].value = FieldValue(std::string_view(arena_.data(), str.size()));
+    } else {
+        offsets_[index] = NO_TEXT;
+        fields_[index].value = value;
+    }
+}
+
+void FieldSet::set(std::string_view key, const FieldValue& value) {
+    long index = index_of(key);
+    if (index < 0) {
+        index = static_cast<long>(fields_.size());
+        keys_.push_back(StringInterner::intern(key));
+        offsets_.push_back(NO_TEXT);
+        fields_.push_back(Field{keys_.back().view(), FieldValue()});
+    }
+    // A replaced string value stays in the arena until the next clear()
+    append_value(static_cast<size_t>(index), value);
+    rebind_strings();
+}
+
+void FieldSet::assign(FieldSpan fields) {
+    clear();
+
+    size_t text_size = 0;
+    for (const auto& field : fields) {
+        text_size += field.value.as_string().size();
+    }
+    arena_.reserve(text_size);
+    keys_.reserve(fields.size());
+    offsets_.reserve(fields.size());
+    fields_.reserve(fields.size());
+
+    for (const auto& field : fields) {
+        long index = index_of(field.key);
+        if (index < 0) {
+            index = static_cast<long>(fields_.size());
+            keys_.push_back(StringInterner::intern(field.key));
+            offsets_.push_back(NO_TEXT);
+            fields_.push_back(Field{keys_.back().view(), FieldValue()});
+        }
+        append_value(static_cast<size_t>(index), field.value);
+    }
+    rebind_strings();
+}
+
+FieldValue FieldSet::get(std::string_view key) const {
+    long index = index_of(key);
+    return index >= 0 ? fields_[static_cast<size_t>(index)].value : FieldValue();
+}
+
+bool FieldSet::contains(std::string_view key) const {
+    return index_of(key) >= 0;
+}
+
+}
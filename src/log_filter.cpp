@@ -1,5 +1,7 @@
 #include "Zyrnix/log_filter.hpp"
 #include "Zyrnix/log_context.hpp"
+#include <algorithm>
+#include <string_view>
 
 namespace Zyrnix {
 
@@ -10,13 +12,11 @@ bool LevelFilter::should_log(const LogRecord& record) const {
 }
 
 FieldFilter::FieldFilter(const std::string& field_name, const std::string& expected_value)
-    : field_name_(field_name), expected_value_(expected_value) {}
+    : field_name_(field_name), field_key_(field_name), expected_value_(expected_value) {}
 
 bool FieldFilter::should_log(const LogRecord& record) const {
-    auto context = LogContext::get_all();
-    auto it = context.find(field_name_);
-    if (it != context.end()) {
-        return it->second == expected_value_;
+    if (const std::string* value = record.context.find(field_key_)) {
+        return *value == expected_value_;
     }
     
     return record.get_field(field_name_) == expected_value_;
@@ -56,6 +56,200 @@ bool CompositeFilter::should_log(const LogRecord& record) const {
     }
 }
 
+bool CompositeFilter::commit(const LogRecord& record) const {
+    if (filters_.empty()) {
+        return true;
+    }
+
+    if (mode_ == Mode::AND) {
+        for (const auto& filter : filters_) {
+            if (!filter->commit(record)) {
+                return false;
+            }
+        }
+        return true;
+    } else {
+        // Only a member that accepted the record may take it
+        for (const auto& filter : filters_) {
+            if (filter->should_log(record) && filter->commit(record)) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+void CompositeFilter::take_pending_records(const LogRecord& passed, std::vector<LogRecord>& out) const {
+    for (const auto& filter : filters_) {
+        filter->take_pending_records(passed, out);
+    }
+}
+
+void CompositeFilter::flush_pending_records(std::vector<LogRecord>& out) const {
+    for (const auto& filter : filters_) {
+        filter->flush_pending_records(out);
+    }
+}
+
+namespace {
+
+int64_t to_ns(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+uint64_t dedup_key(const LogRecord& record) {
+    uint64_t x = std::hash<std::string_view>{}(record.message);
+    x ^= record.logger_name.hash() + 0x9e3779b97f4a7c15ULL + (x << 6) + (x >> 2);
+    x += static_cast<uint64_t>(record.level);
+    // splitmix64 finalizer, so the low bits picking the slot are well mixed
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x | 1; // 0 marks an empty slot
+}
+
+}
+
+DedupFilter::DedupFilter(const DedupFilterOptions& options)
+    : options_(options)
+    , window_ns_(std::max<int64_t>(1,
+          std::chrono::duration_cast<std::chrono::nanoseconds>(options.window).count())) {
+    size_t size = PROBES;
+    while (size < options_.table_size) {
+        size <<= 1;
+    }
+    options_.table_size = size;
+    mask_ = size - 1;
+    slots_ = std::make_unique<Slot[]>(size);
+}
+
+void DedupFilter::claim(Slot& slot, const LogRecord& record, int64_t now) const {
+    slot.window_end.store(now + window_ns_, std::memory_order_relaxed);
+    while (slot.busy.test_and_set(std::memory_order_acquire)) {
+    }
+    slot.level = record.level;
+    slot.message.assign(record.message);
+    slot.busy.clear(std::memory_order_release);
+}
+
+void DedupFilter::report(Slot& slot, uint64_t repeats, const LogRecord& current) const {
+    LogRecord summary;
+    summary.logger_name = current.logger_name;
+    summary.timestamp = current.timestamp;
+    while (slot.busy.test_and_set(std::memory_order_acquire)) {
+    }
+    summary.level = slot.level;
+    summary.message = slot.message;
+    slot.busy.clear(std::memory_order_release);
+    summary.message += " (repeated " + std::to_string(repeats) + " times)";
+    summary.fields.set("repeated", FieldValue(repeats));
+
+    std::lock_guard<std::mutex> lock(pending_mtx_);
+    pending_.push_back(std::move(summary));
+    has_pending_.store(true, std::memory_order_release);
+}
+
+bool DedupFilter::should_log(const LogRecord& record) const {
+    (void)record;
+    return true;
+}
+
+bool DedupFilter::commit(const LogRecord& record) const {
+    const uint64_t key = dedup_key(record);
+    const int64_t now = to_ns(record.timestamp);
+    Slot* victim = nullptr;
+    int64_t victim_end = INT64_MAX;
+
+    for (size_t i = 0; i < PROBES; ++i) {
+        Slot& slot = slots_[(key + i) & mask_];
+        uint64_t current = slot.key.load(std::memory_order_acquire);
+        if (current == 0 && slot.key.compare_exchange_strong(current, key, std::memory_order_acq_rel)) {
+            claim(slot, record, now);
+            return true;
+        }
+        if (current == key) {
+            int64_t end = slot.window_end.load(std::memory_order_relaxed);
+            // Past the window, exactly one caller opens the next one and passes
+            if (now < end || !slot.window_end.compare_exchange_strong(end, now + window_ns_,
+                                                                      std::memory_order_relaxed)) {
+                slot.repeats.fetch_add(1, std::memory_order_relaxed);
+                suppressed_.add(0);
+                return false;
+            }
+            uint64_t repeats = slot.repeats.exchange(0, std::memory_order_relaxed);
+            if (repeats > 0) {
+                report(slot, repeats, record);
+            }
+            return true;
+        }
+        int64_t end = slot.window_end.load(std::memory_order_relaxed);
+        if (end < victim_end) {
+            victim = &slot;
+            victim_end = end;
+        }
+    }
+
+    // Probe run full. Only a key whose window is over gives way to a new one,
+    // so an ongoing storm keeps being collapsed.
+    uint64_t old_key = victim ? victim->key.load(std::memory_order_acquire) : 0;
+    if (!victim || victim_end > now ||
+        !victim->key.compare_exchange_strong(old_key, key, std::memory_order_acq_rel)) {
+        return true;
+    }
+    uint64_t repeats = victim->repeats.exchange(0, std::memory_order_relaxed);
+    if (repeats > 0) {
+        report(*victim, repeats, record);
+    }
+    claim(*victim, record, now);
+    return true;
+}
+
+void DedupFilter::sweep(int64_t now, const LogRecord& current) const {
+    for (size_t i = 0; i <= mask_; ++i) {
+        Slot& slot = slots_[i];
+        if (slot.key.load(std::memory_order_acquire) == 0 ||
+            slot.window_end.load(std::memory_order_relaxed) > now ||
+            slot.repeats.load(std::memory_order_relaxed) == 0) {
+            continue;
+        }
+        uint64_t repeats = slot.repeats.exchange(0, std::memory_order_relaxed);
+        if (repeats > 0) {
+            report(slot, repeats, current);
+        }
+    }
+}
+
+void DedupFilter::take_pending_records(const LogRecord& passed, std::vector<LogRecord>& out) const {
+    const int64_t now = to_ns(passed.timestamp);
+    int64_t due = next_sweep_ns_.load(std::memory_order_relaxed);
+    if (now >= due && next_sweep_ns_.compare_exchange_strong(due, now + window_ns_,
+                                                             std::memory_order_relaxed)) {
+        sweep(now, passed);
+    }
+    move_pending(out);
+}
+
+void DedupFilter::flush_pending_records(std::vector<LogRecord>& out) const {
+    LogRecord current;
+    current.timestamp = std::chrono::system_clock::now();
+    sweep(INT64_MAX, current);
+    move_pending(out);
+}
+
+void DedupFilter::move_pending(std::vector<LogRecord>& out) const {
+    if (!has_pending_.load(std::memory_order_acquire)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(pending_mtx_);
+    for (auto& record : pending_) {
+        out.push_back(std::move(record));
+    }
+    pending_.clear();
+    has_pending_.store(false, std::memory_order_relaxed);
+}
+
 RegexFilter::RegexFilter(const std::string& pattern, bool invert)
     : pattern_str_(pattern), 
       regex_(pattern), 
@@ -67,6 +261,7 @@ RegexFilter::RegexFilter(const std::string& field_name, const std::string& patte
     : pattern_str_(pattern), 
       regex_(pattern), 
       field_name_(field_name), 
+      field_key_(field_name),
       invert_(invert),
       case_insensitive_(false),
       track_stats_(true) {}
@@ -82,6 +277,7 @@ RegexFilter::RegexFilter(const std::string& field_name, const std::string& patte
     : pattern_str_(pattern),
       regex_(pattern, options.case_insensitive ? std::regex::icase : std::regex::ECMAScript),
       field_name_(field_name),
+      field_key_(field_name),
       invert_(options.invert),
       case_insensitive_(options.case_insensitive),
       track_stats_(options.track_stats) {}
@@ -92,10 +288,8 @@ bool RegexFilter::should_log(const LogRecord& record) const {
     if (field_name_.empty()) {
         target = record.message;
     } else {
-        auto context = LogContext::get_all();
-        auto it = context.find(field_name_);
-        if (it != context.end()) {
-            target = it->second;
+        if (const std::string* value = record.context.find(field_key_)) {
+            target = *value;
         } else {
             target = record.get_field(field_name_);
         }
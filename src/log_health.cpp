@@ -6,6 +6,18 @@
 
 namespace Zyrnix {
 
+namespace {
+
+double windowed(const RateMeter::Rates& rates, RateWindow window) {
+    switch (window) {
+        case RateWindow::OneSecond: return rates.one_second;
+        case RateWindow::TenSeconds: return rates.ten_seconds;
+        default: return rates.one_minute;
+    }
+}
+
+}
+
 std::string HealthCheckResult::to_json() const {
     std::ostringstream oss;
     oss << std::fixed << std::setprecision(2);
@@ -30,6 +42,7 @@ std::string HealthCheckResult::to_json() const {
     oss << "    \"messages_filtered\": " << messages_filtered << ",\n";
     oss << "    \"errors\": " << errors << ",\n";
     oss << "    \"messages_per_second\": " << messages_per_second << ",\n";
+    oss << "    \"recent_messages_per_second\": " << recent_messages_per_second << ",\n";
     oss << "    \"avg_latency_us\": " << avg_latency_us << ",\n";
     oss << "    \"max_latency_us\": " << max_latency_us << ",\n";
     oss << "    \"queue_depth\": " << queue_depth << ",\n";
@@ -71,7 +84,8 @@ std::string HealthCheckResult::to_string() const {
     oss << "Messages Dropped: " << messages_dropped << " (" << (drop_rate * 100.0) << "%)\n";
     oss << "Messages Filtered: " << messages_filtered << "\n";
     oss << "Errors: " << errors << " (" << (error_rate * 100.0) << "%)\n";
-    oss << "Throughput: " << messages_per_second << " msg/sec\n";
+    oss << "Throughput: " << recent_messages_per_second << " msg/sec recent, "
+        << messages_per_second << " msg/sec lifetime\n";
     oss << "Avg Latency: " << avg_latency_us << " μs\n";
     oss << "Max Latency: " << max_latency_us << " μs\n";
     oss << "Queue Depth: " << queue_depth << "/" << max_queue_depth << "\n";
@@ -102,7 +116,7 @@ HealthCheckResult HealthChecker::check_metrics(const LogMetrics& metrics, size_t
     result.messages_logged = snapshot.messages_logged;
     result.messages_dropped = snapshot.messages_dropped;
     result.messages_filtered = snapshot.messages_filtered;
-    result.errors = snapshot.errors;
+    result.errors = snapshot.errors + snapshot.sink_errors;
     result.messages_per_second = snapshot.messages_per_second;
     result.avg_latency_us = snapshot.avg_log_latency_us;
     result.max_latency_us = snapshot.max_log_latency_us;
@@ -110,9 +124,20 @@ HealthCheckResult HealthChecker::check_metrics(const LogMetrics& metrics, size_t
     result.max_queue_depth = snapshot.max_queue_depth;
     
 
-    uint64_t total_attempts = result.messages_logged + result.messages_dropped;
-    result.drop_rate = total_attempts > 0 ? static_cast<double>(result.messages_dropped) / total_attempts : 0.0;
-    result.error_rate = result.messages_logged > 0 ? static_cast<double>(result.errors) / result.messages_logged : 0.0;
+    if (config_.rate_window == RateWindow::Lifetime) {
+        uint64_t total_attempts = result.messages_logged + result.messages_dropped;
+        result.recent_messages_per_second = result.messages_per_second;
+        result.drop_rate = total_attempts > 0 ? static_cast<double>(result.messages_dropped) / total_attempts : 0.0;
+        result.error_rate = result.messages_logged > 0 ? static_cast<double>(result.errors) / result.messages_logged : 0.0;
+    } else {
+        double logged = windowed(snapshot.logged_rates, config_.rate_window);
+        double dropped = windowed(snapshot.dropped_rates, config_.rate_window);
+        double errors = windowed(snapshot.error_rates, config_.rate_window);
+        result.recent_messages_per_second = logged;
+        result.drop_rate = logged + dropped > 0.0 ? dropped / (logged + dropped) : 0.0;
+        // Errors with nothing getting through is as bad as it gets
+        result.error_rate = logged > 0.0 ? std::min(1.0, errors / logged) : (errors > 0.0 ? 1.0 : 0.0);
+    }
     
   
     double queue_usage = queue_capacity > 0 ? static_cast<double>(result.queue_depth) / queue_capacity : 0.0;
@@ -216,6 +241,12 @@ void HealthRegistry::unregister_logger(const std::string& name) {
     loggers_.erase(name);
 }
 
+std::shared_ptr<Logger> HealthRegistry::find_logger(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = loggers_.find(name);
+    return it != loggers_.end() ? it->second.logger.lock() : nullptr;
+}
+
 HealthCheckResult HealthRegistry::check_logger(const std::string& name) const {
     std::lock_guard<std::mutex> lock(mutex_);
     
@@ -239,7 +270,11 @@ HealthCheckResult HealthRegistry::check_logger(const std::string& name) const {
     
     const auto& checker = it->second.custom_checker ? it->second.custom_checker : health_checker_;
 
+#ifndef XLOG_NO_METRICS
+    const LogMetrics& metrics = *logger->metrics();
+#else
     LogMetrics metrics;
+#endif
     HealthCheckResult result = checker->check_logger(*logger, metrics);
     
     result.last_error_message = it->second.last_error_message;
@@ -256,7 +291,11 @@ std::map<std::string, HealthCheckResult> HealthRegistry::check_all() const {
         auto logger = entry.logger.lock();
         if (logger) {
             const auto& checker = entry.custom_checker ? entry.custom_checker : health_checker_;
+#ifndef XLOG_NO_METRICS
+            const LogMetrics& metrics = *logger->metrics();
+#else
             LogMetrics metrics;
+#endif
             HealthCheckResult result = checker->check_logger(*logger, metrics);
             result.last_error_message = entry.last_error_message;
             result.last_error_time = entry.last_error_time;
@@ -2,9 +2,687 @@
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include <string_view>
+#include <unordered_map>
+#include <thread>
 
 namespace Zyrnix {
 
+namespace {
+
+void update_max(std::atomic<uint64_t>& max, uint64_t value) {
+    uint64_t current = max.load(std::memory_order_relaxed);
+    while (value > current &&
+           !max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+// Prometheus bucket boundaries: 1-2.5-5 steps from 100ns to 10s. Each
+// cumulative count covers the whole Histogram bucket holding its bound.
+const std::vector<uint64_t> LATENCY_BOUNDS_NS = {
+    100, 250, 500,
+    1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000,
+    1000000, 2500000, 5000000, 10000000, 25000000, 50000000, 100000000, 250000000, 500000000,
+    1000000000, 2500000000, 5000000000, 10000000000};
+
+const std::vector<uint64_t> BATCH_SIZE_BOUNDS = {
+    1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192, 16384, 65536};
+
+// RateMeter windows in seconds, in Rates field order
+constexpr double RATE_WINDOWS_S[] = {1.0, 10.0, 60.0};
+constexpr const char* RATE_WINDOW_LABELS[] = {"1s", "10s", "60s"};
+constexpr auto MIN_RATE_INTERVAL = std::chrono::milliseconds(100);
+
+double rate_at(const RateMeter::Rates& rates, size_t window) {
+    return window == 0 ? rates.one_second : window == 1 ? rates.ten_seconds : rates.one_minute;
+}
+
+void export_rates_json(std::ostream& out, const RateMeter::Rates& rates) {
+    out << "{";
+    for (size_t i = 0; i < 3; ++i) {
+        if (i != 0) out << ",";
+        out << "\"" << RATE_WINDOW_LABELS[i] << "\":" << std::fixed << std::setprecision(2)
+            << rate_at(rates, i);
+    }
+    out << "}";
+}
+
+// Number formatting for the exposition text: std::to_chars, so no
+// locale, no stream state and no allocation
+void append_uint(std::string& out, uint64_t value) {
+    char buf[24];
+    auto result = std::to_chars(buf, buf + sizeof(buf), value);
+    out.append(buf, result.ptr);
+}
+
+void append_fixed(std::string& out, double value) {
+    char buf[64];
+    auto result = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::fixed, 2);
+    if (result.ec != std::errc()) {
+        out += "0.00";
+        return;
+    }
+    out.append(buf, result.ptr);
+}
+
+// Shortest representation with 9 significant digits (like "%.9g")
+void append_real(std::string& out, double value) {
+    char buf[32];
+    auto result = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::general, 9);
+    out.append(buf, result.ptr);
+}
+
+std::string format_bound(double value) {
+    std::string out;
+    append_real(out, value);
+    return out;
+}
+
+// Label values may not contain raw backslashes, quotes or newlines
+std::string escape_label(const std::string& value) {
+    std::string out;
+    out.reserve(value.size());
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            out += '\\';
+            out += c;
+        } else if (c == '\n') {
+            out += "\\n";
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+std::string join_labels(const std::string& a, const std::string& b) {
+    if (a.empty()) return b;
+    if (b.empty()) return a;
+    return a + "," + b;
+}
+
+/**
+ * Exposition text with everything but the sample values pre-rendered:
+ * literals[0] value literals[1] value ... literals[n]. Built once per
+ * prefix (and sink), so a scrape only formats numbers and appends.
+ *
+ * The same values can also be rendered grouped by family, for exports
+ * that merge several objects: samples[i] prefixes value i, which belongs
+ * to the family whose HELP/TYPE lines are headers[families[i]].
+ */
+struct PrometheusText {
+    std::vector<std::string> literals;
+    std::vector<std::string> samples;
+    std::vector<size_t> families;
+    std::vector<std::string> headers;
+};
+
+class PrometheusTextBuilder {
+public:
+    // @p grouped_label is added to the grouped samples only, e.g. the
+    // logger label that tells merged loggers apart
+    explicit PrometheusTextBuilder(std::string grouped_label = "")
+        : grouped_label_(std::move(grouped_label)) {}
+
+    PrometheusTextBuilder& header(const std::string& name, const char* help, const char* type) {
+        std::string header;
+        header.append("# HELP ").append(name).append(" ").append(help).append("\n")
+              .append("# TYPE ").append(name).append(" ").append(type).append("\n");
+        current_.append(header);
+        text_.headers.push_back(std::move(header));
+        return *this;
+    }
+
+    // A sample line; its value is supplied at render time
+    PrometheusTextBuilder& sample(const std::string& name, const std::string& labels = "") {
+        current_.append(sample_prefix(name, labels));
+        text_.literals.push_back(std::move(current_));
+        current_ = "\n";
+
+        text_.samples.push_back(sample_prefix(name, join_labels(grouped_label_, labels)));
+        text_.families.push_back(text_.headers.size() - 1);
+        return *this;
+    }
+
+    PrometheusTextBuilder& blank() {
+        current_ += '\n';
+        return *this;
+    }
+
+    // Gauges for each RateMeter window
+    PrometheusTextBuilder& rates(const std::string& name, const char* help, const std::string& labels = "") {
+        header(name, help, "gauge");
+        for (const char* window : RATE_WINDOW_LABELS) {
+            sample(name, join_labels(labels, std::string("window=\"") + window + "\""));
+        }
+        return blank();
+    }
+
+    PrometheusTextBuilder& histogram(const std::string& name, const char* help,
+                                     const std::vector<uint64_t>& bounds, double scale) {
+        header(name, help, "histogram");
+        for (uint64_t bound : bounds) {
+            sample(name + "_bucket", "le=\"" + format_bound(static_cast<double>(bound) * scale) + "\"");
+        }
+        sample(name + "_bucket", "le=\"+Inf\"");
+        sample(name + "_sum");
+        sample(name + "_count");
+        return blank();
+    }
+
+    PrometheusText build() {
+        text_.literals.push_back(std::move(current_));
+        return std::move(text_);
+    }
+
+private:
+    static std::string sample_prefix(const std::string& name, const std::string& labels) {
+        std::string prefix = name;
+        if (!labels.empty()) {
+            prefix.append("{").append(labels).append("}");
+        }
+        prefix += ' ';
+        return prefix;
+    }
+
+    PrometheusText text_;
+    std::string current_;
+    std::string grouped_label_;
+};
+
+/**
+ * Sample lines of several objects collected per family, so each family
+ * gets one HELP/TYPE pair followed by all of its samples, as the
+ * exposition format requires. Families keep their first-seen order.
+ */
+class PrometheusFamilies {
+public:
+    // Headers come from cached PrometheusText, which is never freed
+    std::string& body(const std::string& header) {
+        auto [it, inserted] = index_.try_emplace(std::string_view(header), families_.size());
+        if (inserted) {
+            families_.push_back(Family{&header, std::string()});
+        }
+        return families_[it->second].body;
+    }
+
+    void append_to(std::string& out) const {
+        for (const auto& family : families_) {
+            out.append(*family.header).append(family.body).append("\n");
+        }
+    }
+
+private:
+    struct Family {
+        const std::string* header;
+        std::string body;
+    };
+    std::deque<Family> families_; // Stable references for renderers
+    std::unordered_map<std::string_view, size_t> index_;
+};
+
+// Appends a PrometheusText, taking the values in literal order; either
+// flat (headers inline) or grouped into PrometheusFamilies
+class PrometheusTextRenderer {
+public:
+    PrometheusTextRenderer(const PrometheusText& text, std::string& out)
+        : text_(text), out_(&out) {}
+
+    PrometheusTextRenderer(const PrometheusText& text, PrometheusFamilies& families)
+        : text_(text) {
+        bodies_.reserve(text.headers.size());
+        for (const auto& header : text.headers) {
+            bodies_.push_back(&families.body(header));
+        }
+    }
+
+    void integer(uint64_t value) { std::string& out = next(); append_uint(out, value); end(out); }
+    void fixed(double value) { std::string& out = next(); append_fixed(out, value); end(out); }
+    void real(double value) { std::string& out = next(); append_real(out, value); end(out); }
+
+    void rates(const RateMeter::Rates& rates) {
+        for (size_t i = 0; i < 3; ++i) {
+            fixed(rate_at(rates, i));
+        }
+    }
+
+    // One pass over the buckets for all cumulative bounds
+    void histogram(const Histogram::Snapshot& snap, const std::vector<uint64_t>& bounds, double scale) {
+        uint64_t cumulative = 0;
+        size_t bucket = 0;
+        for (uint64_t bound : bounds) {
+            size_t last = std::min(Histogram::bucket_index(bound), snap.buckets.size() - 1);
+            for (; bucket <= last; ++bucket) {
+                cumulative += snap.buckets[bucket];
+            }
+            integer(cumulative);
+        }
+        integer(snap.count);
+        real(static_cast<double>(snap.sum) * scale);
+        integer(snap.count);
+    }
+
+    void finish() {
+        if (out_) out_->append(text_.literals[index_]);
+    }
+
+private:
+    std::string& next() {
+        if (out_) {
+            return out_->append(text_.literals[index_++]);
+        }
+        std::string& body = *bodies_[text_.families[index_]];
+        return body.append(text_.samples[index_++]);
+    }
+
+    void end(std::string& out) {
+        if (!out_) out += '\n';
+    }
+
+    const PrometheusText& text_;
+    std::string* out_ = nullptr;
+    std::vector<std::string*> bodies_; // Grouped: body per family of text_
+    size_t index_ = 0;
+};
+
+struct LogMetricsText {
+    PrometheusText main;
+    PrometheusText log_latency;
+    PrometheusText flush_latency;
+    PrometheusText enqueue_to_write;
+    PrometheusText batch_size;
+};
+
+std::shared_ptr<const LogMetricsText> build_log_metrics_text(const std::string& prefix,
+                                                             const std::string& grouped_label = "") {
+    auto text = std::make_shared<LogMetricsText>();
+    PrometheusTextBuilder main(grouped_label);
+    main.header(prefix + "_messages_logged_total", "Total number of messages logged", "counter")
+        .sample(prefix + "_messages_logged_total").blank()
+        .header(prefix + "_messages_dropped_total", "Total number of messages dropped", "counter")
+        .sample(prefix + "_messages_dropped_total").blank()
+        .header(prefix + "_messages_filtered_total", "Total number of messages filtered", "counter")
+        .sample(prefix + "_messages_filtered_total").blank()
+        .header(prefix + "_messages_level_rejected_total", "Messages below the logger level", "counter")
+        .sample(prefix + "_messages_level_rejected_total").blank()
+        .header(prefix + "_messages_rate_limited_total", "Messages dropped by the rate limit", "counter")
+        .sample(prefix + "_messages_rate_limited_total").blank()
+        .header(prefix + "_messages_per_second", "Current logging rate", "gauge")
+        .sample(prefix + "_messages_per_second").blank()
+        .rates(prefix + "_messages_logged_per_second", "Recent logging rate (moving average over window)")
+        .rates(prefix + "_messages_dropped_per_second", "Recent drop rate (moving average over window)")
+        .rates(prefix + "_errors_per_second",
+               "Recent error rate including sink errors (moving average over window)")
+        .header(prefix + "_log_latency_us_avg", "Average log call latency in microseconds", "gauge")
+        .sample(prefix + "_log_latency_us_avg").blank()
+        .header(prefix + "_log_latency_us_max", "Maximum log call latency in microseconds", "gauge")
+        .sample(prefix + "_log_latency_us_max").blank()
+        .header(prefix + "_queue_depth", "Current async queue depth", "gauge")
+        .sample(prefix + "_queue_depth").blank()
+        .header(prefix + "_queue_depth_max", "Maximum async queue depth", "gauge")
+        .sample(prefix + "_queue_depth_max").blank()
+        .header(prefix + "_errors_total", "Total number of logging errors", "counter")
+        .sample(prefix + "_errors_total").blank()
+        .header(prefix + "_sink_errors_total", "Sink writes that threw", "counter")
+        .sample(prefix + "_sink_errors_total").blank();
+    text->main = main.build();
+
+    text->log_latency = PrometheusTextBuilder(grouped_label)
+        .histogram(prefix + "_log_latency_seconds", "Log call latency", LATENCY_BOUNDS_NS, 1e-9).build();
+    text->flush_latency = PrometheusTextBuilder(grouped_label)
+        .histogram(prefix + "_flush_latency_seconds", "Flush latency", LATENCY_BOUNDS_NS, 1e-9).build();
+    text->enqueue_to_write = PrometheusTextBuilder(grouped_label)
+        .histogram(prefix + "_enqueue_to_write_seconds", "Time from enqueue to write by the async backend",
+                   LATENCY_BOUNDS_NS, 1e-9).build();
+    text->batch_size = PrometheusTextBuilder(grouped_label)
+        .histogram(prefix + "_batch_size", "Records per batch written by the async backend",
+                   BATCH_SIZE_BOUNDS, 1.0).build();
+    return text;
+}
+
+std::shared_ptr<const PrometheusText> build_sink_metrics_text(const std::string& prefix, const std::string& sink) {
+    std::string label = "sink=\"" + escape_label(sink) + "\"";
+    PrometheusTextBuilder text;
+    text.header(prefix + "_sink_writes_total", "Total writes by sink", "counter")
+        .sample(prefix + "_sink_writes_total", label).blank()
+        .header(prefix + "_sink_bytes_written_total", "Total bytes written by sink", "counter")
+        .sample(prefix + "_sink_bytes_written_total", label).blank()
+        .header(prefix + "_sink_write_latency_us_avg", "Average write latency by sink", "gauge")
+        .sample(prefix + "_sink_write_latency_us_avg", label).blank()
+        .header(prefix + "_sink_dropped_total", "Records dropped by a full sink queue", "counter")
+        .sample(prefix + "_sink_dropped_total", label).blank()
+        .header(prefix + "_sink_queue_depth", "Records waiting in the sink queue", "gauge")
+        .sample(prefix + "_sink_queue_depth", label).blank()
+        .header(prefix + "_sink_queue_depth_max", "Highest sink queue depth seen", "gauge")
+        .sample(prefix + "_sink_queue_depth_max", label).blank()
+        .rates(prefix + "_sink_bytes_written_per_second",
+               "Recent bytes written by sink (moving average over window)", label)
+        .rates(prefix + "_sink_errors_per_second",
+               "Recent sink error rate (moving average over window)", label);
+    return std::make_shared<const PrometheusText>(text.build());
+}
+
+// Rendered text is cached for the process lifetime: prefixes are few and
+// loggers and sinks are never removed from the registry either
+template <typename Text, typename Build>
+std::shared_ptr<const Text> cached_text(const std::string& key, Build&& build) {
+    static std::mutex mutex;
+    static std::map<std::string, std::shared_ptr<const Text>> cache;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = cache.find(key);
+    if (it == cache.end()) {
+        it = cache.emplace(key, build()).first;
+    }
+    return it->second;
+}
+
+std::string scoped_key(const std::string& prefix, const std::string& name) {
+    std::string key = prefix;
+    key.append(1, '\0').append(name);
+    return key;
+}
+
+std::shared_ptr<const PrometheusText> sink_metrics_text(const std::string& prefix, const std::string& sink) {
+    return cached_text<PrometheusText>(scoped_key(prefix, sink),
+                                       [&] { return build_sink_metrics_text(prefix, sink); });
+}
+
+// Out is a std::string (flat) or PrometheusFamilies (grouped)
+template <typename Out>
+void render_log_metrics(const LogMetrics& metrics, const LogMetricsText& text, Out& out) {
+    PrometheusTextRenderer main(text.main, out);
+    main.integer(metrics.get_messages_logged());
+    main.integer(metrics.get_messages_dropped());
+    main.integer(metrics.get_messages_filtered());
+    main.integer(metrics.get_messages_level_rejected());
+    main.integer(metrics.get_messages_rate_limited());
+    main.fixed(metrics.get_messages_per_second());
+    main.rates(metrics.get_logged_rates());
+    main.rates(metrics.get_dropped_rates());
+    main.rates(metrics.get_error_rates());
+    main.fixed(metrics.get_average_log_latency_us());
+    main.integer(metrics.get_max_log_latency_us());
+    main.integer(metrics.get_current_queue_depth());
+    main.integer(metrics.get_max_queue_depth());
+    main.integer(metrics.get_errors());
+    main.integer(metrics.get_sink_errors());
+    main.finish();
+
+    // Histograms appear once they have data, so idle loggers stay compact
+    auto histogram = [&out](const Histogram& histogram, const PrometheusText& text,
+                            const std::vector<uint64_t>& bounds, double scale) {
+        if (histogram.count() == 0) return;
+        // Scrapes reuse one bucket buffer per thread instead of allocating
+        thread_local Histogram::Snapshot snap;
+        histogram.snapshot(snap);
+        PrometheusTextRenderer renderer(text, out);
+        renderer.histogram(snap, bounds, scale);
+        renderer.finish();
+    };
+    histogram(metrics.log_latency_histogram(), text.log_latency, LATENCY_BOUNDS_NS, 1e-9);
+    histogram(metrics.flush_latency_histogram(), text.flush_latency, LATENCY_BOUNDS_NS, 1e-9);
+    histogram(metrics.enqueue_to_write_histogram(), text.enqueue_to_write, LATENCY_BOUNDS_NS, 1e-9);
+    histogram(metrics.batch_size_histogram(), text.batch_size, BATCH_SIZE_BOUNDS, 1.0);
+}
+
+template <typename Out>
+void render_sink_metrics(const SinkMetrics& metrics, const PrometheusText& text, Out& out) {
+    PrometheusTextRenderer renderer(text, out);
+    renderer.integer(metrics.get_writes());
+    renderer.integer(metrics.get_bytes_written());
+    renderer.fixed(metrics.get_average_write_latency_us());
+    renderer.integer(metrics.get_dropped());
+    renderer.integer(metrics.get_queue_depth());
+    renderer.integer(metrics.get_max_queue_depth());
+    renderer.rates(metrics.get_bytes_written_rates());
+    renderer.rates(metrics.get_error_rates());
+    renderer.finish();
+}
+
+}
+
+Histogram::~Histogram() {
+    for (auto& shard : shards_) {
+        delete shard.load(std::memory_order_relaxed);
+    }
+}
+
+size_t Histogram::bucket_index(uint64_t value) {
+    if (value < SUB_BUCKETS) {
+        return static_cast<size_t>(value);
+    }
+    unsigned exponent = static_cast<unsigned>(std::bit_width(value)) - 1;
+    if (exponent >= MAX_VALUE_BITS) {
+        return BUCKETS - 1;
+    }
+    unsigned shift = exponent - SUB_BUCKET_BITS;
+    size_t sub = static_cast<size_t>(value >> shift) - SUB_BUCKETS;
+    return (shift + 1) * SUB_BUCKETS + sub;
+}
+
+uint64_t Histogram::bucket_upper_bound(size_t bucket) {
+    if (bucket < SUB_BUCKETS) {
+        return bucket;
+    }
+    size_t shift = bucket / SUB_BUCKETS - 1;
+    uint64_t lower = static_cast<uint64_t>(SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+    return lower + (uint64_t{1} << shift) - 1;
+}
+
+Histogram::Shard& Histogram::local_shard() {
+    auto& slot = shards_[thread_shard_index() % SHARDS];
+    Shard* shard = slot.load(std::memory_order_acquire);
+    if (shard == nullptr) {
+        auto* fresh = new Shard();
+        if (slot.compare_exchange_strong(shard, fresh, std::memory_order_acq_rel)) {
+            shard = fresh;
+        } else {
+            delete fresh; // Another thread on this slot won
+        }
+    }
+    return *shard;
+}
+
+void Histogram::record(uint64_t value) {
+    Shard& shard = local_shard();
+    shard.buckets[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+    shard.count.fetch_add(1, std::memory_order_relaxed);
+    shard.sum.fetch_add(value, std::memory_order_relaxed);
+    update_max(shard.max, value);
+}
+
+Histogram::Snapshot Histogram::snapshot() const {
+    Snapshot snap;
+    snapshot(snap);
+    return snap;
+}
+
+void Histogram::snapshot(Snapshot& snap) const {
+    snap.buckets.assign(BUCKETS, 0);
+    snap.count = 0;
+    snap.sum = 0;
+    snap.max = 0;
+    for (const auto& slot : shards_) {
+        const Shard* shard = slot.load(std::memory_order_acquire);
+        if (shard == nullptr) continue;
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            snap.buckets[i] += shard->buckets[i].load(std::memory_order_relaxed);
+        }
+        snap.sum += shard->sum.load(std::memory_order_relaxed);
+        snap.max = std::max(snap.max, shard->max.load(std::memory_order_relaxed));
+    }
+    // Derived from the buckets so percentiles and cumulative counts agree
+    for (uint64_t n : snap.buckets) {
+        snap.count += n;
+    }
+}
+
+uint64_t Histogram::count() const {
+    uint64_t total = 0;
+    for (const auto& slot : shards_) {
+        if (const Shard* shard = slot.load(std::memory_order_acquire)) {
+            total += shard->count.load(std::memory_order_relaxed);
+        }
+    }
+    return total;
+}
+
+uint64_t Histogram::sum() const {
+    uint64_t total = 0;
+    for (const auto& slot : shards_) {
+        if (const Shard* shard = slot.load(std::memory_order_acquire)) {
+            total += shard->sum.load(std::memory_order_relaxed);
+        }
+    }
+    return total;
+}
+
+uint64_t Histogram::max() const {
+    uint64_t result = 0;
+    for (const auto& slot : shards_) {
+        if (const Shard* shard = slot.load(std::memory_order_acquire)) {
+            result = std::max(result, shard->max.load(std::memory_order_relaxed));
+        }
+    }
+    return result;
+}
+
+double Histogram::mean() const {
+    uint64_t n = count();
+    return n == 0 ? 0.0 : static_cast<double>(sum()) / static_cast<double>(n);
+}
+
+void Histogram::reset() {
+    // Shards stay allocated: writers may hold references to them
+    for (auto& slot : shards_) {
+        Shard* shard = slot.load(std::memory_order_acquire);
+        if (shard == nullptr) continue;
+        for (auto& bucket : shard->buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        shard->count.store(0, std::memory_order_relaxed);
+        shard->sum.store(0, std::memory_order_relaxed);
+        shard->max.store(0, std::memory_order_relaxed);
+    }
+}
+
+double Histogram::Snapshot::mean() const {
+    return count == 0 ? 0.0 : static_cast<double>(sum) / static_cast<double>(count);
+}
+
+uint64_t Histogram::Snapshot::percentile(double p) const {
+    if (count == 0) {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(std::ceil(std::clamp(p, 0.0, 100.0) / 100.0 * static_cast<double>(count)));
+    rank = std::max<uint64_t>(rank, 1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return i == BUCKETS - 1 ? max : std::min(bucket_upper_bound(i), max);
+        }
+    }
+    return max;
+}
+
+uint64_t Histogram::Snapshot::count_at_or_below(uint64_t value) const {
+    uint64_t total = 0;
+    size_t last = std::min(bucket_index(value), buckets.size() - 1);
+    for (size_t i = 0; i <= last; ++i) {
+        total += buckets[i];
+    }
+    return total;
+}
+
+void Histogram::export_prometheus(std::ostream& out, const std::string& name, const std::string& help,
+                                  const std::vector<uint64_t>& bounds, double scale) const {
+    Snapshot snap = snapshot();
+    out << "# HELP " << name << " " << help << "\n"
+        << "# TYPE " << name << " histogram\n";
+    for (uint64_t bound : bounds) {
+        out << name << "_bucket{le=\"" << format_bound(static_cast<double>(bound) * scale) << "\"} "
+            << snap.count_at_or_below(bound) << "\n";
+    }
+    out << name << "_bucket{le=\"+Inf\"} " << snap.count << "\n"
+        << name << "_sum " << format_bound(static_cast<double>(snap.sum) * scale) << "\n"
+        << name << "_count " << snap.count << "\n\n";
+}
+
+void Histogram::export_json(std::ostream& out) const {
+    Snapshot snap = snapshot();
+    char mean[32];
+    std::snprintf(mean, sizeof(mean), "%.2f", snap.mean());
+    out << "{\"count\":" << snap.count
+        << ",\"sum\":" << snap.sum
+        << ",\"mean\":" << mean
+        << ",\"max\":" << snap.max
+        << ",\"p50\":" << snap.percentile(50)
+        << ",\"p90\":" << snap.percentile(90)
+        << ",\"p99\":" << snap.percentile(99)
+        << ",\"p999\":" << snap.percentile(99.9)
+        << "}";
+}
+
+RateMeter::RateMeter()
+    : last_time_(std::chrono::steady_clock::now()) {
+    for (auto& rate : rates_) {
+        rate.store(0.0, std::memory_order_relaxed);
+    }
+}
+
+RateMeter::Rates RateMeter::sample(uint64_t total) {
+    // Another reader is updating; its result is at most a moment newer
+    if (updating_.test_and_set(std::memory_order_acquire)) {
+        return rates();
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_time_ >= MIN_RATE_INTERVAL) {
+        double elapsed = std::chrono::duration<double>(now - last_time_).count();
+        // A reset counter restarts from zero
+        uint64_t delta = total >= last_total_ ? total - last_total_ : total;
+        double rate = static_cast<double>(delta) / elapsed;
+        for (size_t i = 0; i < WINDOWS; ++i) {
+            double current = rates_[i].load(std::memory_order_relaxed);
+            // Seed with the first interval's rate so long windows don't ramp up from zero
+            double alpha = seeded_ ? 1.0 - std::exp(-elapsed / RATE_WINDOWS_S[i]) : 1.0;
+            rates_[i].store(current + alpha * (rate - current), std::memory_order_relaxed);
+        }
+        seeded_ = true;
+        last_total_ = total;
+        last_time_ = now;
+    }
+
+    updating_.clear(std::memory_order_release);
+    return rates();
+}
+
+RateMeter::Rates RateMeter::rates() const {
+    Rates result;
+    result.one_second = rates_[0].load(std::memory_order_relaxed);
+    result.ten_seconds = rates_[1].load(std::memory_order_relaxed);
+    result.one_minute = rates_[2].load(std::memory_order_relaxed);
+    return result;
+}
+
+void RateMeter::reset(uint64_t total) {
+    while (updating_.test_and_set(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+    last_total_ = total;
+    last_time_ = std::chrono::steady_clock::now();
+    seeded_ = false;
+    for (auto& rate : rates_) {
+        rate.store(0.0, std::memory_order_relaxed);
+    }
+    updating_.clear(std::memory_order_release);
+}
 
 LogMetrics::LogMetrics()
     : start_time_(std::chrono::steady_clock::now())
@@ -12,45 +690,55 @@ LogMetrics::LogMetrics()
 }
 
 void LogMetrics::record_message_logged() {
-    counters_.messages_logged.fetch_add(1, std::memory_order_relaxed);
+    counters_.add(MESSAGES_LOGGED);
 }
 
 void LogMetrics::record_message_dropped() {
-    counters_.messages_dropped.fetch_add(1, std::memory_order_relaxed);
+    counters_.add(MESSAGES_DROPPED);
 }
 
 void LogMetrics::record_message_filtered() {
-    counters_.messages_filtered.fetch_add(1, std::memory_order_relaxed);
+    counters_.add(MESSAGES_FILTERED);
+}
+
+void LogMetrics::record_message_level_rejected() {
+    counters_.add(MESSAGES_LEVEL_REJECTED);
+}
+
+void LogMetrics::record_message_rate_limited() {
+    counters_.add(MESSAGES_RATE_LIMITED);
+}
+
+void LogMetrics::record_sink_error() {
+    counters_.add(SINK_ERRORS);
 }
 
 void LogMetrics::record_flush() {
-    counters_.flushes.fetch_add(1, std::memory_order_relaxed);
+    counters_.add(FLUSHES);
 }
 
 void LogMetrics::record_error() {
-    counters_.errors.fetch_add(1, std::memory_order_relaxed);
+    counters_.add(ERRORS);
 }
 
 void LogMetrics::record_log_duration(uint64_t microseconds) {
-    timings_.total_log_time_us.fetch_add(microseconds, std::memory_order_relaxed);
-    
-    uint64_t current_max = timings_.max_log_latency_us.load(std::memory_order_relaxed);
-    while (microseconds > current_max) {
-        if (timings_.max_log_latency_us.compare_exchange_weak(current_max, microseconds, std::memory_order_relaxed)) {
-            break;
-        }
-    }
+    record_log_latency_ns(microseconds * 1000);
 }
 
 void LogMetrics::record_flush_duration(uint64_t microseconds) {
-    timings_.total_flush_time_us.fetch_add(microseconds, std::memory_order_relaxed);
-    
-    uint64_t current_max = timings_.max_flush_latency_us.load(std::memory_order_relaxed);
-    while (microseconds > current_max) {
-        if (timings_.max_flush_latency_us.compare_exchange_weak(current_max, microseconds, std::memory_order_relaxed)) {
-            break;
-        }
-    }
+    record_flush_latency_ns(microseconds * 1000);
+}
+
+void LogMetrics::record_log_latency_ns(uint64_t nanoseconds) {
+    counters_.add(LOG_TIME_NS, nanoseconds);
+    update_max(timings_.max_log_latency_ns, nanoseconds);
+    log_latency_ns_.record(nanoseconds);
+}
+
+void LogMetrics::record_flush_latency_ns(uint64_t nanoseconds) {
+    counters_.add(FLUSH_TIME_NS, nanoseconds);
+    update_max(timings_.max_flush_latency_ns, nanoseconds);
+    flush_latency_ns_.record(nanoseconds);
 }
 
 void LogMetrics::update_queue_depth(size_t depth) {
@@ -64,6 +752,14 @@ void LogMetrics::update_queue_depth(size_t depth) {
     }
 }
 
+void LogMetrics::record_batch_size(size_t records) {
+    batch_sizes_.record(records);
+}
+
+void LogMetrics::record_enqueue_to_write_ns(uint64_t nanoseconds) {
+    enqueue_to_write_ns_.record(nanoseconds);
+}
+
 double LogMetrics::get_messages_per_second() const {
     auto now = std::chrono::steady_clock::now();
     auto elapsed_seconds = std::chrono::duration<double>(now - start_time_).count();
@@ -72,47 +768,51 @@ double LogMetrics::get_messages_per_second() const {
         return 0.0;
     }
     
-    return static_cast<double>(counters_.messages_logged.load(std::memory_order_relaxed)) / elapsed_seconds;
+    return static_cast<double>(get_messages_logged()) / elapsed_seconds;
 }
 
 double LogMetrics::get_average_log_latency_us() const {
-    uint64_t total_time = timings_.total_log_time_us.load(std::memory_order_relaxed);
-    uint64_t count = counters_.messages_logged.load(std::memory_order_relaxed);
+    // Loggers time a sample of their calls, so average over the timed ones
+    uint64_t total_time = counters_.load(LOG_TIME_NS);
+    uint64_t count = log_latency_ns_.count();
     
     if (count == 0) {
         return 0.0;
     }
     
-    return static_cast<double>(total_time) / static_cast<double>(count);
+    return static_cast<double>(total_time) / 1000.0 / static_cast<double>(count);
 }
 
 double LogMetrics::get_average_flush_latency_us() const {
-    uint64_t total_time = timings_.total_flush_time_us.load(std::memory_order_relaxed);
-    uint64_t count = counters_.flushes.load(std::memory_order_relaxed);
+    uint64_t total_time = counters_.load(FLUSH_TIME_NS);
+    uint64_t count = get_flushes();
     
     if (count == 0) {
         return 0.0;
     }
     
-    return static_cast<double>(total_time) / static_cast<double>(count);
+    return static_cast<double>(total_time) / 1000.0 / static_cast<double>(count);
 }
 
 void LogMetrics::reset() {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    counters_.messages_logged.store(0, std::memory_order_relaxed);
-    counters_.messages_dropped.store(0, std::memory_order_relaxed);
-    counters_.messages_filtered.store(0, std::memory_order_relaxed);
-    counters_.flushes.store(0, std::memory_order_relaxed);
-    counters_.errors.store(0, std::memory_order_relaxed);
+    counters_.reset();
     
-    timings_.total_log_time_us.store(0, std::memory_order_relaxed);
-    timings_.total_flush_time_us.store(0, std::memory_order_relaxed);
-    timings_.max_log_latency_us.store(0, std::memory_order_relaxed);
-    timings_.max_flush_latency_us.store(0, std::memory_order_relaxed);
+    timings_.max_log_latency_ns.store(0, std::memory_order_relaxed);
+    timings_.max_flush_latency_ns.store(0, std::memory_order_relaxed);
     
     queue_metrics_.current_depth.store(0, std::memory_order_relaxed);
     queue_metrics_.max_depth.store(0, std::memory_order_relaxed);
+
+    log_latency_ns_.reset();
+    flush_latency_ns_.reset();
+    enqueue_to_write_ns_.reset();
+    batch_sizes_.reset();
+
+    logged_rate_.reset();
+    dropped_rate_.reset();
+    error_rate_.reset();
     
     start_time_ = std::chrono::steady_clock::now();
 }
@@ -122,13 +822,23 @@ LogMetrics::Snapshot LogMetrics::get_snapshot() const {
     snap.messages_logged = get_messages_logged();
     snap.messages_dropped = get_messages_dropped();
     snap.messages_filtered = get_messages_filtered();
+    snap.messages_level_rejected = get_messages_level_rejected();
+    snap.messages_rate_limited = get_messages_rate_limited();
+    snap.sink_errors = get_sink_errors();
     snap.flushes = get_flushes();
     snap.errors = get_errors();
     snap.messages_per_second = get_messages_per_second();
+    snap.logged_rates = get_logged_rates();
+    snap.dropped_rates = get_dropped_rates();
+    snap.error_rates = get_error_rates();
     snap.avg_log_latency_us = get_average_log_latency_us();
     snap.avg_flush_latency_us = get_average_flush_latency_us();
     snap.max_log_latency_us = get_max_log_latency_us();
     snap.max_flush_latency_us = get_max_flush_latency_us();
+    Histogram::Snapshot latency = log_latency_ns_.snapshot();
+    snap.log_latency_p50_ns = latency.percentile(50);
+    snap.log_latency_p99_ns = latency.percentile(99);
+    snap.log_latency_p999_ns = latency.percentile(99.9);
     snap.current_queue_depth = get_current_queue_depth();
     snap.max_queue_depth = get_max_queue_depth();
     snap.timestamp = std::chrono::steady_clock::now();
@@ -137,47 +847,14 @@ LogMetrics::Snapshot LogMetrics::get_snapshot() const {
 }
 
 std::string LogMetrics::export_prometheus(const std::string& prefix) const {
-    std::ostringstream out;
-    
-    out << "# HELP " << prefix << "_messages_logged_total Total number of messages logged\n"
-        << "# TYPE " << prefix << "_messages_logged_total counter\n"
-        << prefix << "_messages_logged_total " << get_messages_logged() << "\n\n";
-    
-    out << "# HELP " << prefix << "_messages_dropped_total Total number of messages dropped\n"
-        << "# TYPE " << prefix << "_messages_dropped_total counter\n"
-        << prefix << "_messages_dropped_total " << get_messages_dropped() << "\n\n";
-    
-    out << "# HELP " << prefix << "_messages_filtered_total Total number of messages filtered\n"
-        << "# TYPE " << prefix << "_messages_filtered_total counter\n"
-        << prefix << "_messages_filtered_total " << get_messages_filtered() << "\n\n";
-    
-    out << "# HELP " << prefix << "_messages_per_second Current logging rate\n"
-        << "# TYPE " << prefix << "_messages_per_second gauge\n"
-        << prefix << "_messages_per_second " << std::fixed << std::setprecision(2) 
-        << get_messages_per_second() << "\n\n";
-    
-    out << "# HELP " << prefix << "_log_latency_us_avg Average log call latency in microseconds\n"
-        << "# TYPE " << prefix << "_log_latency_us_avg gauge\n"
-        << prefix << "_log_latency_us_avg " << std::fixed << std::setprecision(2)
-        << get_average_log_latency_us() << "\n\n";
-    
-    out << "# HELP " << prefix << "_log_latency_us_max Maximum log call latency in microseconds\n"
-        << "# TYPE " << prefix << "_log_latency_us_max gauge\n"
-        << prefix << "_log_latency_us_max " << get_max_log_latency_us() << "\n\n";
-    
-    out << "# HELP " << prefix << "_queue_depth Current async queue depth\n"
-        << "# TYPE " << prefix << "_queue_depth gauge\n"
-        << prefix << "_queue_depth " << get_current_queue_depth() << "\n\n";
-    
-    out << "# HELP " << prefix << "_queue_depth_max Maximum async queue depth\n"
-        << "# TYPE " << prefix << "_queue_depth_max gauge\n"
-        << prefix << "_queue_depth_max " << get_max_queue_depth() << "\n\n";
-    
-    out << "# HELP " << prefix << "_errors_total Total number of logging errors\n"
-        << "# TYPE " << prefix << "_errors_total counter\n"
-        << prefix << "_errors_total " << get_errors() << "\n\n";
-    
-    return out.str();
+    std::string out;
+    export_prometheus(out, prefix);
+    return out;
+}
+
+void LogMetrics::export_prometheus(std::string& out, const std::string& prefix) const {
+    auto text = cached_text<LogMetricsText>(prefix, [&] { return build_log_metrics_text(prefix); });
+    render_log_metrics(*this, *text, out);
 }
 
 std::string LogMetrics::export_json() const {
@@ -187,6 +864,9 @@ std::string LogMetrics::export_json() const {
          << "\"messages_logged\":" << get_messages_logged() << ","
          << "\"messages_dropped\":" << get_messages_dropped() << ","
          << "\"messages_filtered\":" << get_messages_filtered() << ","
+         << "\"messages_level_rejected\":" << get_messages_level_rejected() << ","
+         << "\"messages_rate_limited\":" << get_messages_rate_limited() << ","
+         << "\"sink_errors\":" << get_sink_errors() << ","
          << "\"flushes\":" << get_flushes() << ","
          << "\"errors\":" << get_errors() << ","
          << "\"messages_per_second\":" << std::fixed << std::setprecision(2) << get_messages_per_second() << ","
@@ -195,8 +875,22 @@ std::string LogMetrics::export_json() const {
          << "\"max_log_latency_us\":" << get_max_log_latency_us() << ","
          << "\"max_flush_latency_us\":" << get_max_flush_latency_us() << ","
          << "\"current_queue_depth\":" << get_current_queue_depth() << ","
-         << "\"max_queue_depth\":" << get_max_queue_depth()
-         << "}";
+         << "\"max_queue_depth\":" << get_max_queue_depth() << ","
+         << "\"rates\":{\"logged\":";
+    export_rates_json(json, get_logged_rates());
+    json << ",\"dropped\":";
+    export_rates_json(json, get_dropped_rates());
+    json << ",\"errors\":";
+    export_rates_json(json, get_error_rates());
+    json << "},\"log_latency_ns\":";
+    log_latency_ns_.export_json(json);
+    json << ",\"flush_latency_ns\":";
+    flush_latency_ns_.export_json(json);
+    json << ",\"enqueue_to_write_ns\":";
+    enqueue_to_write_ns_.export_json(json);
+    json << ",\"batch_size\":";
+    batch_sizes_.export_json(json);
+    json << "}";
     
     return json.str();
 }
@@ -208,25 +902,37 @@ SinkMetrics::SinkMetrics(const std::string& sink_name)
 }
 
 void SinkMetrics::record_write(size_t bytes) {
-    writes_.fetch_add(1, std::memory_order_relaxed);
-    bytes_written_.fetch_add(bytes, std::memory_order_relaxed);
+    counters_.add(WRITES);
+    counters_.add(BYTES_WRITTEN, bytes);
 }
 
 void SinkMetrics::record_flush() {
-    flushes_.fetch_add(1, std::memory_order_relaxed);
+    counters_.add(FLUSHES);
 }
 
 void SinkMetrics::record_error() {
-    errors_.fetch_add(1, std::memory_order_relaxed);
+    counters_.add(ERRORS);
 }
 
 void SinkMetrics::record_write_duration(uint64_t microseconds) {
-    total_write_time_us_.fetch_add(microseconds, std::memory_order_relaxed);
+    counters_.add(WRITE_TIME_US, microseconds);
+}
+
+void SinkMetrics::record_drop() {
+    counters_.add(DROPPED);
+}
+
+void SinkMetrics::update_queue_depth(size_t depth) {
+    queue_depth_.store(depth, std::memory_order_relaxed);
+    size_t max_depth = max_queue_depth_.load(std::memory_order_relaxed);
+    while (depth > max_depth &&
+           !max_queue_depth_.compare_exchange_weak(max_depth, depth, std::memory_order_relaxed)) {
+    }
 }
 
 double SinkMetrics::get_average_write_latency_us() const {
-    uint64_t total_time = total_write_time_us_.load(std::memory_order_relaxed);
-    uint64_t count = writes_.load(std::memory_order_relaxed);
+    uint64_t total_time = counters_.load(WRITE_TIME_US);
+    uint64_t count = get_writes();
     
     if (count == 0) {
         return 0.0;
@@ -236,22 +942,13 @@ double SinkMetrics::get_average_write_latency_us() const {
 }
 
 std::string SinkMetrics::export_prometheus(const std::string& prefix) const {
-    std::ostringstream out;
-    
-    out << "# HELP " << prefix << "_sink_writes_total Total writes by sink\n"
-        << "# TYPE " << prefix << "_sink_writes_total counter\n"
-        << prefix << "_sink_writes_total{sink=\"" << name_ << "\"} " << get_writes() << "\n\n";
-    
-    out << "# HELP " << prefix << "_sink_bytes_written_total Total bytes written by sink\n"
-        << "# TYPE " << prefix << "_sink_bytes_written_total counter\n"
-        << prefix << "_sink_bytes_written_total{sink=\"" << name_ << "\"} " << get_bytes_written() << "\n\n";
-    
-    out << "# HELP " << prefix << "_sink_write_latency_us_avg Average write latency by sink\n"
-        << "# TYPE " << prefix << "_sink_write_latency_us_avg gauge\n"
-        << prefix << "_sink_write_latency_us_avg{sink=\"" << name_ << "\"} " 
-        << std::fixed << std::setprecision(2) << get_average_write_latency_us() << "\n\n";
-    
-    return out.str();
+    std::string out;
+    export_prometheus(out, prefix);
+    return out;
+}
+
+void SinkMetrics::export_prometheus(std::string& out, const std::string& prefix) const {
+    render_sink_metrics(*this, *sink_metrics_text(prefix, name_), out);
 }
 
 
@@ -287,41 +984,60 @@ std::shared_ptr<SinkMetrics> MetricsRegistry::get_sink_metrics(const std::string
 }
 
 std::map<std::string, LogMetrics::Snapshot> MetricsRegistry::get_all_logger_snapshots() const {
-    std::lock_guard<std::mutex> lock(mutex_);
+    Entries all = entries();
     
     std::map<std::string, LogMetrics::Snapshot> snapshots;
-    for (const auto& pair : logger_metrics_) {
+    for (const auto& pair : all.loggers) {
         snapshots[pair.first] = pair.second->get_snapshot();
     }
     
     return snapshots;
 }
 
-std::string MetricsRegistry::export_all_prometheus(const std::string& prefix) const {
+MetricsRegistry::Entries MetricsRegistry::entries() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    
-    std::ostringstream out;
-    
-    for (const auto& pair : logger_metrics_) {
-        out << "# Logger: " << pair.first << "\n";
-        out << pair.second->export_prometheus(prefix + "_logger");
+    Entries entries;
+    entries.loggers.assign(logger_metrics_.begin(), logger_metrics_.end());
+    entries.sinks.assign(sink_metrics_.begin(), sink_metrics_.end());
+    return entries;
+}
+
+std::string MetricsRegistry::export_all_prometheus(const std::string& prefix) const {
+    std::string out;
+    export_all_prometheus(out, prefix);
+    return out;
+}
+
+void MetricsRegistry::export_all_prometheus(std::string& out, const std::string& prefix) const {
+    // Rendering happens outside the registry lock
+    Entries all = entries();
+    std::string logger_prefix = prefix + "_logger";
+
+    // Every family is written once, with one sample per logger or sink
+    // told apart by its logger/sink label
+    PrometheusFamilies families;
+    for (const auto& pair : all.loggers) {
+        const std::string& name = pair.first;
+        auto text = cached_text<LogMetricsText>(scoped_key(logger_prefix, name), [&] {
+            return build_log_metrics_text(logger_prefix, "logger=\"" + escape_label(name) + "\"");
+        });
+        render_log_metrics(*pair.second, *text, families);
     }
-    
-    for (const auto& pair : sink_metrics_) {
-        out << pair.second->export_prometheus(prefix);
+
+    for (const auto& pair : all.sinks) {
+        render_sink_metrics(*pair.second, *sink_metrics_text(prefix, pair.second->get_name()), families);
     }
-    
-    return out.str();
+    families.append_to(out);
 }
 
 std::string MetricsRegistry::export_all_json() const {
-    std::lock_guard<std::mutex> lock(mutex_);
+    Entries all = entries();
     
     std::ostringstream json;
     json << "{\"loggers\":{";
     
     bool first_logger = true;
-    for (const auto& pair : logger_metrics_) {
+    for (const auto& pair : all.loggers) {
         if (!first_logger) json << ",";
         json << "\"" << pair.first << "\":" << pair.second->export_json();
         first_logger = false;
@@ -330,7 +1046,7 @@ std::string MetricsRegistry::export_all_json() const {
     json << "},\"sinks\":{";
     
     bool first_sink = true;
-    for (const auto& pair : sink_metrics_) {
+    for (const auto& pair : all.sinks) {
         if (!first_sink) json << ",";
         json << "\"" << pair.first << "\":{"
              << "\"writes\":" << pair.second->get_writes() << ","
@@ -338,8 +1054,15 @@ std::string MetricsRegistry::export_all_json() const {
              << "\"flushes\":" << pair.second->get_flushes() << ","
              << "\"errors\":" << pair.second->get_errors() << ","
              << "\"avg_write_latency_us\":" << std::fixed << std::setprecision(2) 
-             << pair.second->get_average_write_latency_us()
-             << "}";
+             << pair.second->get_average_write_latency_us() << ","
+             << "\"dropped\":" << pair.second->get_dropped() << ","
+             << "\"queue_depth\":" << pair.second->get_queue_depth() << ","
+             << "\"max_queue_depth\":" << pair.second->get_max_queue_depth() << ","
+             << "\"rates\":{\"bytes_written\":";
+        export_rates_json(json, pair.second->get_bytes_written_rates());
+        json << ",\"errors\":";
+        export_rates_json(json, pair.second->get_error_rates());
+        json << "}}";
         first_sink = false;
     }
     
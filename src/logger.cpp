@@ -1,9 +1,19 @@
 #include "Zyrnix/logger.hpp"
 #include "Zyrnix/log_sink.hpp"
 #include "Zyrnix/log_filter.hpp"
+#include "Zyrnix/log_context.hpp"
 #include "Zyrnix/sinks/stdout_sink.hpp"
 #include "Zyrnix/async/async_logger.hpp"
 #include "Zyrnix/log_health.hpp"
+#ifndef XLOG_NO_METRICS
+#include "Zyrnix/log_metrics.hpp"
+#endif
+#ifndef XLOG_NO_RATE_LIMITING
+#include "Zyrnix/rate_limiter.hpp"
+#endif
+#ifndef XLOG_NO_ASYNC
+#include "Zyrnix/sinks/async_sink.hpp"
+#endif
 #include <mutex>
 #include <shared_mutex>
 #include <chrono>
@@ -41,23 +51,134 @@ void Logger::set_redact_apply_to_cloud_only(bool cloud_only) {
 }
 
 Logger::Logger(std::string n) 
-    : name(std::move(n)), min_level_(LogLevel::Trace) {
+    : name(std::move(n)), interned_name_(name), min_level_(LogLevel::Trace) {
     temp_level_.active = false;
+#ifndef XLOG_NO_METRICS
+    metrics_ = MetricsRegistry::instance().get_logger_metrics(name);
+#endif
 }
 
 Logger::~Logger() {
+    flush();
+#ifndef XLOG_NO_RATE_LIMITING
+    replace_sampler(nullptr);
+#endif
     clear_sinks();
 }
 
+void Logger::flush() {
+#ifndef XLOG_NO_FILTERS
+    std::vector<LogRecord> filter_records;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        for (const auto& filter : filters_) {
+            filter->flush_pending_records(filter_records);
+        }
+    }
+    for (const auto& pending : filter_records) {
+        log_impl(pending.level, pending.message, pending.fields.span(), nullptr, 0, true);
+    }
+#endif
+#ifndef XLOG_NO_RATE_LIMITING
+    std::shared_ptr<const KeyedRateLimit> keyed;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        keyed = keyed_rate_limit_;
+    }
+    if (keyed) {
+        emit_rate_limit_summaries(*keyed, true);
+    }
+#endif
+#ifndef XLOG_NO_ASYNC
+    flush_sink_queues();
+#endif
+}
+
 void Logger::add_sink(LogSinkPtr sink) {
     add_sink(std::move(sink), "");
 }
 
 void Logger::add_sink(LogSinkPtr sink, const std::string& sink_name) {
     std::unique_lock<std::shared_mutex> lock(sinks_mtx_);
-    sink_entries_.push_back(std::make_shared<SinkEntry>(std::move(sink), sink_name));
+    auto entry = std::make_shared<SinkEntry>(std::move(sink), sink_name);
+#ifndef XLOG_NO_ASYNC
+    if (dispatch_mode_ == SinkDispatchMode::Queued) {
+        entry->worker = make_sink_worker(*entry, sink_entries_.size(), dispatch_options_);
+    }
+#endif
+    sink_entries_.push_back(std::move(entry));
 }
 
+#ifndef XLOG_NO_ASYNC
+std::string Logger::sink_metrics_name(const SinkEntry& entry, size_t index) const {
+    return name + "." + (entry.name.empty() ? "sink" + std::to_string(index) : entry.name);
+}
+
+std::shared_ptr<SinkWorker> Logger::make_sink_worker(const SinkEntry& entry, size_t index,
+                                                     const SinkQueueOptions& options) const {
+    std::string metrics_name = sink_metrics_name(entry, index);
+#ifndef XLOG_NO_METRICS
+    return std::make_shared<SinkWorker>(entry.sink, metrics_name, options, metrics_);
+#else
+    return std::make_shared<SinkWorker>(entry.sink, metrics_name, options);
+#endif
+}
+
+void Logger::set_sink_dispatch(SinkDispatchMode mode, const SinkQueueOptions& options) {
+    // Replaced workers drain and join outside the lock
+    std::vector<std::shared_ptr<SinkWorker>> retired;
+    {
+        std::unique_lock<std::shared_mutex> lock(sinks_mtx_);
+        dispatch_mode_ = mode;
+        dispatch_options_ = options;
+        for (size_t i = 0; i < sink_entries_.size(); ++i) {
+            auto& entry = sink_entries_[i];
+            if (entry->worker) {
+                retired.push_back(std::move(entry->worker));
+            }
+            if (mode == SinkDispatchMode::Queued) {
+                entry->worker = make_sink_worker(*entry, i, options);
+            }
+        }
+    }
+}
+
+SinkDispatchMode Logger::get_sink_dispatch() const {
+    std::shared_lock<std::shared_mutex> lock(sinks_mtx_);
+    return dispatch_mode_;
+}
+
+bool Logger::set_sink_queue(const std::string& sink_name, const SinkQueueOptions& options) {
+    std::shared_ptr<SinkWorker> retired;
+    std::unique_lock<std::shared_mutex> lock(sinks_mtx_);
+    for (size_t i = 0; i < sink_entries_.size(); ++i) {
+        auto& entry = sink_entries_[i];
+        if (entry->name == sink_name && !entry->marked_for_removal) {
+            retired = std::move(entry->worker);
+            entry->worker = make_sink_worker(*entry, i, options);
+            lock.unlock();
+            return true;
+        }
+    }
+    return false;
+}
+
+void Logger::flush_sink_queues() {
+    std::vector<std::shared_ptr<SinkWorker>> workers;
+    {
+        std::shared_lock<std::shared_mutex> lock(sinks_mtx_);
+        for (auto& entry : sink_entries_) {
+            if (entry->worker) {
+                workers.push_back(entry->worker);
+            }
+        }
+    }
+    for (auto& worker : workers) {
+        worker->wait_idle();
+    }
+}
+#endif
+
 void Logger::clear_sinks() {
     std::unique_lock<std::shared_mutex> lock(sinks_mtx_);
     
@@ -358,9 +479,20 @@ void Logger::add_filter(std::shared_ptr<LogFilter> filter) {
 }
 
 void Logger::clear_filters() {
-    std::lock_guard<std::mutex> lock(mtx_);
-    filters_.clear();
-    filter_func_ = nullptr;
+    std::vector<std::shared_ptr<LogFilter>> removed;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        removed.swap(filters_);
+        filter_func_ = nullptr;
+    }
+    // Summaries the removed filters still hold back are logged, not lost
+    std::vector<LogRecord> filter_records;
+    for (const auto& filter : removed) {
+        filter->flush_pending_records(filter_records);
+    }
+    for (const auto& pending : filter_records) {
+        log_impl(pending.level, pending.message, pending.fields.span(), nullptr, 0, true);
+    }
 }
 
 void Logger::set_filter_func(std::function<bool(const LogRecord&)> func) {
@@ -368,6 +500,103 @@ void Logger::set_filter_func(std::function<bool(const LogRecord&)> func) {
     filter_func_ = std::move(func);
 }
 
+#ifndef XLOG_NO_RATE_LIMITING
+void Logger::set_rate_limit(size_t messages_per_second, size_t burst) {
+    auto limiter = messages_per_second > 0
+        ? std::make_shared<RateLimiter>(messages_per_second, burst)
+        : nullptr;
+    std::lock_guard<std::mutex> lock(mtx_);
+    rate_limiter_ = std::move(limiter);
+}
+
+void Logger::clear_rate_limit() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    rate_limiter_.reset();
+}
+
+void Logger::set_callsite_rate_limit(const KeyedRateLimitOptions& options) {
+    replace_keyed_rate_limit(std::make_shared<const KeyedRateLimit>(options, std::string()));
+}
+
+void Logger::set_field_rate_limit(const std::string& field, const KeyedRateLimitOptions& options) {
+    if (field.empty()) {
+        set_callsite_rate_limit(options);
+        return;
+    }
+    replace_keyed_rate_limit(std::make_shared<const KeyedRateLimit>(options, field));
+}
+
+void Logger::clear_keyed_rate_limit() {
+    replace_keyed_rate_limit(nullptr);
+}
+
+void Logger::replace_keyed_rate_limit(std::shared_ptr<const KeyedRateLimit> keyed) {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        std::swap(keyed_rate_limit_, keyed);
+    }
+    // Report what the old limiter still counts instead of dropping it
+    if (keyed) {
+        emit_rate_limit_summaries(*keyed, true);
+    }
+}
+
+void Logger::set_adaptive_sampling(const AdaptiveSamplingOptions& options) {
+    auto sampler = std::make_shared<AdaptiveSampler>(options);
+    if (options.sinks.empty()) {
+        // Detached again before the logger goes away (see replace_sampler)
+        sampler->set_source([this](std::vector<std::shared_ptr<SinkMetrics>>& out) {
+            collect_pressure_sources(out);
+        });
+    }
+    replace_sampler(std::move(sampler));
+}
+
+void Logger::clear_adaptive_sampling() {
+    replace_sampler(nullptr);
+}
+
+void Logger::replace_sampler(std::shared_ptr<AdaptiveSampler> sampler) {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        std::swap(sampler_, sampler);
+    }
+    // adaptive_sampler() may have handed the old one out; it must not call
+    // back into this logger any more
+    if (sampler) {
+        sampler->set_source(nullptr);
+    }
+}
+
+void Logger::collect_pressure_sources(std::vector<std::shared_ptr<SinkMetrics>>& out) const {
+#if !defined(XLOG_NO_ASYNC) && !defined(XLOG_NO_METRICS)
+    std::shared_lock<std::shared_mutex> lock(sinks_mtx_);
+    for (const auto& entry : sink_entries_) {
+        if (entry->marked_for_removal.load(std::memory_order_acquire)) continue;
+        if (entry->worker) {
+            out.push_back(entry->worker->metrics());
+        }
+        if (auto* async = dynamic_cast<const AsyncSink*>(entry->sink.get())) {
+            out.push_back(async->sink_metrics());
+        }
+    }
+#else
+    (void)out;
+#endif
+}
+
+std::shared_ptr<AdaptiveSampler> Logger::adaptive_sampler() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return sampler_;
+}
+#endif
+
+#ifndef XLOG_NO_METRICS
+void Logger::set_metrics_enabled(bool enabled) {
+    metrics_enabled_.store(enabled, std::memory_order_relaxed);
+}
+#endif
+
 bool Logger::should_log(const LogRecord& record) const {
     if (record.level < min_level_.load(std::memory_order_acquire)) {
         return false;
@@ -382,43 +611,325 @@ bool Logger::should_log(const LogRecord& record) const {
             return false;
         }
     }
+
+    // Stateful filters only see records every filter accepted
+    for (const auto& filter : filters_) {
+        if (!filter->commit(record)) {
+            return false;
+        }
+    }
     
     return true;
 }
 
-void Logger::log(LogLevel level, const std::string& message) {
-    check_temporary_level_expiry();
-    
+namespace {
+
+struct ThreadRecord {
     LogRecord record;
-    record.logger_name = name;
+    bool in_use = false;
+};
+
+thread_local ThreadRecord thread_record;
+
+// Marks the thread's record busy for one log() call. On release the context
+// snapshot is dropped so the record does not pin the thread's context (which
+// would make the next LogContext::set() copy it).
+class RecordLease {
+public:
+    explicit RecordLease(bool active) : active_(active) {
+        if (active_) thread_record.in_use = true;
+    }
+    ~RecordLease() {
+        if (active_) {
+            thread_record.record.context = ContextSnapshot();
+            thread_record.in_use = false;
+        }
+    }
+
+    RecordLease(const RecordLease&) = delete;
+    RecordLease& operator=(const RecordLease&) = delete;
+
+private:
+    bool active_;
+};
+
+#ifndef XLOG_NO_METRICS
+// Log calls timed per thread: one in LATENCY_SAMPLE_MASK + 1. Two clock
+// reads on every call would cost more than the rest of the metrics.
+constexpr uint32_t LATENCY_SAMPLE_MASK = 15;
+thread_local uint32_t latency_sample_counter = 0;
+
+// Records the duration of a sampled log() call that reached the sinks
+class LatencySample {
+public:
+    explicit LatencySample(LogMetrics* metrics)
+        : metrics_((metrics && (++latency_sample_counter & LATENCY_SAMPLE_MASK) == 0) ? metrics : nullptr) {
+        if (metrics_) start_ = std::chrono::steady_clock::now();
+    }
+    void finish() {
+        if (metrics_) {
+            metrics_->record_log_latency_ns(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start_).count()));
+        }
+    }
+
+private:
+    LogMetrics* metrics_;
+    std::chrono::steady_clock::time_point start_;
+};
+#endif
+
+}
+
+#ifndef XLOG_NO_RATE_LIMITING
+struct Logger::KeyedRateLimit {
+    KeyedRateLimit(const KeyedRateLimitOptions& options, std::string key_field)
+        : limiter(options), field(std::move(key_field)) {}
+
+    mutable KeyedRateLimiter limiter;
+    std::string field; // Empty: key by callsite
+};
+
+namespace {
+
+// Longest message prefix kept as the label of a text-keyed message
+constexpr size_t MESSAGE_LABEL_CHARS = 80;
+
+uint64_t mix_key(uint64_t x) {
+    // splitmix64 finalizer; KeyedRateLimiter shards on the high bits
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+/**
+ * @brief Per-key rate limit decision for one record
+ *
+ * Messages without a key (field mode, field not set) always pass.
+ */
+bool keyed_rate_limit_allows(KeyedRateLimiter& limiter, const std::string& field, const LogRecord& record,
+                             FieldSpan fields, const char* file, int line, bool& summaries_due) {
+    if (field.empty()) {
+        if (file) {
+            // __FILE__ literals are unique per file, so the pointer identifies it
+            uint64_t key = mix_key(reinterpret_cast<uintptr_t>(file) ^ (static_cast<uint64_t>(line) << 40));
+            return limiter.try_log(key, record.level, file, line, &summaries_due);
+        }
+        std::string_view text(record.message);
+        uint64_t key = mix_key(std::hash<std::string_view>{}(text));
+        return limiter.try_log(key, record.level, text.substr(0, MESSAGE_LABEL_CHARS), -1, &summaries_due);
+    }
+
+    thread_local std::string scratch;
+    std::string_view value;
+    bool found = false;
+    for (const auto& f : fields) {
+        if (f.key == field) {
+            if (f.value.type() == FieldValue::Type::String) {
+                value = f.value.as_string();
+            } else {
+                scratch.clear();
+                f.value.append_text(scratch);
+                value = scratch;
+            }
+            found = true;
+            break;
+        }
+    }
+#ifndef XLOG_NO_CONTEXT
+    if (!found) {
+        if (const std::string* ctx = record.context.find(field)) {
+            value = *ctx;
+            found = true;
+        }
+    }
+#endif
+    if (!found) {
+        summaries_due = true; // No clock read here; collect_summaries() checks
+        return true;
+    }
+    uint64_t key = mix_key(std::hash<std::string_view>{}(value));
+    return limiter.try_log(key, record.level, value, -1, &summaries_due);
+}
+
+}
+
+void Logger::emit_rate_limit_summaries(const KeyedRateLimit& keyed, bool drain) {
+    std::vector<KeyedRateLimiter::Summary> summaries;
+    bool collected = drain ? keyed.limiter.drain_summaries(summaries)
+                           : keyed.limiter.collect_summaries(summaries);
+    if (!collected) {
+        return;
+    }
+    for (const auto& summary : summaries) {
+        std::string key;
+        std::string message = "Suppressed " + std::to_string(summary.suppressed) + " messages ";
+        if (summary.label.empty()) {
+            message += "from keys evicted before their summary";
+        } else if (summary.line >= 0) {
+            key = summary.label + ":" + std::to_string(summary.line);
+            message += "from " + key;
+        } else if (keyed.field.empty()) {
+            key = summary.label;
+            message += "like \"" + key + "\"";
+        } else {
+            key = keyed.field + "=" + summary.label;
+            message += "with " + key;
+        }
+        Field fields[] = {
+            {"suppressed", FieldValue(summary.suppressed)},
+            {"rate_limit_key", FieldValue(key)},
+        };
+        log_impl(summary.level, message, FieldSpan(fields), nullptr, 0, true);
+    }
+}
+#endif
+
+void Logger::log(LogLevel level, const std::string& message, std::source_location where) {
+    log_impl(level, message, FieldSpan(), where.file_name(), static_cast<int>(where.line()), false);
+}
+
+void Logger::log(LogLevel level, const std::string& message, FieldSpan fields, std::source_location where) {
+    log_impl(level, message, fields, where.file_name(), static_cast<int>(where.line()), false);
+}
+
+void Logger::log_at(const char* file, int line, LogLevel level, const std::string& message) {
+    log_impl(level, message, FieldSpan(), file, line, false);
+}
+
+void Logger::log_impl(LogLevel level, const std::string& message, FieldSpan fields,
+                      const char* file, int line, bool is_summary) {
+    check_temporary_level_expiry();
+#ifndef XLOG_NO_METRICS
+    LogMetrics* metrics = active_metrics();
+#endif
+    if (level < min_level_.load(std::memory_order_acquire)) {
+#ifndef XLOG_NO_METRICS
+        if (metrics) metrics->record_message_level_rejected();
+#endif
+        return;
+    }
+#ifndef XLOG_NO_METRICS
+    LatencySample latency(metrics);
+#endif
+
+    // Each thread reuses one record, so building it does not allocate once
+    // its buffers have grown. A sink that logs from inside log() gets a
+    // fresh record instead.
+    LogRecord fallback;
+    const bool reuse = !thread_record.in_use;
+    LogRecord& record = reuse ? thread_record.record : fallback;
+    RecordLease lease(reuse);
+
+    record.logger_name = interned_name_;
     record.level = level;
+    record.message.assign(message);
+    record.timestamp = std::chrono::system_clock::now();
+    record.fields.assign(fields);
+#ifndef XLOG_NO_CONTEXT
+    record.context = LogContext::snapshot();
+#endif
     
     // Copy redaction configuration under lock
     std::vector<std::string> substr_patterns;
     std::vector<std::string> regex_patterns;
     std::vector<std::string> pii_presets;
     bool redact_cloud_only = false;
+#ifndef XLOG_NO_RATE_LIMITING
+    std::shared_ptr<RateLimiter> rate_limiter;
+    std::shared_ptr<const KeyedRateLimit> keyed;
+    std::shared_ptr<AdaptiveSampler> sampler;
+#endif
+#ifndef XLOG_NO_FILTERS
+    // Records filters want logged ahead of this one, e.g. repeat summaries
+    std::vector<LogRecord> filter_records;
+#endif
 
     {
         std::lock_guard<std::mutex> lock(mtx_);
-        if (!should_log(record)) {
+        // Summaries report messages the filters and limiters already passed
+        // judgement on: running them through the filters again would let a
+        // DedupFilter count them or a Level/Regex filter drop them
+        if (!is_summary && !should_log(record)) {
+#ifndef XLOG_NO_METRICS
+            if (metrics) {
+                // The level may have been raised since the check above
+                if (level < min_level_.load(std::memory_order_acquire)) {
+                    metrics->record_message_level_rejected();
+                } else {
+                    metrics->record_message_filtered();
+                }
+            }
+#endif
             return;
         }
+#ifndef XLOG_NO_FILTERS
+        if (!is_summary) {
+            for (const auto& filter : filters_) {
+                filter->take_pending_records(record, filter_records);
+            }
+        }
+#endif
         substr_patterns = redact_patterns_;
         regex_patterns = redact_regex_patterns_;
         pii_presets = redact_pii_presets_;
         redact_cloud_only = redact_cloud_only_;
+#ifndef XLOG_NO_RATE_LIMITING
+        if (!is_summary) {
+            rate_limiter = rate_limiter_;
+            keyed = keyed_rate_limit_;
+            sampler = sampler_;
+        }
+#endif
+    }
+
+#ifndef XLOG_NO_FILTERS
+    for (const auto& pending : filter_records) {
+        log_impl(pending.level, pending.message, pending.fields.span(), nullptr, 0, true);
+    }
+#endif
+#ifndef XLOG_NO_RATE_LIMITING
+    if (sampler && !sampler->should_log(level)) {
+#ifndef XLOG_NO_METRICS
+        if (metrics) metrics->record_message_rate_limited();
+#endif
+        return;
+    }
+    if (keyed) {
+        bool summaries_due = false;
+        bool allowed = keyed_rate_limit_allows(keyed->limiter, keyed->field, record, fields,
+                                               file, line, summaries_due);
+        if (summaries_due) {
+            // Logged ahead of this message, through a record of their own
+            emit_rate_limit_summaries(*keyed);
+        }
+        if (!allowed) {
+#ifndef XLOG_NO_METRICS
+            if (metrics) metrics->record_message_rate_limited();
+#endif
+            return;
+        }
+    }
+    if (rate_limiter && !rate_limiter->try_log()) {
+#ifndef XLOG_NO_METRICS
+        if (metrics) metrics->record_message_rate_limited();
+#endif
+        return;
     }
+#endif
+#ifndef XLOG_NO_METRICS
+    if (metrics) metrics->record_message_logged();
+#endif
 
     // Apply redaction once and reuse for sinks that require it
-    std::string redacted_message = message;
+    LogRecord redacted;
     bool has_redaction = false;
 
     if (!substr_patterns.empty() || !regex_patterns.empty() || !pii_presets.empty()) {
-        if (!substr_patterns.empty()) {
-            redacted_message = Formatter::redact(redacted_message, substr_patterns);
-        }
-
         std::vector<std::regex> compiled;
         compiled.reserve(regex_patterns.size() + pii_presets.size());
 
@@ -449,13 +960,60 @@ void Logger::log(LogLevel level, const std::string& message) {
             }
         }
 
-        for (const auto& rx : compiled) {
-            redacted_message = std::regex_replace(redacted_message, rx, "***");
+        auto redact = [&](std::string text) {
+            if (!substr_patterns.empty()) {
+                text = Formatter::redact(text, substr_patterns);
+            }
+            for (const auto& rx : compiled) {
+                text = std::regex_replace(text, rx, "***");
+            }
+            return text;
+        };
+
+        // Sinks see string field values and context values as well as the
+        // message, so all of them are redacted
+        std::string redacted_message = redact(record.message);
+        bool message_changed = redacted_message != record.message;
+
+        std::vector<std::pair<std::string_view, std::string>> redacted_fields;
+        for (const auto& field : record.fields.span()) {
+            if (field.value.type() != FieldValue::Type::String) continue;
+            std::string value(field.value.as_string());
+            std::string redacted_value = redact(value);
+            if (redacted_value != value) {
+                redacted_fields.emplace_back(field.key, std::move(redacted_value));
+            }
+        }
+
+        bool context_changed = false;
+        ContextSnapshot::Entries redacted_context;
+        if (!record.context.empty()) {
+            redacted_context.reserve(record.context.size());
+            for (const auto& [key, value] : record.context) {
+                redacted_context.emplace_back(key, redact(value));
+                context_changed = context_changed || redacted_context.back().second != value;
+            }
         }
 
-        has_redaction = (redacted_message != message);
+        has_redaction = message_changed || !redacted_fields.empty() || context_changed;
+        if (has_redaction) {
+            redacted = record;
+            redacted.message = std::move(redacted_message);
+            for (const auto& [key, value] : redacted_fields) {
+                redacted.fields.set(key, FieldValue(std::string_view(value)));
+            }
+            if (context_changed) {
+                redacted.context = ContextSnapshot(std::move(redacted_context));
+            }
+        }
     }
 
+#ifndef XLOG_NO_ASYNC
+    // Shared by all queued sinks; built on first use
+    SinkWorker::RecordPtr queued_record;
+    SinkWorker::RecordPtr queued_redacted;
+#endif
+
     std::shared_lock<std::shared_mutex> sinks_lock(sinks_mtx_);
     for (size_t i = 0; i < sink_entries_.size(); ++i) {
         auto& entry = sink_entries_[i];
@@ -468,22 +1026,83 @@ void Logger::log(LogLevel level, const std::string& message) {
                 continue;
             }
         }
+#ifndef XLOG_NO_ASYNC
+        if (entry->worker) {
+            const bool use_redacted = has_redaction && (!redact_cloud_only || entry->sink->is_cloud_sink());
+            auto& queued = use_redacted ? queued_redacted : queued_record;
+            if (!queued) {
+                queued = std::make_shared<const LogRecord>(use_redacted ? redacted : record);
+            }
+            if (!entry->worker->submit(queued)) {
+#ifndef XLOG_NO_METRICS
+                if (metrics) metrics->record_message_dropped();
+#endif
+            }
+            continue;
+        }
+#endif
         SinkGuard guard(entry);
         if (guard) {
             const bool is_cloud = guard->is_cloud_sink();
             const bool use_redacted = has_redaction && (!redact_cloud_only || is_cloud);
-            const std::string& msg_to_log = use_redacted ? redacted_message : message;
-            guard->log(name, level, msg_to_log);
+            // A failing sink must not take the caller or the other sinks down
+            try {
+                guard->log_record(use_redacted ? redacted : record);
+            } catch (...) {
+#ifndef XLOG_NO_METRICS
+                if (metrics) metrics->record_sink_error();
+#endif
+            }
         }
     }
+#ifndef XLOG_NO_METRICS
+    latency.finish();
+#endif
+}
+
+void Logger::trace(const std::string& msg, std::source_location where) {
+    log(LogLevel::Trace, msg, where);
+}
+void Logger::debug(const std::string& msg, std::source_location where) {
+    log(LogLevel::Debug, msg, where);
+}
+void Logger::info(const std::string& msg, std::source_location where) {
+    log(LogLevel::Info, msg, where);
+}
+void Logger::warn(const std::string& msg, std::source_location where) {
+    log(LogLevel::Warn, msg, where);
+}
+void Logger::error(const std::string& msg, std::source_location where) {
+    log(LogLevel::Error, msg, where);
+}
+void Logger::critical(const std::string& msg, std::source_location where) {
+    log(LogLevel::Critical, msg, where);
 }
 
-void Logger::trace(const std::string& msg) { log(LogLevel::Trace, msg); }
-void Logger::debug(const std::string& msg) { log(LogLevel::Debug, msg); }
-void Logger::info(const std::string& msg) { log(LogLevel::Info, msg); }
-void Logger::warn(const std::string& msg) { log(LogLevel::Warn, msg); }
-void Logger::error(const std::string& msg) { log(LogLevel::Error, msg); }
-void Logger::critical(const std::string& msg) { log(LogLevel::Critical, msg); }
+void Logger::trace(const std::string& msg, std::initializer_list<Field> fields,
+                   std::source_location where) {
+    log(LogLevel::Trace, msg, FieldSpan(fields.begin(), fields.size()), where);
+}
+void Logger::debug(const std::string& msg, std::initializer_list<Field> fields,
+                   std::source_location where) {
+    log(LogLevel::Debug, msg, FieldSpan(fields.begin(), fields.size()), where);
+}
+void Logger::info(const std::string& msg, std::initializer_list<Field> fields,
+                  std::source_location where) {
+    log(LogLevel::Info, msg, FieldSpan(fields.begin(), fields.size()), where);
+}
+void Logger::warn(const std::string& msg, std::initializer_list<Field> fields,
+                  std::source_location where) {
+    log(LogLevel::Warn, msg, FieldSpan(fields.begin(), fields.size()), where);
+}
+void Logger::error(const std::string& msg, std::initializer_list<Field> fields,
+                   std::source_location where) {
+    log(LogLevel::Error, msg, FieldSpan(fields.begin(), fields.size()), where);
+}
+void Logger::critical(const std::string& msg, std::initializer_list<Field> fields,
+                      std::source_location where) {
+    log(LogLevel::Critical, msg, FieldSpan(fields.begin(), fields.size()), where);
+}
 
 std::shared_ptr<Logger> Logger::create_stdout_logger(const std::string& name) {
     auto logger = std::make_shared<Logger>(name);
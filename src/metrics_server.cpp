@@ -0,0 +1,540 @@
+#include "Zyrnix/metrics_server.hpp"
+#include "Zyrnix/log_metrics.hpp"
+#include "Zyrnix/log_health.hpp"
+#include "Zyrnix/logger.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace Zyrnix {
+
+namespace {
+
+constexpr uint64_t LISTEN_TOKEN = UINT64_MAX;
+constexpr uint64_t WAKE_TOKEN = UINT64_MAX - 1;
+
+const char* reason_phrase(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 413: return "Payload Too Large";
+        case 500: return "Internal Server Error";
+        case 503: return "Service Unavailable";
+        default: return "Unknown";
+    }
+}
+
+bool iequals(std::string_view a, std::string_view b) {
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+               return std::tolower(static_cast<unsigned char>(x)) ==
+                      std::tolower(static_cast<unsigned char>(y));
+           });
+}
+
+int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+std::string url_decode(std::string_view in) {
+    std::string out;
+    out.reserve(in.size());
+    for (size_t i = 0; i < in.size(); ++i) {
+        if (in[i] == '+') {
+            out += ' ';
+        } else if (in[i] == '%' && i + 2 < in.size() &&
+                   hex_value(in[i + 1]) >= 0 && hex_value(in[i + 2]) >= 0) {
+            out += static_cast<char>(hex_value(in[i + 1]) * 16 + hex_value(in[i + 2]));
+            i += 2;
+        } else {
+            out += in[i];
+        }
+    }
+    return out;
+}
+
+// Value of @p key in an application/x-www-form-urlencoded string
+bool form_param(std::string_view form, std::string_view key, std::string& value) {
+    while (!form.empty()) {
+        size_t amp = form.find('&');
+        std::string_view pair = form.substr(0, amp);
+        size_t eq = pair.find('=');
+        if (pair.substr(0, eq) == key) {
+            value = eq == std::string_view::npos ? std::string() : url_decode(pair.substr(eq + 1));
+            return true;
+        }
+        if (amp == std::string_view::npos) break;
+        form.remove_prefix(amp + 1);
+    }
+    return false;
+}
+
+void set_error(MetricsServer::Response& response, int status) {
+    response.status = status;
+    response.content_type = "text/plain; charset=utf-8";
+    response.body.assign(reason_phrase(status)).append("\n");
+}
+
+void append_number(std::string& out, uint64_t value) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, result.ptr);
+}
+
+}
+
+MetricsServer::MetricsServer(const MetricsServerOptions& options)
+    : options_(options) {
+    if (options_.max_connections == 0) {
+        options_.max_connections = 1;
+    }
+}
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+void MetricsServer::handle(const std::string& method, const std::string& target, const std::string& body,
+                           Response& response) const {
+    std::string_view view(target);
+    size_t question = view.find('?');
+    std::string_view path = view.substr(0, question);
+    std::string_view query = question == std::string_view::npos ? std::string_view() : view.substr(question + 1);
+    auto param = [&](std::string_view key) {
+        std::string value;
+        if (!form_param(query, key, value)) {
+            form_param(body, key, value);
+        }
+        return value;
+    };
+
+    response.status = 200;
+    response.content_type = "application/json";
+    response.body.clear();
+
+    if (path == "/metrics") {
+        if (method != "GET") {
+            set_error(response, 405);
+            return;
+        }
+        response.content_type = "text/plain; version=0.0.4; charset=utf-8";
+        MetricsRegistry::instance().export_all_prometheus(response.body, options_.prometheus_prefix);
+    } else if (path == "/health") {
+        if (method != "GET") {
+            set_error(response, 405);
+            return;
+        }
+        auto& registry = HealthRegistry::instance();
+        std::string name = param("logger");
+        HealthStatus status;
+        if (name.empty()) {
+            status = registry.get_overall_status();
+            response.body.assign(registry.export_json());
+        } else {
+            HealthCheckResult result = registry.check_logger(name);
+            status = result.status;
+            response.body.assign(result.to_json());
+        }
+        // Load balancers and probes only look at the status code
+        response.status = status == HealthStatus::Unhealthy ? 503 : 200;
+    } else if (path == "/loglevel" && options_.enable_level_control) {
+        if (method != "POST") {
+            set_error(response, 405);
+            return;
+        }
+        std::string name = param("logger");
+        std::shared_ptr<Logger> logger = options_.logger_lookup
+            ? options_.logger_lookup(name)
+            : HealthRegistry::instance().find_logger(name);
+        int duration = 0;
+        std::string duration_str = param("duration");
+        std::from_chars(duration_str.data(), duration_str.data() + duration_str.size(), duration);
+        LogLevelControlResponse result =
+            handle_level_change_request(logger, param("level"), param("reason"), duration);
+        response.status = result.success ? 200 : (logger ? 400 : 404);
+        response.body.assign(result.to_json());
+    } else {
+        set_error(response, 404);
+    }
+}
+
+#ifdef __linux__
+
+bool MetricsServer::start() {
+    if (running()) return false;
+
+    struct addrinfo hints;
+    struct addrinfo* res = nullptr;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE | AI_NUMERICSERV;
+
+    std::string port_str = std::to_string(options_.port);
+    const char* host = options_.bind_address.empty() ? nullptr : options_.bind_address.c_str();
+    if (getaddrinfo(host, port_str.c_str(), &hints, &res) != 0) {
+        return false;
+    }
+    for (struct addrinfo* p = res; p != nullptr; p = p->ai_next) {
+        int fd = socket(p->ai_family, p->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, p->ai_protocol);
+        if (fd == -1) continue;
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (bind(fd, p->ai_addr, p->ai_addrlen) == 0 && listen(fd, 64) == 0) {
+            listen_fd_ = fd;
+            break;
+        }
+        close(fd);
+    }
+    freeaddrinfo(res);
+    if (listen_fd_ == -1) {
+        return false;
+    }
+
+    struct sockaddr_storage addr;
+    socklen_t addr_len = sizeof(addr);
+    if (getsockname(listen_fd_, reinterpret_cast<struct sockaddr*>(&addr), &addr_len) == 0) {
+        bound_port_ = addr.ss_family == AF_INET6
+            ? ntohs(reinterpret_cast<struct sockaddr_in6*>(&addr)->sin6_port)
+            : ntohs(reinterpret_cast<struct sockaddr_in*>(&addr)->sin_port);
+    }
+
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    bool ok = epoll_fd_ != -1 && wake_fd_ != -1;
+    if (ok) {
+        struct epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = LISTEN_TOKEN;
+        ok = epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd_, &ev) == 0;
+        ev.data.u64 = WAKE_TOKEN;
+        ok = ok && epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &ev) == 0;
+    }
+    if (!ok) {
+        if (epoll_fd_ != -1) close(epoll_fd_);
+        if (wake_fd_ != -1) close(wake_fd_);
+        close(listen_fd_);
+        epoll_fd_ = wake_fd_ = listen_fd_ = -1;
+        return false;
+    }
+
+    // Every buffer the server needs is allocated here, up front
+    connections_.assign(options_.max_connections, Connection{});
+    for (auto& conn : connections_) {
+        conn.in.reserve(options_.max_request_bytes);
+        conn.out.reserve(4096);
+    }
+
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread([this] { run(); });
+    return true;
+}
+
+void MetricsServer::stop() {
+    if (!running_.exchange(false, std::memory_order_acq_rel)) return;
+    uint64_t one = 1;
+    ssize_t ignored = write(wake_fd_, &one, sizeof(one));
+    (void)ignored;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    for (auto& conn : connections_) {
+        if (conn.fd != -1) close_connection(conn);
+    }
+    close(epoll_fd_);
+    close(wake_fd_);
+    close(listen_fd_);
+    epoll_fd_ = wake_fd_ = listen_fd_ = -1;
+}
+
+void MetricsServer::run() {
+    struct epoll_event events[32];
+    auto last_sweep = std::chrono::steady_clock::now();
+
+    while (running_.load(std::memory_order_acquire)) {
+        int n = epoll_wait(epoll_fd_, events, 32, 1000);
+        if (n < 0 && errno != EINTR) break;
+
+        for (int i = 0; i < n; ++i) {
+            uint64_t token = events[i].data.u64;
+            if (token == WAKE_TOKEN) {
+                return;
+            }
+            if (token == LISTEN_TOKEN) {
+                accept_clients();
+                continue;
+            }
+            Connection& conn = connections_[token];
+            if (conn.fd == -1) continue; // Closed earlier in this batch
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                close_connection(conn);
+            } else if (events[i].events & EPOLLOUT) {
+                on_writable(conn);
+            } else if (events[i].events & EPOLLIN) {
+                on_readable(conn);
+            }
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_sweep >= std::chrono::seconds(1)) {
+            close_idle();
+            last_sweep = now;
+        }
+    }
+}
+
+void MetricsServer::accept_clients() {
+    while (true) {
+        int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd == -1) return; // EAGAIN, or a transient error; epoll reports again
+
+        auto slot = std::find_if(connections_.begin(), connections_.end(),
+                                 [](const Connection& conn) { return conn.fd == -1; });
+        if (slot == connections_.end()) {
+            close(fd);
+            continue;
+        }
+        slot->fd = fd;
+        slot->in.clear();
+        slot->out.clear();
+        slot->out_pos = 0;
+        slot->close_after_write = false;
+        slot->watching_write = false;
+        slot->peer_closed = false;
+        slot->last_active = std::chrono::steady_clock::now();
+
+        struct epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.u64 = static_cast<uint64_t>(slot - connections_.begin());
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            close(fd);
+            slot->fd = -1;
+        }
+    }
+}
+
+void MetricsServer::on_readable(Connection& conn) {
+    char buffer[4096];
+    while (true) {
+        // One byte past the limit is enough to reject an oversized request.
+        // Once full, the rest stays in the kernel; epoll reports it again
+        // after serve() has consumed complete requests.
+        size_t room = options_.max_request_bytes + 1 - std::min(conn.in.size(), options_.max_request_bytes + 1);
+        if (room == 0) break;
+        ssize_t got = recv(conn.fd, buffer, std::min(sizeof(buffer), room), 0);
+        if (got > 0) {
+            conn.in.append(buffer, static_cast<size_t>(got));
+            continue;
+        }
+        if (got == 0) {
+            // Half-close: the requests already buffered still get their answers
+            conn.peer_closed = true;
+            break;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            close_connection(conn);
+            return;
+        }
+        if (errno != EINTR) break;
+    }
+    conn.last_active = std::chrono::steady_clock::now();
+    serve(conn);
+}
+
+void MetricsServer::on_writable(Connection& conn) {
+    serve(conn);
+}
+
+void MetricsServer::serve(Connection& conn) {
+    // A loop, not recursion: a client may pipeline any number of requests
+    while (conn.fd != -1) {
+        if (conn.out_pos < conn.out.size()) {
+            if (!write_pending(conn)) return;
+            continue;
+        }
+        if (conn.in.empty() || !process_request(conn)) break;
+    }
+    if (conn.fd == -1) return;
+    if (conn.peer_closed) {
+        // Everything answerable has been written; nothing more will arrive
+        close_connection(conn);
+    } else if (conn.watching_write) {
+        watch(conn, false);
+    }
+}
+
+bool MetricsServer::process_request(Connection& conn) {
+    size_t header_end = conn.in.find("\r\n\r\n");
+    if (header_end == std::string::npos) {
+        if (conn.in.size() > options_.max_request_bytes) {
+            reject(conn, 413);
+            return true;
+        }
+        return false;
+    }
+
+    std::string_view head(conn.in.data(), header_end);
+    size_t line_end = head.find("\r\n");
+    std::string_view request_line = head.substr(0, line_end);
+    size_t sp1 = request_line.find(' ');
+    size_t sp2 = request_line.rfind(' ');
+    if (sp1 == std::string_view::npos || sp2 == sp1) {
+        reject(conn, 400);
+        return true;
+    }
+    std::string_view version = request_line.substr(sp2 + 1);
+
+    size_t content_length = 0;
+    bool bad_length = false;
+    bool keep_alive = version == "HTTP/1.1";
+    std::string_view headers = line_end == std::string_view::npos ? std::string_view() : head.substr(line_end + 2);
+    while (!headers.empty()) {
+        size_t end = headers.find("\r\n");
+        std::string_view line = headers.substr(0, end);
+        size_t colon = line.find(':');
+        if (colon != std::string_view::npos) {
+            std::string_view name = line.substr(0, colon);
+            std::string_view value = line.substr(colon + 1);
+            while (!value.empty() && value.front() == ' ') value.remove_prefix(1);
+            while (!value.empty() && value.back() == ' ') value.remove_suffix(1);
+            if (iequals(name, "Content-Length")) {
+                auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), content_length);
+                bad_length = ec != std::errc() || ptr != value.data() + value.size();
+            } else if (iequals(name, "Connection")) {
+                keep_alive = iequals(value, "keep-alive") || (keep_alive && !iequals(value, "close"));
+            }
+        }
+        if (end == std::string_view::npos) break;
+        headers.remove_prefix(end + 2);
+    }
+    if (bad_length) {
+        reject(conn, 400);
+        return true;
+    }
+
+    size_t body_start = header_end + 4;
+    // Compared this way round so a huge Content-Length cannot wrap the sum
+    if (body_start > options_.max_request_bytes || content_length > options_.max_request_bytes - body_start) {
+        reject(conn, 413);
+        return true;
+    }
+    if (conn.in.size() - body_start < content_length) {
+        return false; // Rest of the body still in flight
+    }
+
+    std::string method(request_line.substr(0, sp1));
+    std::string target(request_line.substr(sp1 + 1, sp2 - sp1 - 1));
+    std::string body = conn.in.substr(body_start, content_length);
+    conn.in.erase(0, body_start + content_length);
+
+    try {
+        handle(method, target, body, response_);
+    } catch (...) {
+        set_error(response_, 500);
+    }
+    queue_response(conn, response_, keep_alive);
+    return true;
+}
+
+void MetricsServer::reject(Connection& conn, int status) {
+    set_error(response_, status);
+    conn.in.clear();
+    queue_response(conn, response_, false);
+}
+
+void MetricsServer::queue_response(Connection& conn, const Response& response, bool keep_alive) {
+    std::string& out = conn.out;
+    out.clear();
+    out.append("HTTP/1.1 ");
+    append_number(out, static_cast<uint64_t>(response.status));
+    out.append(" ").append(reason_phrase(response.status)).append("\r\nContent-Type: ");
+    out.append(response.content_type).append("\r\nContent-Length: ");
+    append_number(out, response.body.size());
+    out.append(keep_alive ? "\r\nConnection: keep-alive\r\n\r\n" : "\r\nConnection: close\r\n\r\n");
+    out.append(response.body);
+    conn.out_pos = 0;
+    conn.close_after_write = !keep_alive;
+}
+
+bool MetricsServer::write_pending(Connection& conn) {
+    while (conn.out_pos < conn.out.size()) {
+        ssize_t sent = send(conn.fd, conn.out.data() + conn.out_pos, conn.out.size() - conn.out_pos, MSG_NOSIGNAL);
+        if (sent > 0) {
+            conn.out_pos += static_cast<size_t>(sent);
+            continue;
+        }
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            watch(conn, true);
+            return false;
+        }
+        close_connection(conn);
+        return false;
+    }
+
+    conn.out.clear();
+    conn.out_pos = 0;
+    conn.last_active = std::chrono::steady_clock::now();
+    if (conn.close_after_write) {
+        close_connection(conn);
+        return false;
+    }
+    return true;
+}
+
+void MetricsServer::watch(Connection& conn, bool writing) {
+    struct epoll_event ev{};
+    ev.events = writing ? EPOLLOUT : (EPOLLIN | EPOLLRDHUP);
+    ev.data.u64 = static_cast<uint64_t>(&conn - connections_.data());
+    epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, conn.fd, &ev);
+    conn.watching_write = writing;
+}
+
+void MetricsServer::close_connection(Connection& conn) {
+    if (epoll_fd_ != -1) {
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, conn.fd, nullptr);
+    }
+    close(conn.fd);
+    conn.fd = -1;
+    conn.in.clear();
+    conn.out.clear();
+    conn.out_pos = 0;
+}
+
+void MetricsServer::close_idle() {
+    auto cutoff = std::chrono::steady_clock::now() - options_.idle_timeout;
+    for (auto& conn : connections_) {
+        if (conn.fd != -1 && conn.last_active < cutoff) {
+            close_connection(conn);
+        }
+    }
+}
+
+#else
+
+bool MetricsServer::start() {
+    return false;
+}
+
+void MetricsServer::stop() {
+}
+
+#endif
+
+}
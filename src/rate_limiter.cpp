@@ -1,15 +1,84 @@
 #include "Zyrnix/rate_limiter.hpp"
+#ifndef XLOG_NO_METRICS
+#include "Zyrnix/log_metrics.hpp"
+#endif
 #include <algorithm>
 
 namespace Zyrnix {
 
+namespace {
+
+struct ThreadTokens {
+    uint64_t owner = 0; // RateLimiter cache id the tokens belong to
+    uint64_t tokens = 0;
+};
+
+// A few limiters per thread keep their tokens side by side, so a thread
+// alternating between loggers does not forfeit its batch on every switch
+constexpr size_t TOKEN_CACHE_SLOTS = 8;
+thread_local ThreadTokens thread_tokens[TOKEN_CACHE_SLOTS];
+
+// The slot holding @p id's tokens, else the one to reuse for it: the slot
+// with the fewest tokens (empty and stale slots have none left)
+ThreadTokens& token_slot(uint64_t id) {
+    ThreadTokens* victim = &thread_tokens[0];
+    for (auto& slot : thread_tokens) {
+        if (slot.owner == id) {
+            return slot;
+        }
+        if (slot.tokens < victim->tokens) {
+            victim = &slot;
+        }
+    }
+    return *victim;
+}
+
+uint64_t next_cache_id() {
+    static std::atomic<uint64_t> next{1};
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+}
+
 RateLimiter::RateLimiter(size_t messages_per_second, size_t burst_capacity)
     : max_tokens_(burst_capacity > 0 ? burst_capacity : messages_per_second)
     , refill_rate_(messages_per_second)
-    , tokens_(static_cast<double>(max_tokens_))
-    , last_refill_(std::chrono::steady_clock::now())
+    , epoch_(std::chrono::steady_clock::now())
     , dropped_count_(0)
+    , cache_id_(next_cache_id())
 {
+    if (refill_rate_ > 0) {
+        interval_ns_ = std::max<int64_t>(1, static_cast<int64_t>(1e9 / static_cast<double>(refill_rate_) + 0.5));
+    } else {
+        // Burst only: tokens effectively never come back
+        interval_ns_ = INT64_MAX / 4 / static_cast<int64_t>(std::max<size_t>(max_tokens_, 1));
+    }
+    burst_ns_ = interval_ns_ * static_cast<int64_t>(max_tokens_);
+}
+
+int64_t RateLimiter::now_ns() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - epoch_).count();
+}
+
+uint64_t RateLimiter::acquire(uint64_t wanted) {
+    int64_t now = now_ns();
+    int64_t full_at = full_at_.load(std::memory_order_relaxed);
+    while (true) {
+        int64_t base = std::max(full_at, now);
+        uint64_t granted = wanted;
+        int64_t next = base + static_cast<int64_t>(granted) * interval_ns_;
+        if (next - now > burst_ns_) {
+            granted = 1;
+            next = base + interval_ns_;
+            if (next - now > burst_ns_) {
+                return 0;
+            }
+        }
+        if (full_at_.compare_exchange_weak(full_at, next, std::memory_order_relaxed)) {
+            return granted;
+        }
+    }
 }
 
 bool RateLimiter::try_log() {
@@ -17,12 +86,23 @@ bool RateLimiter::try_log() {
         return true;
     }
 
-    std::lock_guard<std::mutex> lock(mutex_);
-    refill_tokens();
-
-    double current = tokens_.load(std::memory_order_relaxed);
-    if (current >= 1.0) {
-        tokens_.store(current - 1.0, std::memory_order_relaxed);
+    uint32_t batch = thread_cache_.load(std::memory_order_relaxed);
+    if (batch > 1) {
+        uint64_t id = cache_id_.load(std::memory_order_relaxed);
+        ThreadTokens& local = token_slot(id);
+        if (local.owner == id && local.tokens > 0) {
+            --local.tokens;
+            return true;
+        }
+        uint64_t granted = acquire(batch);
+        if (granted > 0) {
+            // Only when more limiters than slots are in use does this
+            // forfeit tokens cached for another one
+            local.owner = id;
+            local.tokens = granted - 1;
+            return true;
+        }
+    } else if (acquire(1) > 0) {
         return true;
     }
 
@@ -30,28 +110,180 @@ bool RateLimiter::try_log() {
     return false;
 }
 
-void RateLimiter::refill_tokens() {
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_refill_).count();
-    
-    if (elapsed > 0) {
-        double tokens_to_add = (refill_rate_ * elapsed) / 1000.0;
-        double current = tokens_.load(std::memory_order_relaxed);
-        double new_tokens = std::min(current + tokens_to_add, static_cast<double>(max_tokens_));
-        tokens_.store(new_tokens, std::memory_order_relaxed);
-        last_refill_ = now;
-    }
+void RateLimiter::set_thread_cache(size_t tokens_per_thread) {
+    size_t batch = std::min<size_t>({tokens_per_thread, max_tokens_, UINT32_MAX});
+    thread_cache_.store(static_cast<uint32_t>(batch), std::memory_order_relaxed);
 }
 
 void RateLimiter::reset() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    tokens_.store(static_cast<double>(max_tokens_), std::memory_order_relaxed);
+    full_at_.store(0, std::memory_order_relaxed);
     dropped_count_.store(0, std::memory_order_relaxed);
-    last_refill_ = std::chrono::steady_clock::now();
+    cache_id_.store(next_cache_id(), std::memory_order_relaxed);
 }
 
 size_t RateLimiter::available_tokens() const {
-    return static_cast<size_t>(tokens_.load(std::memory_order_relaxed));
+    int64_t now = now_ns();
+    int64_t full_at = full_at_.load(std::memory_order_relaxed);
+    if (full_at <= now) {
+        return max_tokens_;
+    }
+    int64_t room = burst_ns_ - (full_at - now);
+    return room > 0 ? static_cast<size_t>(room / interval_ns_) : 0;
+}
+
+KeyedRateLimiter::KeyedRateLimiter(const KeyedRateLimitOptions& options)
+    : options_(options)
+    , epoch_(std::chrono::steady_clock::now())
+{
+    if (options_.messages_per_second == 0) options_.messages_per_second = 1;
+    if (options_.burst == 0) options_.burst = options_.messages_per_second;
+    if (options_.max_keys == 0) options_.max_keys = 1;
+    interval_ns_ = std::max<int64_t>(1, static_cast<int64_t>(1e9 / static_cast<double>(options_.messages_per_second) + 0.5));
+    burst_ns_ = interval_ns_ * static_cast<int64_t>(options_.burst);
+    capacity_per_shard_ = (options_.max_keys + SHARDS - 1) / SHARDS;
+    next_summary_ns_.store(std::chrono::duration_cast<std::chrono::nanoseconds>(options_.summary_interval).count(),
+                           std::memory_order_relaxed);
+    for (auto& shard : shards_) {
+        shard.entries.resize(capacity_per_shard_);
+        shard.index.reserve(capacity_per_shard_);
+    }
+}
+
+int64_t KeyedRateLimiter::now_ns() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - epoch_).count();
+}
+
+void KeyedRateLimiter::unlink(Shard& shard, uint32_t slot) {
+    Entry& entry = shard.entries[slot];
+    if (entry.prev != NONE) shard.entries[entry.prev].next = entry.next; else shard.head = entry.next;
+    if (entry.next != NONE) shard.entries[entry.next].prev = entry.prev; else shard.tail = entry.prev;
+    entry.prev = entry.next = NONE;
+}
+
+void KeyedRateLimiter::push_front(Shard& shard, uint32_t slot) {
+    Entry& entry = shard.entries[slot];
+    entry.prev = NONE;
+    entry.next = shard.head;
+    if (shard.head != NONE) shard.entries[shard.head].prev = slot;
+    shard.head = slot;
+    if (shard.tail == NONE) shard.tail = slot;
+}
+
+bool KeyedRateLimiter::try_log(uint64_t key, LogLevel level, std::string_view label, int line,
+                               bool* summaries_due) {
+    // The low bits pick the bucket inside unordered_map; use the high ones here
+    Shard& shard = shards_[(key >> 56) % SHARDS];
+    int64_t now = now_ns();
+    if (summaries_due) {
+        *summaries_due = now >= next_summary_ns_.load(std::memory_order_relaxed);
+    }
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    uint32_t slot;
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+        slot = it->second;
+        if (shard.head != slot) {
+            unlink(shard, slot);
+            push_front(shard, slot);
+        }
+    } else {
+        if (shard.used < shard.entries.size()) {
+            slot = shard.used++;
+        } else {
+            slot = shard.tail;
+            Entry& victim = shard.entries[slot];
+            if (victim.suppressed > 0) {
+                if (shard.pending.size() < MAX_PENDING) {
+                    shard.pending.push_back(Summary{victim.label, victim.line, victim.suppressed, victim.level});
+                } else {
+                    shard.pending_overflow += victim.suppressed;
+                    shard.pending_overflow_level = std::max(shard.pending_overflow_level, victim.level);
+                }
+            }
+            shard.index.erase(victim.key);
+            unlink(shard, slot);
+        }
+        Entry& entry = shard.entries[slot];
+        entry.key = key;
+        entry.label.assign(label);
+        entry.line = line;
+        entry.full_at = 0;
+        entry.suppressed = 0;
+        entry.level = LogLevel::Trace;
+        shard.index.emplace(key, slot);
+        push_front(shard, slot);
+    }
+
+    Entry& entry = shard.entries[slot];
+    int64_t next = std::max(entry.full_at, now) + interval_ns_;
+    if (next - now <= burst_ns_) {
+        entry.full_at = next;
+        return true;
+    }
+    ++entry.suppressed;
+    entry.level = std::max(entry.level, level);
+    suppressed_total_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+bool KeyedRateLimiter::collect_summaries(std::vector<Summary>& out) {
+    int64_t now = now_ns();
+    int64_t due = next_summary_ns_.load(std::memory_order_relaxed);
+    if (now < due) {
+        return false;
+    }
+    int64_t next = now + std::chrono::duration_cast<std::chrono::nanoseconds>(options_.summary_interval).count();
+    if (!next_summary_ns_.compare_exchange_strong(due, next, std::memory_order_relaxed)) {
+        return false; // Another thread is collecting this round
+    }
+    return take_summaries(out);
+}
+
+bool KeyedRateLimiter::drain_summaries(std::vector<Summary>& out) {
+    next_summary_ns_.store(now_ns() + std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               options_.summary_interval).count(),
+                           std::memory_order_relaxed);
+    return take_summaries(out);
+}
+
+bool KeyedRateLimiter::take_summaries(std::vector<Summary>& out) {
+    size_t before = out.size();
+    uint64_t overflow = 0;
+    LogLevel overflow_level = LogLevel::Trace;
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (auto& summary : shard.pending) {
+            out.push_back(std::move(summary));
+        }
+        shard.pending.clear();
+        overflow += shard.pending_overflow;
+        overflow_level = std::max(overflow_level, shard.pending_overflow_level);
+        shard.pending_overflow = 0;
+        shard.pending_overflow_level = LogLevel::Trace;
+        for (uint32_t slot = shard.head; slot != NONE; slot = shard.entries[slot].next) {
+            Entry& entry = shard.entries[slot];
+            if (entry.suppressed > 0) {
+                out.push_back(Summary{entry.label, entry.line, entry.suppressed, entry.level});
+                entry.suppressed = 0;
+                entry.level = LogLevel::Trace;
+            }
+        }
+    }
+    if (overflow > 0) {
+        out.push_back(Summary{std::string(), -1, overflow, overflow_level});
+    }
+    return out.size() > before;
+}
+
+size_t KeyedRateLimiter::key_count() const {
+    size_t total = 0;
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.index.size();
+    }
+    return total;
 }
 
 SamplingLimiter::SamplingLimiter(size_t sample_rate)
@@ -81,6 +313,147 @@ uint64_t SamplingLimiter::dropped_count() const {
     return total - (total / sample_rate_);
 }
 
+AdaptiveSampler::AdaptiveSampler(const AdaptiveSamplingOptions& options)
+    : options_(options)
+    , epoch_(std::chrono::steady_clock::now())
+{
+    if (options_.max_sample_rate == 0) options_.max_sample_rate = 1;
+    if (options_.queue_depth_low > options_.queue_depth_high) {
+        options_.queue_depth_low = options_.queue_depth_high;
+    }
+    if (options_.write_latency_low_us > options_.write_latency_high_us) {
+        options_.write_latency_low_us = options_.write_latency_high_us;
+    }
+    max_shift_ = 0;
+    while ((size_t{2} << max_shift_) <= options_.max_sample_rate && max_shift_ < 32) {
+        ++max_shift_;
+    }
+    // Warn starts three steps after Trace
+    max_step_ = max_shift_ > 0 ? max_shift_ + static_cast<unsigned>(LogLevel::Warn) : 0;
+    interval_ns_ = std::max<int64_t>(1,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(options_.adjust_interval).count());
+    next_adjust_ns_.store(interval_ns_, std::memory_order_relaxed);
+#ifndef XLOG_NO_METRICS
+    for (const auto& sink : options_.sinks) {
+        if (sink) {
+            sink_states_.push_back(SinkState{sink, sink->get_writes(), sink->get_total_write_time_us()});
+        }
+    }
+#endif
+    watched_count_.store(sink_states_.size(), std::memory_order_relaxed);
+}
+
+void AdaptiveSampler::set_source(Source source) {
+    std::lock_guard<std::mutex> lock(adjust_mtx_);
+    source_ = std::move(source);
+}
+
+int64_t AdaptiveSampler::now_ns() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - epoch_).count();
+}
+
+unsigned AdaptiveSampler::shift_for(unsigned step, LogLevel level) const {
+    unsigned lag = static_cast<unsigned>(level);
+    return step > lag ? std::min(step - lag, max_shift_) : 0;
+}
+
+size_t AdaptiveSampler::sample_rate(LogLevel level) const {
+    if (level >= LogLevel::Error) return 1;
+    return size_t{1} << shift_for(pressure(), level);
+}
+
+bool AdaptiveSampler::should_log(LogLevel level) {
+    if (level >= LogLevel::Error) {
+        return true;
+    }
+    maybe_adjust();
+    unsigned shift = shift_for(step_.load(std::memory_order_relaxed), level);
+    if (shift == 0) {
+        return true;
+    }
+    // Per-thread counters: the ratio holds per thread without a shared RMW
+    thread_local uint64_t calls[static_cast<size_t>(LogLevel::Error)] = {};
+    uint64_t n = calls[static_cast<size_t>(level)]++;
+    if ((n & ((uint64_t{1} << shift) - 1)) == 0) {
+        return true;
+    }
+    sampled_out_.add(0);
+    return false;
+}
+
+void AdaptiveSampler::maybe_adjust() {
+    // Unpressured, look at the clock on every 64th call per thread only.
+    // While sampling, check on every call so a quiet logger relaxes promptly.
+    thread_local uint32_t ticks = 0;
+    if (step_.load(std::memory_order_relaxed) == 0 && (++ticks & 63) != 0) {
+        return;
+    }
+    int64_t now = now_ns();
+    if (now < next_adjust_ns_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(adjust_mtx_, std::try_to_lock);
+    if (lock.owns_lock() && now >= next_adjust_ns_.load(std::memory_order_relaxed)) {
+        adjust_at(now);
+    }
+}
+
+void AdaptiveSampler::adjust() {
+    std::lock_guard<std::mutex> lock(adjust_mtx_);
+    adjust_at(now_ns());
+}
+
+void AdaptiveSampler::adjust_at(int64_t now) {
+    bool high = false;
+    bool low = true;
+#ifndef XLOG_NO_METRICS
+    resolved_.clear();
+    if (!options_.sinks.empty()) {
+        resolved_ = options_.sinks;
+    } else if (source_) {
+        source_(resolved_);
+    }
+
+    std::vector<SinkState> states;
+    states.reserve(resolved_.size());
+    for (const auto& sink : resolved_) {
+        if (!sink) continue;
+        size_t depth = sink->get_queue_depth();
+        high = high || depth > options_.queue_depth_high;
+        low = low && depth <= options_.queue_depth_low;
+
+        // Latency over this interval only; the lifetime average reacts too
+        // slowly. A sink seen for the first time has no interval yet.
+        uint64_t writes = sink->get_writes();
+        uint64_t write_time = sink->get_total_write_time_us();
+        auto previous = std::find_if(sink_states_.begin(), sink_states_.end(),
+                                     [&](const SinkState& state) { return state.sink == sink; });
+        if (previous != sink_states_.end() && writes > previous->writes) {
+            uint64_t average = (write_time - previous->write_time_us) / (writes - previous->writes);
+            high = high || average > options_.write_latency_high_us;
+            low = low && average <= options_.write_latency_low_us;
+        }
+        states.push_back(SinkState{sink, writes, write_time});
+    }
+    sink_states_.swap(states);
+    watched_count_.store(sink_states_.size(), std::memory_order_relaxed);
+#endif
+
+    unsigned step = step_.load(std::memory_order_relaxed);
+    if (high) {
+        step = std::min(step + 1, max_step_);
+    } else if (low && step > 0) {
+        // Callers may have been quiet for several intervals; catch up
+        int64_t elapsed = last_adjust_ns_ > 0 ? (now - last_adjust_ns_) / interval_ns_ : 1;
+        unsigned relax = static_cast<unsigned>(std::clamp<int64_t>(elapsed, 1, step));
+        step -= relax;
+    }
+    step_.store(step, std::memory_order_relaxed);
+    last_adjust_ns_ = now;
+    next_adjust_ns_.store(now + interval_ns_, std::memory_order_relaxed);
+}
+
 CombinedLimiter::CombinedLimiter(
     size_t messages_per_second,
     size_t burst_capacity,
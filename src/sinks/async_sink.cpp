@@ -0,0 +1,294 @@
+#include "Zyrnix/sinks/async_sink.hpp"
+#include "Zyrnix/log_metrics.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <typeinfo>
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#include <cstdlib>
+#endif
+
+namespace Zyrnix {
+
+namespace {
+
+// "async_sink.<wrapped sink type>.<instance>", so two AsyncSinks never
+// share one SinkMetrics entry by default
+std::string default_metrics_name(const LogSink& inner) {
+    static std::atomic<uint64_t> instances{0};
+    const char* mangled = typeid(inner).name();
+    std::string type = mangled;
+#if defined(__GNUG__)
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(mangled, nullptr, nullptr, &status);
+    if (status == 0 && demangled) {
+        type = demangled;
+    }
+    std::free(demangled);
+#endif
+    size_t scope = type.rfind("::");
+    if (scope != std::string::npos) {
+        type.erase(0, scope + 2);
+    }
+    return "async_sink." + type + "." + std::to_string(instances.fetch_add(1, std::memory_order_relaxed) + 1);
+}
+
+}
+
+AsyncSink::AsyncSink(LogSinkPtr inner, const AsyncSinkOptions& options)
+    : inner_(std::move(inner))
+    , options_(options) {
+    if (options_.capacity == 0) {
+        options_.capacity = 1;
+    }
+    if (options_.max_batch == 0) {
+        options_.max_batch = options_.capacity;
+    }
+    if (options_.metrics_name.empty()) {
+        options_.metrics_name = default_metrics_name(*inner_);
+    }
+    metrics_ = MetricsRegistry::instance().get_sink_metrics(options_.metrics_name);
+    // Not registered as a logger: the registry would export it as one
+    log_metrics_ = options_.log_metrics ? options_.log_metrics : std::make_shared<LogMetrics>();
+    batcher_ = AdaptiveBatcher(AdaptiveBatchOptions{
+        std::min(options_.max_batch, options_.capacity), options_.max_delay});
+    thread_ = std::thread([this] { run(); });
+
+    std::unique_lock<std::mutex> lock(mtx_);
+    idle_.wait(lock, [this] { return ready_; });
+}
+
+AsyncSink::~AsyncSink() {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        stop_.store(true, std::memory_order_release);
+    }
+    not_empty_.notify_all();
+    not_full_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+bool AsyncSink::push_locked(std::unique_lock<std::mutex>& lock, const LogRecord& record,
+                            std::chrono::steady_clock::time_point now) {
+    if (count_ == ring_.size()) {
+        switch (options_.overflow) {
+            case OverflowPolicy::Block:
+                if (writer_blocked_) {
+                    not_empty_.notify_one();
+                }
+                not_full_.wait(lock, [this] { return count_ < ring_.size() || stop_; });
+                if (count_ == ring_.size()) {
+                    return false;
+                }
+                break;
+            case OverflowPolicy::DropNewest:
+                ++dropped_;
+                metrics_->record_drop();
+                return false;
+            case OverflowPolicy::DropOldest:
+                head_ = (head_ + 1) % ring_.size();
+                --count_;
+                ++dropped_;
+                metrics_->record_drop();
+                break;
+        }
+    }
+    size_t slot = (head_ + count_) % ring_.size();
+    ring_[slot] = record;
+    enqueued_[slot] = now;
+    ++count_;
+    pending_.store(count_, std::memory_order_release);
+    return true;
+}
+
+void AsyncSink::log(const std::string& name, LogLevel level, const std::string& message) {
+    log_fields(name, level, message, FieldSpan());
+}
+
+void AsyncSink::log_fields(const std::string& name, LogLevel level, const std::string& message,
+                           FieldSpan fields) {
+    LogRecord record;
+    record.logger_name = name;
+    record.level = level;
+    record.message = message;
+    record.timestamp = std::chrono::system_clock::now();
+    record.fields.assign(fields);
+#ifndef XLOG_NO_CONTEXT
+    record.context = LogContext::snapshot();
+#endif
+    log_record(record);
+}
+
+void AsyncSink::log_record(const LogRecord& record) {
+    auto now = std::chrono::steady_clock::now();
+    size_t backlog;
+    bool wake;
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        if (!push_locked(lock, record, now)) {
+            return;
+        }
+        backlog = count_;
+        wake = writer_wants_wake();
+    }
+    metrics_->update_queue_depth(backlog);
+    if (wake) {
+        not_empty_.notify_one();
+    }
+}
+
+void AsyncSink::log_batch(LogRecordBatch records) {
+    if (records.empty()) return;
+    auto now = std::chrono::steady_clock::now();
+    size_t backlog;
+    bool wake;
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        for (const auto& record : records) {
+            push_locked(lock, record, now);
+        }
+        backlog = count_;
+        wake = writer_wants_wake();
+    }
+    metrics_->update_queue_depth(backlog);
+    if (wake) {
+        not_empty_.notify_one();
+    }
+}
+
+void AsyncSink::flush() {
+    std::unique_lock<std::mutex> lock(mtx_);
+    ++flush_waiters_;
+    if (writer_blocked_) {
+        not_empty_.notify_one();
+    }
+    idle_.wait(lock, [this] { return (count_ == 0 && in_flight_ == 0) || stop_; });
+    --flush_waiters_;
+}
+
+size_t AsyncSink::backlog() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return count_ + in_flight_;
+}
+
+uint64_t AsyncSink::dropped() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return dropped_;
+}
+
+void AsyncSink::run() {
+    using Clock = std::chrono::steady_clock;
+
+    configure_backend_thread(options_.backend);
+    {
+        // Allocated here so the ring lands on the backend's NUMA node
+        size_t batch_size = std::min(options_.max_batch, options_.capacity);
+        std::vector<LogRecord> ring(options_.capacity);
+        std::vector<LogRecord> batch(batch_size);
+        std::vector<Clock::time_point> enqueued(options_.capacity);
+        std::vector<Clock::time_point> batch_enqueued(batch_size);
+        std::lock_guard<std::mutex> lock(mtx_);
+        ring_.swap(ring);
+        batch_.swap(batch);
+        enqueued_.swap(enqueued);
+        batch_enqueued_.swap(batch_enqueued);
+        ready_ = true;
+    }
+    idle_.notify_all();
+
+    const WaitOptions& wait = options_.backend.wait;
+    auto has_work = [this] {
+        return pending_.load(std::memory_order_acquire) > 0 || stop_.load(std::memory_order_acquire);
+    };
+
+    while (true) {
+        size_t n;
+        Clock::time_point started;
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            in_flight_ = 0;
+            if (count_ == 0) {
+                idle_.notify_all();
+                if (wait.policy != WaitPolicy::Block) {
+                    lock.unlock();
+                    spin_until(wait, has_work);
+                    lock.lock();
+                }
+            }
+            if (count_ == 0 && !stop_) {
+                writer_blocked_ = true;
+                while (count_ == 0 && !stop_) {
+                    if (wait.block_timeout.count() > 0) {
+                        not_empty_.wait_for(lock, wait.block_timeout);
+                    } else {
+                        not_empty_.wait(lock);
+                    }
+                }
+                writer_blocked_ = false;
+            }
+            if (count_ == 0) {
+                return; // stop_ and fully drained
+            }
+
+            // Linger for the adaptive target, but never past the oldest
+            // record's deadline
+            size_t target = std::min(batcher_.target(), batch_.size());
+            if (count_ < target && !stop_ && flush_waiters_ == 0) {
+                auto deadline = batcher_.deadline(enqueued_[head_]);
+                writer_blocked_ = true;
+                wake_threshold_ = target;
+                while (count_ < target && !stop_ && flush_waiters_ == 0) {
+                    if (not_empty_.wait_until(lock, deadline) == std::cv_status::timeout) {
+                        break;
+                    }
+                }
+                wake_threshold_ = 1;
+                writer_blocked_ = false;
+            }
+
+            // Swapping keeps both sides' buffers, so neither allocates
+            n = std::min(count_, batch_.size());
+            for (size_t i = 0; i < n; ++i) {
+                size_t slot = (head_ + i) % ring_.size();
+                std::swap(batch_[i], ring_[slot]);
+                batch_enqueued_[i] = enqueued_[slot];
+            }
+            head_ = (head_ + n) % ring_.size();
+            count_ -= n;
+            pending_.store(count_, std::memory_order_relaxed);
+            in_flight_ = n;
+            metrics_->update_queue_depth(count_ + n);
+        }
+        not_full_.notify_all();
+
+        started = Clock::now();
+        try {
+            inner_->log_batch(std::span<const LogRecord>(batch_.data(), n));
+            for (size_t i = 0; i < n; ++i) {
+                metrics_->record_write(batch_[i].message.size());
+            }
+        } catch (...) {
+            metrics_->record_error();
+        }
+        auto written = Clock::now();
+        metrics_->record_write_duration(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(written - started).count()));
+
+        batcher_.on_batch(n, started, written - started);
+        log_metrics_->record_batch_size(n);
+        for (size_t i = 0; i < n; ++i) {
+            log_metrics_->record_enqueue_to_write_ns(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(written - batch_enqueued_[i]).count()));
+        }
+
+        // Parked records must not pin their callers' context snapshots
+        for (size_t i = 0; i < n; ++i) {
+            batch_[i].context = ContextSnapshot();
+        }
+    }
+}
+
+}
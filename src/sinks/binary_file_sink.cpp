@@ -0,0 +1,222 @@
+#include "Zyrnix/sinks/binary_file_sink.hpp"
+#include "Zyrnix/binary_codec.hpp"
+#include "Zyrnix/util.hpp"
+#include <algorithm>
+
+namespace Zyrnix {
+
+namespace {
+
+constexpr char MAGIC[7] = {'Z', 'Y', 'R', 'N', 'I', 'X', 'B'};
+
+constexpr uint8_t TAG_BLOCK = 0x01;
+constexpr uint8_t TAG_STRING = 0x02;
+constexpr uint8_t TAG_RECORD = 0x03;
+
+constexpr uint8_t FLAG_MESSAGE_REF = 0x08;
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+}
+
+BinaryFileSink::BinaryFileSink(const std::string& filename, const BinaryLogOptions& options)
+    : filename_(filename), options_(options) {
+    if (options_.sync_interval == 0) {
+        options_.sync_interval = 1;
+    }
+    buffer_.reserve(options_.buffer_size + 1024);
+
+#ifdef _WIN32
+    file_.open(path::to_native(filename_), std::ios::binary | std::ios::app);
+#else
+    file_.open(filename_, std::ios::binary | std::ios::app);
+#endif
+    if (file_.is_open()) {
+        file_.seekp(0, std::ios::end);
+        if (file_.tellp() == 0) {
+            buffer_.append(MAGIC, sizeof(MAGIC));
+            binary::put_u8(buffer_, FORMAT_VERSION);
+        }
+    }
+}
+
+BinaryFileSink::~BinaryFileSink() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    flush_buffer();
+}
+
+void BinaryFileSink::log(const std::string& name, LogLevel level, const std::string& message) {
+    log_fields(name, level, message, FieldSpan());
+}
+
+void BinaryFileSink::log_fields(const std::string& name, LogLevel level,
+                                const std::string& message, FieldSpan fields) {
+    if (level < get_level()) return;
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (!file_.is_open()) {
+        return;
+    }
+
+    write_record(name, level, message, fields);
+
+    if (buffer_.size() >= options_.buffer_size || level >= options_.flush_level) {
+        flush_buffer();
+    }
+}
+
+void BinaryFileSink::flush() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    flush_buffer();
+}
+
+uint64_t BinaryFileSink::records_written() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return records_written_;
+}
+
+uint64_t BinaryFileSink::bytes_written() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return bytes_written_;
+}
+
+void BinaryFileSink::begin_block(int64_t timestamp_ns) {
+    dictionary_.clear();
+    message_ids_.clear();
+    next_id_ = 0;
+    records_in_block_ = 0;
+    // The base is unsigned on disk; a clock before the epoch starts at 0 and
+    // the records' signed deltas carry the rest, as the reader sees it
+    last_timestamp_ns_ = std::max<int64_t>(timestamp_ns, 0);
+    block_open_ = true;
+
+    binary::put_u8(buffer_, TAG_BLOCK);
+    binary::put_varint(buffer_, static_cast<uint64_t>(last_timestamp_ns_));
+}
+
+uint32_t BinaryFileSink::dictionary_ref(std::string_view str) {
+    // Logger names and keys come from long-lived buffers, so interning them
+    // is a per-thread cache hit and the dictionary is keyed by integer ID
+    InternedString interned = StringInterner::intern(str);
+    auto it = dictionary_.find(interned.id());
+    if (it != dictionary_.end()) {
+        return it->second;
+    }
+
+    // Unpooled strings (intern table full) share one ID, so each gets a
+    // fresh definition instead of a dictionary slot
+    uint32_t id = next_id_++;
+    if (interned.pooled()) {
+        dictionary_.emplace(interned.id(), id);
+    }
+
+    binary::put_u8(buffer_, TAG_STRING);
+    binary::put_varint(buffer_, id);
+    binary::put_bytes(buffer_, str);
+    return id;
+}
+
+uint32_t BinaryFileSink::message_ref(const std::string& message) {
+    if (message.size() > options_.max_dictionary_message_len) {
+        return NOT_DEFINED;
+    }
+
+    auto it = message_ids_.find(message);
+    if (it == message_ids_.end()) {
+        // First sighting: remember it, but keep writing it inline
+        if (message_ids_.size() < options_.max_dictionary_entries) {
+            message_ids_.emplace(message, NOT_DEFINED);
+        }
+        return NOT_DEFINED;
+    }
+
+    if (it->second == NOT_DEFINED && next_id_ < options_.max_dictionary_entries) {
+        // Second sighting: the message is most likely a constant at its call
+        // site, so define it once and reference it from here on
+        it->second = next_id_++;
+        binary::put_u8(buffer_, TAG_STRING);
+        binary::put_varint(buffer_, it->second);
+        binary::put_bytes(buffer_, message);
+    }
+    return it->second;
+}
+
+void BinaryFileSink::write_field(const Field& field) {
+    binary::put_varint(buffer_, dictionary_ref(field.key));
+
+    const FieldValue& value = field.value;
+    binary::put_u8(buffer_, static_cast<uint8_t>(value.type()));
+    switch (value.type()) {
+        case FieldValue::Type::Null:
+            break;
+        case FieldValue::Type::Int:
+            binary::put_svarint(buffer_, value.as_int());
+            break;
+        case FieldValue::Type::UInt:
+            binary::put_varint(buffer_, value.as_uint());
+            break;
+        case FieldValue::Type::Double:
+            binary::put_double(buffer_, value.as_double());
+            break;
+        case FieldValue::Type::Bool:
+            binary::put_u8(buffer_, value.as_bool() ? 1 : 0);
+            break;
+        case FieldValue::Type::String:
+            binary::put_bytes(buffer_, value.as_string());
+            break;
+    }
+}
+
+void BinaryFileSink::write_record(const std::string& name, LogLevel level,
+                                  const std::string& message, FieldSpan fields) {
+    int64_t ts = now_ns();
+    if (!block_open_ || records_in_block_ >= options_.sync_interval) {
+        begin_block(ts);
+    }
+
+    // Dictionary definitions must precede the record that uses them
+    uint32_t logger_id = dictionary_ref(name);
+    for (const auto& field : fields) {
+        dictionary_ref(field.key);
+    }
+    uint32_t message_id = message_ref(message);
+
+    binary::put_u8(buffer_, TAG_RECORD);
+    binary::put_svarint(buffer_, ts - last_timestamp_ns_);
+    last_timestamp_ns_ = ts;
+
+    uint8_t flags = static_cast<uint8_t>(level) & 0x07;
+    if (message_id != NOT_DEFINED) {
+        flags |= FLAG_MESSAGE_REF;
+    }
+    binary::put_u8(buffer_, flags);
+    binary::put_varint(buffer_, logger_id);
+
+    if (message_id != NOT_DEFINED) {
+        binary::put_varint(buffer_, message_id);
+    } else {
+        binary::put_bytes(buffer_, message);
+    }
+
+    binary::put_varint(buffer_, fields.size());
+    for (const auto& field : fields) {
+        write_field(field);
+    }
+
+    ++records_in_block_;
+    ++records_written_;
+}
+
+void BinaryFileSink::flush_buffer() {
+    if (!file_.is_open() || buffer_.empty()) {
+        return;
+    }
+    file_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    file_.flush();
+    bytes_written_ += buffer_.size();
+    buffer_.clear();
+}
+
+}
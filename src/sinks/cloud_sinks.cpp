@@ -40,14 +40,37 @@ void CloudWatchSink::log(const std::string& name, LogLevel level, const std::str
         return;
     }
 
+    queue_.push(make_event(name, level, message, std::chrono::system_clock::now()));
+    queue_cv_.notify_one();
+}
+
+CloudWatchSink::LogEvent CloudWatchSink::make_event(const std::string& name, LogLevel level,
+                                                    const std::string& message,
+                                                    std::chrono::system_clock::time_point timestamp) {
     LogEvent event;
     event.message = formatter.format(name, level, message);
     event.timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()
+        timestamp.time_since_epoch()
     ).count();
+    return event;
+}
 
-    queue_.push(event);
-    queue_cv_.notify_one();
+void CloudWatchSink::log_batch(LogRecordBatch records) {
+    size_t queued = 0;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        for (const auto& record : records) {
+            if (queue_.size() >= config_.max_queue_size) {
+                messages_dropped_ += records.size() - queued;
+                break;
+            }
+            queue_.push(make_event(record.logger_name, record.level, record.message, record.timestamp));
+            ++queued;
+        }
+    }
+    if (queued > 0) {
+        queue_cv_.notify_one();
+    }
 }
 
 void CloudWatchSink::flush() {
@@ -204,22 +227,44 @@ void AzureMonitorSink::log(const std::string& name, LogLevel level, const std::s
         return;
     }
 
+    queue_.push(make_event(name, level, message, std::chrono::system_clock::now()));
+    queue_cv_.notify_one();
+}
+
+AzureMonitorSink::TelemetryEvent AzureMonitorSink::make_event(const std::string& name, LogLevel level,
+                                                              const std::string& message,
+                                                              std::chrono::system_clock::time_point timestamp) {
     TelemetryEvent event;
     event.message = formatter.format(name, level, message);
     event.level = level_to_severity(level);
     event.logger_name = name;
     
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
+    auto time_t = std::chrono::system_clock::to_time_t(timestamp);
     std::tm tm;
     gmtime_r(&time_t, &tm);
     
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%Y-%m-%dT%H:%M:%S") << "Z";
-    event.timestamp = oss.str();
+    char buf[32];
+    size_t len = std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm);
+    event.timestamp.assign(buf, len);
+    return event;
+}
 
-    queue_.push(event);
-    queue_cv_.notify_one();
+void AzureMonitorSink::log_batch(LogRecordBatch records) {
+    size_t queued = 0;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        for (const auto& record : records) {
+            if (queue_.size() >= config_.max_queue_size) {
+                messages_dropped_ += records.size() - queued;
+                break;
+            }
+            queue_.push(make_event(record.logger_name, record.level, record.message, record.timestamp));
+            ++queued;
+        }
+    }
+    if (queued > 0) {
+        queue_cv_.notify_one();
+    }
 }
 
 void AzureMonitorSink::flush() {
@@ -0,0 +1,364 @@
+#include "Zyrnix/sinks/columnar_file_sink.hpp"
+#include "Zyrnix/binary_codec.hpp"
+#include "Zyrnix/util.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace Zyrnix {
+
+namespace {
+
+constexpr char MAGIC[7] = {'Z', 'Y', 'R', 'N', 'I', 'X', 'C'};
+
+constexpr uint8_t TAG_BLOCK = 0x01;
+
+constexpr uint8_t ENC_PLAIN = 0;
+constexpr uint8_t ENC_DICT = 1;
+constexpr uint8_t ENC_DELTA = 2;
+constexpr uint8_t ENC_VARIANT = 3;
+
+constexpr uint8_t TYPE_VARIANT = 0xFF;
+
+void put_column_header(std::string& out, std::string_view name, uint8_t encoding,
+                       FieldValue::Type type) {
+    binary::put_bytes(out, name);
+    binary::put_u8(out, encoding);
+    binary::put_u8(out, static_cast<uint8_t>(type));
+    binary::put_u8(out, 0);
+}
+
+void put_scalar(std::string& out, FieldValue::Type type, uint64_t bits) {
+    switch (type) {
+        case FieldValue::Type::Int:
+            binary::put_svarint(out, static_cast<int64_t>(bits));
+            break;
+        case FieldValue::Type::UInt:
+            binary::put_varint(out, bits);
+            break;
+        case FieldValue::Type::Double:
+            binary::put_fixed64(out, bits);
+            break;
+        case FieldValue::Type::Bool:
+            binary::put_u8(out, bits ? 1 : 0);
+            break;
+        default:
+            break;
+    }
+}
+
+std::string_view as_view(const std::string& s) { return s; }
+std::string_view as_view(const InternedString& s) { return s.view(); }
+
+}
+
+ColumnarFileSink::ColumnarFileSink(const std::string& filename, const ColumnarLogOptions& options)
+    : filename_(filename), options_(options) {
+    if (options_.block_records == 0) {
+        options_.block_records = 1;
+    }
+    timestamps_.reserve(options_.block_records);
+    levels_.reserve(options_.block_records);
+    loggers_.reserve(options_.block_records);
+    messages_.reserve(options_.block_records);
+
+#ifdef _WIN32
+    file_.open(path::to_native(filename_), std::ios::binary | std::ios::app);
+#else
+    file_.open(filename_, std::ios::binary | std::ios::app);
+#endif
+    if (file_.is_open()) {
+        file_.seekp(0, std::ios::end);
+        if (file_.tellp() == 0) {
+            file_.write(MAGIC, sizeof(MAGIC));
+            file_.put(static_cast<char>(FORMAT_VERSION));
+            file_.flush();
+        }
+    }
+}
+
+ColumnarFileSink::~ColumnarFileSink() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    write_block();
+}
+
+void ColumnarFileSink::log(const std::string& name, LogLevel level, const std::string& message) {
+    log_fields(name, level, message, FieldSpan());
+}
+
+void ColumnarFileSink::log_fields(const std::string& name, LogLevel level,
+                                  const std::string& message, FieldSpan fields) {
+    if (level < get_level()) return;
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (!file_.is_open()) {
+        return;
+    }
+
+    timestamps_.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    levels_.push_back(static_cast<uint8_t>(level));
+    loggers_.push_back(StringInterner::intern(name));
+    messages_.push_back(message);
+
+    for (const auto& field : fields) {
+        InternedString key = StringInterner::intern(field.key);
+        size_t index = find_column(key);
+        if (index == fields_.size()) {
+            if (key.pooled()) {
+                field_index_.emplace(key.id(), index);
+            }
+            FieldColumn& column = fields_.emplace_back();
+            column.name = key;
+            // Earlier rows of this block have no value for the new key
+            column.types.assign(rows_, FieldValue::Type::Null);
+            column.scalars.assign(rows_, 0);
+            column.strings.resize(rows_);
+        }
+
+        FieldColumn& column = fields_[index];
+        if (column.types.size() > rows_) {
+            continue; // Duplicate key in one call: first value wins
+        }
+
+        const FieldValue& value = field.value;
+        uint64_t bits = 0;
+        switch (value.type()) {
+            case FieldValue::Type::Int:
+                bits = static_cast<uint64_t>(value.as_int());
+                break;
+            case FieldValue::Type::UInt:
+                bits = value.as_uint();
+                break;
+            case FieldValue::Type::Double: {
+                double d = value.as_double();
+                std::memcpy(&bits, &d, sizeof(bits));
+                break;
+            }
+            case FieldValue::Type::Bool:
+                bits = value.as_bool() ? 1 : 0;
+                break;
+            default:
+                break;
+        }
+        column.types.push_back(value.type());
+        column.scalars.push_back(bits);
+        column.strings.emplace_back(value.as_string());
+    }
+
+    ++rows_;
+    for (auto& column : fields_) {
+        if (column.types.size() < rows_) {
+            column.types.push_back(FieldValue::Type::Null);
+            column.scalars.push_back(0);
+            column.strings.emplace_back();
+        }
+    }
+
+    if (rows_ >= options_.block_records || level >= options_.flush_level) {
+        write_block();
+    }
+}
+
+void ColumnarFileSink::flush() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    write_block();
+}
+
+uint64_t ColumnarFileSink::blocks_written() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return blocks_written_;
+}
+
+size_t ColumnarFileSink::find_column(const InternedString& key) const {
+    if (key.pooled()) {
+        auto it = field_index_.find(key.id());
+        return it != field_index_.end() ? it->second : fields_.size();
+    }
+    // Unpooled keys (intern table full) share one ID: match them by text
+    for (size_t i = 0; i < fields_.size(); ++i) {
+        if (fields_[i].name == key) {
+            return i;
+        }
+    }
+    return fields_.size();
+}
+
+template <typename Strings>
+void ColumnarFileSink::encode_strings(const Strings& values,
+                                      const std::vector<FieldValue::Type>* types,
+                                      bool force_dictionary) {
+    // Dictionary pass; abandoned once more than half of the values are distinct
+    std::unordered_map<std::string_view, uint32_t> dict;
+    std::vector<std::string_view> entries;
+    std::vector<uint32_t> indices;
+    size_t valid = 0;
+    bool use_dictionary = true;
+
+    indices.reserve(values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (types && (*types)[i] != FieldValue::Type::String) {
+            continue;
+        }
+        ++valid;
+        std::string_view value = as_view(values[i]);
+        auto [it, inserted] = dict.try_emplace(value, static_cast<uint32_t>(entries.size()));
+        if (inserted) {
+            entries.push_back(value);
+            if (!force_dictionary && entries.size() * 2 > values.size()) {
+                use_dictionary = false;
+                break;
+            }
+        }
+        indices.push_back(it->second);
+    }
+
+    binary::put_u8(body_, use_dictionary ? ENC_DICT : ENC_PLAIN);
+    binary::put_u8(body_, static_cast<uint8_t>(FieldValue::Type::String));
+
+    if (types) {
+        if (!use_dictionary) {
+            valid = 0;
+            for (auto t : *types) {
+                valid += t == FieldValue::Type::String;
+            }
+        }
+        bool has_validity = valid < values.size();
+        binary::put_u8(body_, has_validity ? 1 : 0);
+        if (has_validity) {
+            std::string bitmap((values.size() + 7) / 8, '\0');
+            for (size_t i = 0; i < values.size(); ++i) {
+                if ((*types)[i] == FieldValue::Type::String) {
+                    bitmap[i / 8] = static_cast<char>(bitmap[i / 8] | (1 << (i % 8)));
+                }
+            }
+            body_ += bitmap;
+        }
+    } else {
+        binary::put_u8(body_, 0);
+    }
+
+    if (use_dictionary) {
+        binary::put_varint(body_, entries.size());
+        for (auto entry : entries) {
+            binary::put_bytes(body_, entry);
+        }
+        for (auto index : indices) {
+            binary::put_varint(body_, index);
+        }
+    } else {
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (!types || (*types)[i] == FieldValue::Type::String) {
+                binary::put_bytes(body_, as_view(values[i]));
+            }
+        }
+    }
+}
+
+void ColumnarFileSink::encode_field_column(const FieldColumn& column) {
+    binary::put_bytes(body_, column.name.view());
+
+    FieldValue::Type type = FieldValue::Type::Null;
+    bool mixed = false;
+    size_t valid = 0;
+    for (auto t : column.types) {
+        if (t == FieldValue::Type::Null) continue;
+        ++valid;
+        if (type == FieldValue::Type::Null) {
+            type = t;
+        } else if (t != type) {
+            mixed = true;
+        }
+    }
+
+    if (mixed) {
+        binary::put_u8(body_, ENC_VARIANT);
+        binary::put_u8(body_, TYPE_VARIANT);
+        binary::put_u8(body_, 0);
+        for (size_t i = 0; i < rows_; ++i) {
+            binary::put_u8(body_, static_cast<uint8_t>(column.types[i]));
+            if (column.types[i] == FieldValue::Type::String) {
+                binary::put_bytes(body_, column.strings[i]);
+            } else {
+                put_scalar(body_, column.types[i], column.scalars[i]);
+            }
+        }
+        return;
+    }
+
+    if (type == FieldValue::Type::String) {
+        encode_strings(column.strings, &column.types, false);
+        return;
+    }
+
+    binary::put_u8(body_, ENC_PLAIN);
+    binary::put_u8(body_, static_cast<uint8_t>(type));
+    bool has_validity = valid < rows_;
+    binary::put_u8(body_, has_validity ? 1 : 0);
+    if (has_validity) {
+        std::string bitmap((rows_ + 7) / 8, '\0');
+        for (size_t i = 0; i < rows_; ++i) {
+            if (column.types[i] != FieldValue::Type::Null) {
+                bitmap[i / 8] = static_cast<char>(bitmap[i / 8] | (1 << (i % 8)));
+            }
+        }
+        body_ += bitmap;
+    }
+    for (size_t i = 0; i < rows_; ++i) {
+        if (column.types[i] != FieldValue::Type::Null) {
+            put_scalar(body_, type, column.scalars[i]);
+        }
+    }
+}
+
+void ColumnarFileSink::write_block() {
+    if (rows_ == 0 || !file_.is_open()) {
+        return;
+    }
+
+    body_.clear();
+
+    put_column_header(body_, "timestamp", ENC_DELTA, FieldValue::Type::Int);
+    int64_t prev = 0;
+    for (int64_t ts : timestamps_) {
+        binary::put_svarint(body_, ts - prev);
+        prev = ts;
+    }
+
+    put_column_header(body_, "level", ENC_PLAIN, FieldValue::Type::UInt);
+    body_.append(reinterpret_cast<const char*>(levels_.data()), levels_.size());
+
+    binary::put_bytes(body_, "logger");
+    encode_strings(loggers_, nullptr, true);
+
+    binary::put_bytes(body_, "message");
+    encode_strings(messages_, nullptr, false);
+
+    binary::put_varint(body_, fields_.size());
+    for (const auto& column : fields_) {
+        encode_field_column(column);
+    }
+
+    auto [min_ts, max_ts] = std::minmax_element(timestamps_.begin(), timestamps_.end());
+
+    block_.clear();
+    binary::put_u8(block_, TAG_BLOCK);
+    binary::put_varint(block_, rows_);
+    binary::put_varint(block_, static_cast<uint64_t>(std::max<int64_t>(*min_ts, 0)));
+    binary::put_varint(block_, static_cast<uint64_t>(std::max<int64_t>(*max_ts, 0)));
+    binary::put_varint(block_, body_.size());
+
+    file_.write(block_.data(), static_cast<std::streamsize>(block_.size()));
+    file_.write(body_.data(), static_cast<std::streamsize>(body_.size()));
+    file_.flush();
+    ++blocks_written_;
+
+    rows_ = 0;
+    timestamps_.clear();
+    levels_.clear();
+    loggers_.clear();
+    messages_.clear();
+    fields_.clear();
+    field_index_.clear();
+}
+
+}
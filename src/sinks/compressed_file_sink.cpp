@@ -32,6 +32,9 @@ CompressedFileSink::CompressedFileSink(
     , last_compression_duration_us_(0)
     , compression_count_(0)
 {
+    if (options_.background) {
+        compression_tasks_ = std::make_unique<TaskGroup>();
+    }
     file_.open(base_filename_, std::ios::app);
     if (file_.is_open()) {
         file_.seekp(0, std::ios::end);
@@ -40,12 +43,16 @@ CompressedFileSink::CompressedFileSink(
 }
 
 CompressedFileSink::~CompressedFileSink() {
+    wait_for_compression();
     if (file_.is_open()) {
         file_.close();
     }
 }
 
 void CompressedFileSink::log(const std::string& name, LogLevel level, const std::string& message) {
+    if (rotation_pending_.load(std::memory_order_relaxed)) {
+        wait_for_compression();
+    }
     std::lock_guard<std::mutex> lock(mutex_);
     
     if (!file_.is_open()) {
@@ -56,62 +63,96 @@ void CompressedFileSink::log(const std::string& name, LogLevel level, const std:
     file_ << formatted << '\n';
     current_size_ += formatted.size() + 1;
 
-    if (current_size_ >= max_size_) {
+    if (current_size_ >= max_size_ && compression_idle()) {
         rotate();
     }
 }
 
+void CompressedFileSink::log_batch(LogRecordBatch records) {
+    if (rotation_pending_.load(std::memory_order_relaxed)) {
+        wait_for_compression();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_.is_open()) {
+        return;
+    }
+
+    batch_buffer_.clear();
+    for (const auto& record : records) {
+        if (record.level < get_level()) continue;
+        size_t before = batch_buffer_.size();
+        formatter.format_to(batch_buffer_, record);
+        batch_buffer_ += '\n';
+        current_size_ += batch_buffer_.size() - before;
+        if (current_size_ >= max_size_ && compression_idle()) {
+            file_.write(batch_buffer_.data(), static_cast<std::streamsize>(batch_buffer_.size()));
+            batch_buffer_.clear();
+            rotate();
+            if (!file_.is_open()) {
+                return;
+            }
+        }
+    }
+    if (!batch_buffer_.empty()) {
+        file_.write(batch_buffer_.data(), static_cast<std::streamsize>(batch_buffer_.size()));
+    }
+}
+
 void CompressedFileSink::flush() {
+    wait_for_compression();
     std::lock_guard<std::mutex> lock(mutex_);
     if (file_.is_open()) {
         file_.flush();
     }
 }
 
+void CompressedFileSink::wait_for_compression() {
+    if (compression_tasks_) {
+        compression_tasks_->wait();
+    }
+}
+
+bool CompressedFileSink::compression_idle() {
+    bool idle = !compression_tasks_ || compression_tasks_->done();
+    rotation_pending_.store(!idle, std::memory_order_relaxed);
+    return idle;
+}
+
 void CompressedFileSink::rotate() {
     if (file_.is_open()) {
         file_.close();
     }
 
+    const std::string ext = get_compressed_extension();
     if (max_files_ > 0) {
         std::string oldest = get_rotated_filename(max_files_);
         std::remove(oldest.c_str());
+        if (!ext.empty()) {
+            std::remove((oldest + ext).c_str());
+        }
     }
 
     for (size_t i = max_files_; i > 0; --i) {
         std::string old_name = (i == 1) ? base_filename_ : get_rotated_filename(i - 1);
         std::string new_name = get_rotated_filename(i);
         std::rename(old_name.c_str(), new_name.c_str());
+        if (i > 1 && !ext.empty()) {
+            std::rename((old_name + ext).c_str(), (new_name + ext).c_str());
+        }
     }
 
     if (options_.compress_on_rotate && options_.type != CompressionType::None) {
         std::string source = get_rotated_filename(1);
-        std::string dest = source + get_compressed_extension();
-        
-        size_t original_size = CompressionUtils::get_file_size(source);
-        
-        auto start = std::chrono::steady_clock::now();
-        compress_file(source, dest);
-        auto end = std::chrono::steady_clock::now();
-        
-        last_compression_time_ = end;
-        last_compression_duration_us_ = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-        compression_count_++;
-        
-        size_t compressed_size = CompressionUtils::get_file_size(dest);
-        
-        if (compressed_size > 0) {
-            std::remove(source.c_str()); 
-            
+        int level;
+        {
             std::lock_guard<std::mutex> stats_lock(stats_mutex_);
-            files_compressed_++;
-            original_bytes_ += original_size;
-            compressed_bytes_ += compressed_size;
-            
+            level = current_level_;
+        }
 
-            if (options_.auto_tune) {
-                update_compression_level();
-            }
+        if (options_.background) {
+            compression_tasks_->run([this, source, level] { compress_rotated(source, level); });
+        } else {
+            compress_rotated(source, level);
         }
     }
 
@@ -119,15 +160,44 @@ void CompressedFileSink::rotate() {
     current_size_ = 0;
 }
 
-void CompressedFileSink::compress_file(const std::string& source_path, const std::string& dest_path) {
+void CompressedFileSink::compress_rotated(const std::string& source, int level) {
+    std::string dest = source + get_compressed_extension();
+    size_t original_size = CompressionUtils::get_file_size(source);
+
+    auto start = std::chrono::steady_clock::now();
+    compress_file(source, dest, level);
+    auto end = std::chrono::steady_clock::now();
+
+    size_t compressed_size = CompressionUtils::get_file_size(dest);
+    if (compressed_size > 0) {
+        std::remove(source.c_str());
+    }
+
+    std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+    last_compression_time_ = end;
+    last_compression_duration_us_ = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    compression_count_++;
+
+    if (compressed_size > 0) {
+        files_compressed_++;
+        original_bytes_ += original_size;
+        compressed_bytes_ += compressed_size;
+
+        if (options_.auto_tune) {
+            update_compression_level();
+        }
+    }
+}
+
+void CompressedFileSink::compress_file(const std::string& source_path, const std::string& dest_path, int level) {
     bool success = false;
     
     switch (options_.type) {
         case CompressionType::Gzip:
-            success = compress_gzip(source_path, dest_path);
+            success = compress_gzip(source_path, dest_path, level);
             break;
         case CompressionType::Zstd:
-            success = compress_zstd(source_path, dest_path);
+            success = compress_zstd(source_path, dest_path, level);
             break;
         default:
             break;
@@ -136,12 +206,12 @@ void CompressedFileSink::compress_file(const std::string& source_path, const std
     (void)success; 
 }
 
-bool CompressedFileSink::compress_gzip(const std::string& source, const std::string& dest) {
+bool CompressedFileSink::compress_gzip(const std::string& source, const std::string& dest, int level) {
 #ifdef XLOG_HAS_ZLIB
     std::ifstream in(source, std::ios::binary);
     if (!in) return false;
 
-    gzFile out = gzopen(dest.c_str(), ("wb" + std::to_string(options_.level)).c_str());
+    gzFile out = gzopen(dest.c_str(), ("wb" + std::to_string(level)).c_str());
     if (!out) return false;
 
     char buffer[8192];
@@ -152,12 +222,12 @@ bool CompressedFileSink::compress_gzip(const std::string& source, const std::str
     gzclose(out);
     return true;
 #else
-    std::string cmd = "gzip -" + std::to_string(options_.level) + " -c \"" + source + "\" > \"" + dest + "\"";
+    std::string cmd = "gzip -" + std::to_string(level) + " -c \"" + source + "\" > \"" + dest + "\"";
     return std::system(cmd.c_str()) == 0;
 #endif
 }
 
-bool CompressedFileSink::compress_zstd(const std::string& source, const std::string& dest) {
+bool CompressedFileSink::compress_zstd(const std::string& source, const std::string& dest, int level) {
 #ifdef XLOG_HAS_ZSTD
     std::ifstream in(source, std::ios::binary);
     if (!in) return false;
@@ -175,7 +245,7 @@ bool CompressedFileSink::compress_zstd(const std::string& source, const std::str
     size_t compressed_size = ZSTD_compress(
         output_buffer.data(), compressed_bound,
         input_buffer.data(), file_size,
-        options_.level
+        level
     );
 
     if (ZSTD_isError(compressed_size)) {
@@ -187,7 +257,7 @@ bool CompressedFileSink::compress_zstd(const std::string& source, const std::str
     
     return true;
 #else
-    std::string cmd = "zstd -" + std::to_string(options_.level) + " -q -f \"" + source + "\" -o \"" + dest + "\"";
+    std::string cmd = "zstd -" + std::to_string(level) + " -q -f \"" + source + "\" -o \"" + dest + "\"";
     return std::system(cmd.c_str()) == 0;
 #endif
 }
@@ -311,6 +381,7 @@ bool CompressionUtils::is_zstd_available() {
 
 void CompressedFileSink::enable_auto_tune(bool enable) {
     std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::mutex> stats_lock(stats_mutex_);
     options_.auto_tune = enable;
     if (enable) {
         current_level_ = options_.level;
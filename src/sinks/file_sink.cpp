@@ -23,4 +23,18 @@ void FileSink::log(const std::string& logger_name, LogLevel level, const std::st
     }
 }
 
+void FileSink::log_batch(LogRecordBatch records) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!file.is_open()) return;
+    batch_buffer.clear();
+    for (const auto& record : records) {
+        if (record.level < get_level()) continue;
+        formatter.format_to(batch_buffer, record);
+        batch_buffer += '\n';
+    }
+    if (batch_buffer.empty()) return;
+    file.write(batch_buffer.data(), static_cast<std::streamsize>(batch_buffer.size()));
+    file.flush();
+}
+
 }
@@ -23,19 +23,42 @@ void LokiSink::log(const std::string& logger_name, LogLevel level, const std::st
     std::lock_guard<std::mutex> lock(mutex_);
 
     auto now = std::chrono::system_clock::now();
-    auto ts = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+    append_entry(logger_name, level, message, now);
+    maybe_send(now);
+}
 
-    std::ostringstream oss;
-    oss << "{";
-    oss << "\"ts\":\"" << ts << "\",";
-    // Attach logger name and level as Loki entry fields in addition to the raw message
-    oss << "\"logger\":\"" << logger_name << "\",";
-    oss << "\"level\":\"" << to_string(level) << "\",";
-    oss << "\"line\":\"" << message << "\"";
-    oss << "}";
+void LokiSink::log_batch(LogRecordBatch records) {
+    if (records.empty()) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    buffer_.reserve(buffer_.size() + records.size());
+    for (const auto& record : records) {
+        append_entry(record.logger_name.view(), record.level, record.message, record.timestamp);
+    }
+    maybe_send(std::chrono::system_clock::now());
+}
 
-    buffer_.push_back(oss.str());
+void LokiSink::append_entry(std::string_view logger_name, LogLevel level, const std::string& message,
+                            std::chrono::system_clock::time_point timestamp) {
+    auto ts = std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp.time_since_epoch()).count();
 
+    std::string entry;
+    entry.reserve(64 + logger_name.size() + message.size());
+    entry += "{\"ts\":\"";
+    entry += std::to_string(ts);
+    // Attach logger name and level as Loki entry fields in addition to the raw message
+    entry += "\",\"logger\":\"";
+    entry += logger_name;
+    entry += "\",\"level\":\"";
+    entry += to_string_view(level);
+    entry += "\",\"line\":\"";
+    entry += message;
+    entry += "\"}";
+
+    buffer_.push_back(std::move(entry));
+}
+
+void LokiSink::maybe_send(std::chrono::system_clock::time_point now) {
     const bool size_trigger = buffer_.size() >= options_.batch_size;
     const bool time_trigger = options_.flush_interval_ms > 0 &&
         std::chrono::duration_cast<std::chrono::milliseconds>(now - last_flush_time_).count() >=
@@ -58,13 +81,20 @@ void LokiSink::flush() {
 void LokiSink::send_batch() {
     if (buffer_.empty()) return;
 
-    std::ostringstream payload;
-    payload << "{" << "\"streams\":[{" << "\"labels\":\"" << labels_ << "\"," << "\"entries\":[";
+    size_t total = 64 + labels_.size();
+    for (const auto& entry : buffer_) {
+        total += entry.size() + 1;
+    }
+    std::string payload;
+    payload.reserve(total);
+    payload += "{\"streams\":[{\"labels\":\"";
+    payload += labels_;
+    payload += "\",\"entries\":[";
     for (size_t i = 0; i < buffer_.size(); ++i) {
-        if (i > 0) payload << ",";
-        payload << buffer_[i];
+        if (i > 0) payload += ',';
+        payload += buffer_[i];
     }
-    payload << "]}]}";
+    payload += "]}]}";
 
     // Basic retry with exponential backoff (v1.1.3)
     const int max_retries = 3;
@@ -87,7 +117,8 @@ void LokiSink::send_batch() {
         headers = curl_slist_append(headers, "Content-Type: application/json");
 
         curl_easy_setopt(curl, CURLOPT_URL, url_.c_str());
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, payload.str().c_str());
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, payload.c_str());
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, static_cast<long>(payload.size()));
         curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
 
         if (options_.timeout_ms > 0) {
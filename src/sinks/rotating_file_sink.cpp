@@ -77,4 +77,24 @@ void RotatingFileSink::log(const std::string& logger_name, LogLevel level, const
     if (current_size >= max_size) rotate();
 }
 
+void RotatingFileSink::log_batch(LogRecordBatch records) {
+    std::lock_guard<std::mutex> lock(mtx);
+    batch_buffer.clear();
+    for (const auto& record : records) {
+        if (record.level < get_level()) continue;
+        size_t before = batch_buffer.size();
+        formatter.format_to(batch_buffer, record);
+        batch_buffer += '\n';
+        current_size += batch_buffer.size() - before;
+        if (current_size >= max_size) {
+            file.write(batch_buffer.data(), static_cast<std::streamsize>(batch_buffer.size()));
+            batch_buffer.clear();
+            rotate();
+        }
+    }
+    if (!batch_buffer.empty()) {
+        file.write(batch_buffer.data(), static_cast<std::streamsize>(batch_buffer.size()));
+    }
+}
+
 }
@@ -1,10 +1,8 @@
 #include "Zyrnix/sinks/structured_json_sink.hpp"
 #include "Zyrnix/log_level.hpp"
 #include "Zyrnix/log_context.hpp"
+#include "Zyrnix/string_intern.hpp"
 #include <chrono>
-#include <iomanip>
-#include <sstream>
-#include <ctime>
 
 namespace Zyrnix {
 
@@ -19,80 +17,73 @@ StructuredJsonSink::~StructuredJsonSink() {
     }
 }
 
-std::string escape_json_string(const std::string& str) {
-    std::string result;
-    for (char c : str) {
-        switch (c) {
-            case '"': result += "\\\""; break;
-            case '\\': result += "\\\\"; break;
-            case '\b': result += "\\b"; break;
-            case '\f': result += "\\f"; break;
-            case '\n': result += "\\n"; break;
-            case '\r': result += "\\r"; break;
-            case '\t': result += "\\t"; break;
-            default:
-                if (c < 32) {
-                    std::ostringstream oss;
-                    oss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)c;
-                    result += oss.str();
-                } else {
-                    result += c;
-                }
+void StructuredJsonSink::begin_record(const std::string& logger_name, LogLevel level,
+                                      const std::string& message,
+                                      std::chrono::system_clock::time_point timestamp,
+                                      const ContextSnapshot& context) {
+    writer.clear();
+    writer.begin_object();
+
+    writer.key_escaped("timestamp");
+    writer.value_timestamp(timestamp);
+
+    writer.key_escaped("level");
+    writer.value_string_escaped(to_string_view(level));
+
+    writer.key_escaped("logger");
+    writer.value_string_escaped(StringInterner::intern(logger_name).escaped());
+
+    writer.key_escaped("message");
+    writer.value_string(message);
+
+    writer.append_raw(global_context_json);
+
+    context.for_each([this](const InternedString& key, const std::string& value) {
+        writer.key_escaped(key.escaped());
+        writer.value_string(value);
+    });
+}
+
+void StructuredJsonSink::write_fields(FieldSpan fields) {
+    // Keys of ad-hoc fields are not interned here: a key already in the
+    // table reuses its escaped form, anything else is escaped inline
+    InternedString interned;
+    for (const auto& field : fields) {
+        if (StringInterner::find(field.key, interned)) {
+            writer.key_escaped(interned.escaped());
+        } else {
+            writer.key(field.key);
         }
+        writer.value(field.value);
     }
-    return result;
 }
 
-std::string get_iso8601_timestamp() {
-    auto now = std::chrono::system_clock::now();
-    auto time_t_now = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
-    
-    std::ostringstream oss;
-    oss << std::put_time(std::gmtime(&time_t_now), "%Y-%m-%dT%H:%M:%S");
-    oss << "." << std::setfill('0') << std::setw(3) << ms.count() << "Z";
-    return oss.str();
+void StructuredJsonSink::end_record() {
+    writer.end_object();
+    writer.newline();
 }
 
-std::string StructuredJsonSink::build_json(const std::string& logger_name, LogLevel level,
-                                           const std::string& message,
-                                           const std::map<std::string, std::string>& fields) {
-    std::ostringstream json;
-    json << "{";
-    
- 
-    json << "\"timestamp\":\"" << get_iso8601_timestamp() << "\",";
-    
- 
-    json << "\"level\":\"" << to_string(level) << "\",";
-    
- 
-    json << "\"logger\":\"" << escape_json_string(logger_name) << "\",";
-    
-
-    json << "\"message\":\"" << escape_json_string(message) << "\"";
-    
-
-    for (const auto& [key, value] : global_context) {
-        json << ",\"" << escape_json_string(key) << "\":\"" << escape_json_string(value) << "\"";
-    }
-    
-    auto thread_context = LogContext::get_all();
-    for (const auto& [key, value] : thread_context) {
-        json << ",\"" << escape_json_string(key) << "\":\"" << escape_json_string(value) << "\"";
-    }
+void StructuredJsonSink::write_record() {
+    file.write(writer.data(), static_cast<std::streamsize>(writer.size()));
+    file.flush();
+}
 
-    for (const auto& [key, value] : fields) {
-        json << ",\"" << escape_json_string(key) << "\":\"" << escape_json_string(value) << "\"";
+void StructuredJsonSink::log_record(const LogRecord& record) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (file.is_open()) {
+        begin_record(record.logger_name.str(), record.level, record.message,
+                     record.timestamp, record.context);
+        record.fields.for_each_interned([this](const InternedString& key, const FieldValue& value) {
+            writer.key_escaped(key.escaped());
+            writer.value(value);
+        });
+        end_record();
+        write_record();
     }
-    
-    json << "}";
-    return json.str();
 }
 
 void StructuredJsonSink::log(const std::string& logger_name, LogLevel level, const std::string& message) {
-    std::map<std::string, std::string> empty_fields;
-    log_with_fields(logger_name, level, message, empty_fields);
+    log_with_fields(logger_name, level, message, FieldSpan());
 }
 
 void StructuredJsonSink::log_with_fields(const std::string& logger_name, LogLevel level,
@@ -100,20 +91,50 @@ void StructuredJsonSink::log_with_fields(const std::string& logger_name, LogLeve
                                          const std::map<std::string, std::string>& fields) {
     std::lock_guard<std::mutex> lock(mtx);
     if (file.is_open()) {
-        std::string json_line = build_json(logger_name, level, message, fields);
-        file << json_line << std::endl;
-        file.flush();
+        begin_record(logger_name, level, message, std::chrono::system_clock::now(),
+                     LogContext::snapshot());
+        for (const auto& [key, value] : fields) {
+            writer.key(key);
+            writer.value_string(value);
+        }
+        end_record();
+        write_record();
+    }
+}
+
+void StructuredJsonSink::log_with_fields(const std::string& logger_name, LogLevel level,
+                                         const std::string& message, FieldSpan fields) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (file.is_open()) {
+        begin_record(logger_name, level, message, std::chrono::system_clock::now(),
+                     LogContext::snapshot());
+        write_fields(fields);
+        end_record();
+        write_record();
+    }
+}
+
+void StructuredJsonSink::rebuild_global_context_json() {
+    global_context_json.clear();
+    for (const auto& [key, value] : global_context) {
+        global_context_json += ",\"";
+        append_json_escaped(global_context_json, key);
+        global_context_json += "\":\"";
+        append_json_escaped(global_context_json, value);
+        global_context_json += '"';
     }
 }
 
 void StructuredJsonSink::set_context(const std::string& key, const std::string& value) {
     std::lock_guard<std::mutex> lock(mtx);
     global_context[key] = value;
+    rebuild_global_context_json();
 }
 
 void StructuredJsonSink::clear_context() {
     std::lock_guard<std::mutex> lock(mtx);
     global_context.clear();
+    global_context_json.clear();
 }
 
 }
@@ -27,8 +27,11 @@ int SyslogSink::map_level(LogLevel lvl) {
 void SyslogSink::log(const std::string& logger_name, LogLevel level, const std::string& message) {
     std::lock_guard<std::mutex> lock(mtx);
     int prio = map_level(level);
-    std::string out = logger_name.empty() ? message : (logger_name + ": " + message);
-    syslog(prio, "%s", out.c_str());
+    if (logger_name.empty()) {
+        syslog(prio, "%s", message.c_str());
+    } else {
+        syslog(prio, "%s: %s", logger_name.c_str(), message.c_str());
+    }
 }
 
 }
@@ -2,10 +2,13 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <netdb.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <cstring>
 #include <string>
 #include <iostream>
+#include <vector>
+#include <algorithm>
 
 namespace Zyrnix {
 
@@ -41,11 +44,89 @@ UdpSink::~UdpSink() {
 void UdpSink::log(const std::string& logger_name, LogLevel level, const std::string& message) {
     if (!initialized) return;
     std::lock_guard<std::mutex> lock(mtx);
-    std::string out = logger_name.empty() ? message : (logger_name + ": " + message);
 
-    out.push_back('\n');
-    ssize_t sent = sendto(sockfd, out.data(), out.size(), 0, (struct sockaddr*)&dest, dest_len);
+    // Gather "name: message\n" straight from the caller's buffers
+    static const char separator[] = ": ";
+    static const char newline[] = "\n";
+    struct iovec parts[4];
+    int count = 0;
+    if (!logger_name.empty()) {
+        parts[count++] = {const_cast<char*>(logger_name.data()), logger_name.size()};
+        parts[count++] = {const_cast<char*>(separator), 2};
+    }
+    parts[count++] = {const_cast<char*>(message.data()), message.size()};
+    parts[count++] = {const_cast<char*>(newline), 1};
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_name = &dest;
+    msg.msg_namelen = dest_len;
+    msg.msg_iov = parts;
+    msg.msg_iovlen = count;
+    ssize_t sent = sendmsg(sockfd, &msg, 0);
     (void)sent;
 }
 
+void UdpSink::log_batch(LogRecordBatch records) {
+    if (!initialized || records.empty()) return;
+    std::lock_guard<std::mutex> lock(mtx);
+
+    static const char separator[] = ": ";
+    static const char newline[] = "\n";
+    constexpr size_t PARTS = 4;
+    constexpr size_t CHUNK = 256; // Datagrams per sendmmsg() call
+
+    std::vector<struct iovec> parts;
+    parts.reserve(std::min(records.size(), CHUNK) * PARTS);
+#ifdef __linux__
+    std::vector<struct mmsghdr> msgs;
+    msgs.reserve(std::min(records.size(), CHUNK));
+#endif
+
+    size_t i = 0;
+    while (i < records.size()) {
+        parts.clear();
+#ifdef __linux__
+        msgs.clear();
+#endif
+        size_t end = std::min(records.size(), i + CHUNK);
+        for (; i < end; ++i) {
+            const LogRecord& record = records[i];
+            if (record.level < get_level()) continue;
+            size_t first = parts.size();
+            std::string_view name = record.logger_name.view();
+            if (!name.empty()) {
+                parts.push_back({const_cast<char*>(name.data()), name.size()});
+                parts.push_back({const_cast<char*>(separator), 2});
+            }
+            parts.push_back({const_cast<char*>(record.message.data()), record.message.size()});
+            parts.push_back({const_cast<char*>(newline), 1});
+
+            struct msghdr msg;
+            memset(&msg, 0, sizeof(msg));
+            msg.msg_name = &dest;
+            msg.msg_namelen = dest_len;
+            msg.msg_iov = parts.data() + first; // reserved above: no reallocation
+            msg.msg_iovlen = parts.size() - first;
+#ifdef __linux__
+            struct mmsghdr entry;
+            memset(&entry, 0, sizeof(entry));
+            entry.msg_hdr = msg;
+            msgs.push_back(entry);
+#else
+            ssize_t sent = sendmsg(sockfd, &msg, 0);
+            (void)sent;
+#endif
+        }
+#ifdef __linux__
+        size_t done = 0;
+        while (done < msgs.size()) {
+            int sent = sendmmsg(sockfd, msgs.data() + done, static_cast<unsigned>(msgs.size() - done), 0);
+            if (sent <= 0) break; // best effort, like log()
+            done += static_cast<size_t>(sent);
+        }
+#endif
+    }
+}
+
 }
@@ -0,0 +1,160 @@
+#include "Zyrnix/string_intern.hpp"
+#include "Zyrnix/json_writer.hpp"
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace Zyrnix {
+
+namespace {
+
+using Entry = InternedString::Entry;
+
+struct InternTable {
+    std::shared_mutex mtx;
+    std::unordered_map<std::string_view, const Entry*> map;
+    std::deque<Entry> entries; // Stable addresses; never shrinks
+    std::atomic<size_t> capacity{StringInterner::DEFAULT_CAPACITY};
+
+    InternTable() {
+        add(std::string_view());
+    }
+
+    const Entry* add(std::string_view str) {
+        Entry& entry = entries.emplace_back();
+        fill(entry, str, static_cast<uint32_t>(entries.size() - 1));
+        map.emplace(std::string_view(entry.value), &entry);
+        return &entry;
+    }
+
+    static void fill(Entry& entry, std::string_view str, uint32_t id) {
+        entry.value.assign(str.data(), str.size());
+        entry.escaped = json_escape(str);
+        entry.hash = std::hash<std::string_view>{}(str);
+        entry.id = id;
+    }
+};
+
+const Entry* make_unpooled(std::string_view str) {
+    Entry* entry = new Entry();
+    InternTable::fill(*entry, str, InternedString::UNPOOLED_ID);
+    entry->refs.store(1, std::memory_order_relaxed);
+    return entry;
+}
+
+InternTable& table() {
+    static InternTable* instance = new InternTable(); // Leaked: handles outlive static destruction
+    return *instance;
+}
+
+struct CacheSlot {
+    const char* data;
+    size_t size;
+    const Entry* entry;
+};
+
+constexpr size_t CACHE_SLOTS = 64;
+thread_local CacheSlot intern_cache[CACHE_SLOTS];
+
+size_t cache_index(std::string_view str) {
+    auto addr = reinterpret_cast<uintptr_t>(str.data());
+    return ((addr >> 3) ^ (addr >> 11) ^ str.size()) & (CACHE_SLOTS - 1);
+}
+
+}
+
+InternedString::InternedString() : entry_(StringInterner::empty_entry()) {}
+
+InternedString::InternedString(std::string_view str) : entry_(StringInterner::lookup(str, true)) {}
+
+void InternedString::release_unpooled() const {
+    if (entry_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete entry_;
+    }
+}
+
+const Entry* StringInterner::empty_entry() {
+    static const Entry* entry = &table().entries.front();
+    return entry;
+}
+
+const Entry* StringInterner::lookup(std::string_view str, bool insert) {
+    if (str.empty()) {
+        return empty_entry();
+    }
+
+    // The caller's buffer may have been reused for different text, so a
+    // pointer hit is confirmed by comparing the characters
+    CacheSlot& slot = intern_cache[cache_index(str)];
+    if (slot.data == str.data() && slot.size == str.size() && slot.entry->value == str) {
+        return slot.entry;
+    }
+
+    InternTable& t = table();
+    const Entry* entry = nullptr;
+    {
+        std::shared_lock<std::shared_mutex> lock(t.mtx);
+        auto it = t.map.find(str);
+        if (it != t.map.end()) {
+            entry = it->second;
+        }
+    }
+
+    if (!entry) {
+        if (!insert) {
+            return nullptr;
+        }
+        std::unique_lock<std::shared_mutex> lock(t.mtx);
+        auto it = t.map.find(str);
+        if (it != t.map.end()) {
+            entry = it->second;
+        } else if (t.entries.size() < t.capacity.load(std::memory_order_relaxed)) {
+            entry = t.add(str);
+        } else {
+            lock.unlock();
+            return make_unpooled(str); // Not cached: freed with its last handle
+        }
+    }
+
+    slot = CacheSlot{str.data(), str.size(), entry};
+    return entry;
+}
+
+InternedString StringInterner::intern(std::string_view str) {
+    return InternedString(lookup(str, true));
+}
+
+bool StringInterner::find(std::string_view str, InternedString& out) {
+    const Entry* entry = lookup(str, false);
+    if (!entry) {
+        return false;
+    }
+    out = InternedString(entry);
+    return true;
+}
+
+InternedString StringInterner::from_id(uint32_t id) {
+    InternTable& t = table();
+    std::shared_lock<std::shared_mutex> lock(t.mtx);
+    if (id >= t.entries.size()) { // Includes UNPOOLED_ID
+        return InternedString(empty_entry());
+    }
+    return InternedString(&t.entries[id]);
+}
+
+size_t StringInterner::size() {
+    InternTable& t = table();
+    std::shared_lock<std::shared_mutex> lock(t.mtx);
+    return t.entries.size();
+}
+
+void StringInterner::set_capacity(size_t max_strings) {
+    table().capacity.store(max_strings, std::memory_order_relaxed);
+}
+
+size_t StringInterner::capacity() {
+    return table().capacity.load(std::memory_order_relaxed);
+}
+
+}
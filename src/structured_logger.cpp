@@ -20,6 +20,34 @@ void StructuredLogger::clear_context() {
     json_sink->clear_context();
 }
 
+void StructuredLogger::log(LogLevel level, const std::string& message, FieldSpan fields) {
+    json_sink->log_with_fields(logger->name, level, message, fields);
+}
+
+void StructuredLogger::trace(const std::string& message, std::initializer_list<Field> fields) {
+    log(LogLevel::Trace, message, FieldSpan(fields.begin(), fields.size()));
+}
+
+void StructuredLogger::debug(const std::string& message, std::initializer_list<Field> fields) {
+    log(LogLevel::Debug, message, FieldSpan(fields.begin(), fields.size()));
+}
+
+void StructuredLogger::info(const std::string& message, std::initializer_list<Field> fields) {
+    log(LogLevel::Info, message, FieldSpan(fields.begin(), fields.size()));
+}
+
+void StructuredLogger::warn(const std::string& message, std::initializer_list<Field> fields) {
+    log(LogLevel::Warn, message, FieldSpan(fields.begin(), fields.size()));
+}
+
+void StructuredLogger::error(const std::string& message, std::initializer_list<Field> fields) {
+    log(LogLevel::Error, message, FieldSpan(fields.begin(), fields.size()));
+}
+
+void StructuredLogger::critical(const std::string& message, std::initializer_list<Field> fields) {
+    log(LogLevel::Critical, message, FieldSpan(fields.begin(), fields.size()));
+}
+
 void StructuredLogger::trace(const std::string& message, const std::map<std::string, std::string>& fields) {
     json_sink->log_with_fields(logger->name, LogLevel::Trace, message, fields);
 }
@@ -0,0 +1,73 @@
+#include "test_framework.hpp"
+#include <Zyrnix/async/adaptive_batcher.hpp>
+#include <chrono>
+
+using namespace Zyrnix;
+using namespace std::chrono;
+
+namespace {
+
+// Feeds @p batches evenly spaced batches of @p records, each taking @p write to write
+AdaptiveBatcher::Clock::time_point feed(AdaptiveBatcher& batcher, int batches, size_t records,
+                                        microseconds interval, microseconds write) {
+    AdaptiveBatcher::Clock::time_point t{seconds(1)};
+    for (int i = 0; i < batches; ++i) {
+        batcher.on_batch(records, t, write);
+        t += interval;
+    }
+    return t;
+}
+
+}
+
+TEST_CASE(adaptive_batcher_stays_at_one_under_light_load) {
+    AdaptiveBatcher batcher;
+    CHECK(batcher.target() == 1);
+    // One record every 10ms against a 1ms budget
+    feed(batcher, 50, 1, microseconds(10000), microseconds(10));
+    CHECK(batcher.target() == 1);
+}
+
+TEST_CASE(adaptive_batcher_targets_arrivals_within_budget) {
+    AdaptiveBatchOptions options;
+    options.max_batch = 4096;
+    options.max_delay = microseconds(1000);
+    AdaptiveBatcher batcher(options);
+
+    // One record per microsecond, 100us per write: 900us of budget left
+    feed(batcher, 100, 100, microseconds(100), microseconds(100));
+    CHECK(batcher.target() >= 850);
+    CHECK(batcher.target() <= 900);
+
+    auto oldest = AdaptiveBatcher::Clock::now();
+    CHECK(batcher.deadline(oldest) == oldest + microseconds(900));
+}
+
+TEST_CASE(adaptive_batcher_caps_target_at_max_batch) {
+    AdaptiveBatchOptions options;
+    options.max_batch = 64;
+    AdaptiveBatcher batcher(options);
+    feed(batcher, 50, 1000, microseconds(10), microseconds(5));
+    CHECK(batcher.target() == 64);
+}
+
+TEST_CASE(adaptive_batcher_never_lingers_when_writes_exceed_budget) {
+    AdaptiveBatchOptions options;
+    options.max_batch = 256;
+    options.max_delay = microseconds(1000);
+    AdaptiveBatcher batcher(options);
+    feed(batcher, 10, 10, microseconds(3000), microseconds(2000));
+    CHECK(batcher.target() == 256);
+    auto oldest = AdaptiveBatcher::Clock::now();
+    CHECK(batcher.deadline(oldest) == oldest);
+}
+
+TEST_CASE(adaptive_batcher_zero_delay_disables_lingering) {
+    AdaptiveBatchOptions options;
+    options.max_delay = microseconds(0);
+    AdaptiveBatcher batcher(options);
+    feed(batcher, 50, 100, microseconds(100), microseconds(10));
+    CHECK(batcher.target() == 1);
+    auto oldest = AdaptiveBatcher::Clock::now();
+    CHECK(batcher.deadline(oldest) == oldest);
+}
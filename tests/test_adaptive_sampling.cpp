@@ -0,0 +1,106 @@
+#include "test_framework.hpp"
+#include <Zyrnix/Zyrnix_features.hpp>
+
+#if !defined(XLOG_NO_RATE_LIMITING) && !defined(XLOG_NO_ASYNC) && !defined(XLOG_NO_METRICS)
+#include <Zyrnix/logger.hpp>
+#include <Zyrnix/rate_limiter.hpp>
+#include <Zyrnix/sinks/async_sink.hpp>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+namespace {
+
+// Holds its writer inside log_batch() until released, so queues back up
+class GateSink : public Zyrnix::LogSink {
+public:
+    void log(const std::string&, Zyrnix::LogLevel, const std::string&) override {}
+
+    void log_batch(Zyrnix::LogRecordBatch) override {
+        entered.store(true);
+        while (!released.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // Logs one record and waits until the writer holds it, then queues @p n more
+    void back_up(Zyrnix::Logger& logger, int n) {
+        logger.error("first");
+        while (!entered.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        for (int i = 0; i < n; ++i) {
+            logger.error("backlog");
+        }
+    }
+
+    std::atomic<bool> entered{false};
+    std::atomic<bool> released{false};
+};
+
+// Queue depth only: the held batch makes write latency meaningless here
+Zyrnix::AdaptiveSamplingOptions depth_options() {
+    Zyrnix::AdaptiveSamplingOptions options;
+    options.queue_depth_high = 16;
+    options.queue_depth_low = 4;
+    options.write_latency_high_us = 60'000'000;
+    options.write_latency_low_us = 60'000'000;
+    options.adjust_interval = std::chrono::hours(1); // Adjusted by hand below
+    return options;
+}
+
+}
+
+TEST_CASE(adaptive_sampling_watches_sinks_queued_later) {
+    Zyrnix::Logger logger("adaptive_sampling_queued_test");
+    auto sink = std::make_shared<GateSink>();
+    logger.add_sink(sink);
+    logger.set_adaptive_sampling(depth_options());
+    auto sampler = logger.adaptive_sampler();
+    REQUIRE(sampler);
+
+    // Sequential dispatch: nothing to watch, nothing sampled
+    sampler->adjust();
+    CHECK(sampler->watched_sinks() == 0);
+    CHECK(sampler->pressure() == 0);
+
+    // Queued after sampling was enabled; the sampler picks the queue up
+    logger.set_sink_dispatch(Zyrnix::SinkDispatchMode::Queued);
+    sink->back_up(logger, 64);
+    sampler->adjust();
+    CHECK(sampler->watched_sinks() == 1);
+    CHECK(sampler->pressure() == 1);
+    sampler->adjust();
+    CHECK(sampler->pressure() == 2);
+    CHECK(sampler->sample_rate(Zyrnix::LogLevel::Trace) == 4);
+    CHECK(sampler->sample_rate(Zyrnix::LogLevel::Error) == 1);
+
+    // Drained: the pressure falls back step by step
+    sink->released.store(true);
+    logger.flush_sink_queues();
+    sampler->adjust();
+    CHECK(sampler->pressure() == 1);
+    sampler->adjust();
+    CHECK(sampler->pressure() == 0);
+}
+
+TEST_CASE(adaptive_sampling_watches_async_sinks) {
+    Zyrnix::Logger logger("adaptive_sampling_async_test");
+    logger.set_adaptive_sampling(depth_options());
+    auto sampler = logger.adaptive_sampler();
+    REQUIRE(sampler);
+
+    auto gate = std::make_shared<GateSink>();
+    Zyrnix::AsyncSinkOptions async_options;
+    async_options.max_batch = 1;
+    auto async = std::make_shared<Zyrnix::AsyncSink>(gate, async_options);
+    logger.add_sink(async);
+    gate->back_up(logger, 64);
+    sampler->adjust();
+    CHECK(sampler->watched_sinks() == 1);
+    CHECK(sampler->pressure() == 1);
+
+    gate->released.store(true);
+    async->flush();
+    sampler->adjust();
+    CHECK(sampler->pressure() == 0);
+}
+
+#endif
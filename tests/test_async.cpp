@@ -0,0 +1,51 @@
+#include "test_framework.hpp"
+#include <Zyrnix/Zyrnix_features.hpp>
+
+#ifndef XLOG_NO_ASYNC
+#include <Zyrnix/sinks/async_sink.hpp>
+#include <Zyrnix/log_metrics.hpp>
+#include <memory>
+
+namespace {
+
+class CountingSink : public Zyrnix::LogSink {
+public:
+    void log(const std::string&, Zyrnix::LogLevel, const std::string&) override { ++count; }
+    int count = 0;
+};
+
+}
+
+TEST_CASE(async_sinks_get_distinct_default_metrics) {
+    auto& registry = Zyrnix::MetricsRegistry::instance();
+    size_t loggers_before = registry.get_all_logger_snapshots().size();
+
+    Zyrnix::AsyncSink first(std::make_shared<CountingSink>());
+    Zyrnix::AsyncSink second(std::make_shared<CountingSink>());
+
+    CHECK(first.metrics_name() != second.metrics_name());
+    CHECK(first.metrics_name().find("CountingSink") != std::string::npos);
+    CHECK(first.batch_metrics() != nullptr);
+    CHECK(first.batch_metrics() != second.batch_metrics());
+    // Backend stats are not exported as if they were loggers
+    CHECK(registry.get_all_logger_snapshots().size() == loggers_before);
+
+    first.log("async_test", Zyrnix::LogLevel::Info, "hello");
+    first.flush();
+    CHECK(registry.get_sink_metrics(first.metrics_name())->get_writes() == 1);
+    CHECK(registry.get_sink_metrics(second.metrics_name())->get_writes() == 0);
+    CHECK(first.batch_metrics()->batch_size_histogram().count() == 1);
+}
+
+TEST_CASE(async_sink_uses_given_metrics_name_and_log_metrics) {
+    auto log_metrics = std::make_shared<Zyrnix::LogMetrics>();
+    Zyrnix::AsyncSinkOptions options;
+    options.metrics_name = "async_test_named";
+    options.log_metrics = log_metrics;
+    Zyrnix::AsyncSink sink(std::make_shared<CountingSink>(), options);
+
+    CHECK(sink.metrics_name() == "async_test_named");
+    CHECK(sink.batch_metrics() == log_metrics);
+}
+
+#endif
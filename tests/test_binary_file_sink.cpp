@@ -0,0 +1,81 @@
+// Round trip of BinaryFileSink output through tools/zyrnix_decode.py
+#include "test_framework.hpp"
+#include <Zyrnix/sinks/binary_file_sink.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace Zyrnix;
+
+namespace {
+
+bool have_python() {
+    return std::system("python3 --version > /dev/null 2>&1") == 0;
+}
+
+std::vector<std::string> decode_json(const std::string& path) {
+    std::string cmd = "python3 " ZYRNIX_SOURCE_DIR "/tools/zyrnix_decode.py --json " + path;
+    std::vector<std::string> lines;
+    FILE* pipe = popen(cmd.c_str(), "r");
+    if (!pipe) return lines;
+    std::string line;
+    char buf[4096];
+    while (fgets(buf, sizeof(buf), pipe)) {
+        line += buf;
+        if (!line.empty() && line.back() == '\n') {
+            line.pop_back();
+            lines.push_back(line);
+            line.clear();
+        }
+    }
+    pclose(pipe);
+    return lines;
+}
+
+bool contains(const std::string& text, const std::string& part) {
+    return text.find(part) != std::string::npos;
+}
+
+}
+
+TEST_CASE(binary_file_sink_round_trips_through_decoder) {
+    if (!have_python()) return;
+    auto path = (std::filesystem::temp_directory_path() / "zyrnix_test_binary.zlog").string();
+    std::filesystem::remove(path);
+    {
+        BinaryLogOptions options;
+        options.sync_interval = 3; // Several blocks, each restarting the dictionary
+        BinaryFileSink sink(path, options);
+        REQUIRE(sink.is_open());
+        for (int i = 0; i < 5; ++i) {
+            Field fields[] = {{"request", i}, {"latency_ms", 1.5}, {"cached", i % 2 == 0},
+                              {"user", "alice"}, {"bytes", static_cast<unsigned>(i * 100)},
+                              {"note", FieldValue()}};
+            sink.log_fields("api", LogLevel::Info, "Request served", fields);
+        }
+        sink.log("db", LogLevel::Error, "Connection lost");
+        sink.flush();
+        CHECK(sink.records_written() == 6);
+    }
+
+    auto lines = decode_json(path);
+    REQUIRE(lines.size() == 6);
+    for (int i = 0; i < 5; ++i) {
+        const auto& line = lines[i];
+        CHECK(contains(line, "\"level\":\"INFO\""));
+        CHECK(contains(line, "\"logger\":\"api\""));
+        CHECK(contains(line, "\"message\":\"Request served\""));
+        CHECK(contains(line, "\"request\":" + std::to_string(i) + ","));
+        CHECK(contains(line, "\"latency_ms\":1.5"));
+        CHECK(contains(line, std::string("\"cached\":") + (i % 2 == 0 ? "true" : "false")));
+        CHECK(contains(line, "\"user\":\"alice\""));
+        CHECK(contains(line, "\"bytes\":" + std::to_string(i * 100)));
+        CHECK(contains(line, "\"note\":null"));
+    }
+    CHECK(contains(lines[5], "\"level\":\"ERROR\""));
+    CHECK(contains(lines[5], "\"logger\":\"db\""));
+    CHECK(contains(lines[5], "\"message\":\"Connection lost\""));
+    std::filesystem::remove(path);
+}
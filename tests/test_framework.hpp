@@ -0,0 +1,53 @@
+#pragma once
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// Minimal self-registering test cases, run by test_main.cpp
+
+namespace zyrnix_test {
+
+struct TestCase {
+    const char* name;
+    void (*run)();
+};
+
+inline std::vector<TestCase>& registry() {
+    static std::vector<TestCase> tests;
+    return tests;
+}
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+struct Registrar {
+    Registrar(const char* name, void (*run)()) { registry().push_back(TestCase{name, run}); }
+};
+
+inline void fail(const char* file, int line, const char* expr) {
+    ++failures();
+    std::cerr << file << ":" << line << ": CHECK failed: " << expr << "\n";
+}
+
+}
+
+#define TEST_CASE(name) \
+    static void name(); \
+    static ::zyrnix_test::Registrar name##_registrar(#name, &name); \
+    static void name()
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) ::zyrnix_test::fail(__FILE__, __LINE__, #cond); \
+    } while (0)
+
+// Stops the current test case on failure
+#define REQUIRE(cond) \
+    do { \
+        if (!(cond)) { \
+            ::zyrnix_test::fail(__FILE__, __LINE__, #cond); \
+            return; \
+        } \
+    } while (0)
@@ -0,0 +1,75 @@
+#include "test_framework.hpp"
+#include <Zyrnix/rate_limiter.hpp>
+#include <chrono>
+#include <vector>
+
+using namespace Zyrnix;
+
+namespace {
+
+// Keys sharing the top byte land in the same shard
+constexpr uint64_t shard_key(uint64_t n) { return (uint64_t{1} << 56) | n; }
+
+KeyedRateLimitOptions options_with(size_t keys_per_shard, std::chrono::milliseconds interval) {
+    KeyedRateLimitOptions options;
+    options.messages_per_second = 1;
+    options.burst = 1;
+    options.max_keys = keys_per_shard * 16;
+    options.summary_interval = interval;
+    return options;
+}
+
+}
+
+TEST_CASE(keyed_rate_limiter_limits_keys_independently) {
+    KeyedRateLimiter limiter(options_with(4, std::chrono::milliseconds(10000)));
+    CHECK(limiter.try_log(shard_key(1), LogLevel::Info, "a.cpp"));
+    CHECK(!limiter.try_log(shard_key(1), LogLevel::Info, "a.cpp"));
+    CHECK(limiter.try_log(shard_key(2), LogLevel::Info, "b.cpp"));
+    CHECK(limiter.suppressed_total() == 1);
+    CHECK(limiter.key_count() == 2);
+
+    // Not due yet: nothing is collected
+    std::vector<KeyedRateLimiter::Summary> summaries;
+    CHECK(!limiter.collect_summaries(summaries));
+    CHECK(summaries.empty());
+}
+
+TEST_CASE(keyed_rate_limiter_evicts_least_recently_used) {
+    KeyedRateLimiter limiter(options_with(3, std::chrono::milliseconds(0)));
+    CHECK(limiter.try_log(shard_key(1), LogLevel::Info, "a.cpp", 1));
+    CHECK(limiter.try_log(shard_key(2), LogLevel::Info, "b.cpp", 2));
+    CHECK(!limiter.try_log(shard_key(2), LogLevel::Warn, "b.cpp", 2));
+    CHECK(limiter.try_log(shard_key(3), LogLevel::Info, "c.cpp", 3));
+    // Touch key 1 so key 2 becomes the least recently used
+    CHECK(!limiter.try_log(shard_key(1), LogLevel::Info, "a.cpp", 1));
+    CHECK(limiter.try_log(shard_key(4), LogLevel::Info, "d.cpp", 4));
+    CHECK(limiter.key_count() == 3);
+
+    // Key 1 kept its empty bucket; key 2 was evicted and starts with a full burst
+    CHECK(!limiter.try_log(shard_key(1), LogLevel::Info, "a.cpp", 1));
+    CHECK(limiter.try_log(shard_key(2), LogLevel::Info, "b.cpp", 2));
+}
+
+TEST_CASE(keyed_rate_limiter_summarises_evicted_keys) {
+    KeyedRateLimiter limiter(options_with(1, std::chrono::milliseconds(0)));
+    CHECK(limiter.try_log(shard_key(1), LogLevel::Info, "a.cpp", 10));
+    CHECK(!limiter.try_log(shard_key(1), LogLevel::Warn, "a.cpp", 10));
+    CHECK(!limiter.try_log(shard_key(1), LogLevel::Info, "a.cpp", 10));
+    // One slot per shard: key 2 evicts key 1 with two suppressed messages
+    CHECK(limiter.try_log(shard_key(2), LogLevel::Info, "b.cpp", 20));
+    CHECK(limiter.key_count() == 1);
+
+    std::vector<KeyedRateLimiter::Summary> summaries;
+    REQUIRE(limiter.collect_summaries(summaries));
+    REQUIRE(summaries.size() == 1);
+    CHECK(summaries[0].label == "a.cpp");
+    CHECK(summaries[0].line == 10);
+    CHECK(summaries[0].suppressed == 2);
+    CHECK(summaries[0].level == LogLevel::Warn);
+
+    // Counts are handed out once
+    summaries.clear();
+    CHECK(!limiter.collect_summaries(summaries));
+    CHECK(limiter.suppressed_total() == 2);
+}
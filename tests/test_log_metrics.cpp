@@ -0,0 +1,90 @@
+#include "test_framework.hpp"
+#include <Zyrnix/Zyrnix_features.hpp>
+
+#ifndef XLOG_NO_METRICS
+#include <Zyrnix/log_metrics.hpp>
+#include <sstream>
+#include <string>
+
+namespace {
+
+size_t count_lines_starting_with(const std::string& text, const std::string& prefix) {
+    size_t count = 0;
+    std::istringstream in(text);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.compare(0, prefix.size(), prefix) == 0) ++count;
+    }
+    return count;
+}
+
+}
+
+TEST_CASE(export_all_prometheus_writes_each_family_once) {
+    auto& registry = Zyrnix::MetricsRegistry::instance();
+    registry.get_logger_metrics("prom_test_a")->record_message_logged();
+    registry.get_logger_metrics("prom_test_\"b\"")->record_message_logged();
+    registry.get_sink_metrics("prom_test_sink_1")->record_write(10);
+    registry.get_sink_metrics("prom_test_sink_2")->record_write(20);
+
+    std::string text = registry.export_all_prometheus("promtest");
+
+    CHECK(count_lines_starting_with(text, "# TYPE promtest_logger_messages_logged_total ") == 1);
+    CHECK(count_lines_starting_with(text, "# HELP promtest_logger_messages_logged_total ") == 1);
+    CHECK(count_lines_starting_with(text, "# TYPE promtest_sink_writes_total ") == 1);
+    CHECK(count_lines_starting_with(text, "# TYPE promtest_logger_messages_logged_per_second ") == 1);
+
+    CHECK(text.find("promtest_logger_messages_logged_total{logger=\"prom_test_a\"} 1\n") != std::string::npos);
+    CHECK(text.find("promtest_logger_messages_logged_total{logger=\"prom_test_\\\"b\\\"\"} 1\n") !=
+          std::string::npos);
+    CHECK(text.find("promtest_logger_messages_logged_per_second{logger=\"prom_test_a\",window=\"1s\"} ") !=
+          std::string::npos);
+    CHECK(text.find("promtest_sink_writes_total{sink=\"prom_test_sink_2\"} 1\n") != std::string::npos);
+
+    // Samples of one family are contiguous: nothing else between the
+    // TYPE line and the last sample of the family
+    size_t type = text.find("# TYPE promtest_sink_writes_total ");
+    size_t last = text.find("promtest_sink_writes_total{sink=\"prom_test_sink_2\"}");
+    REQUIRE(type != std::string::npos && last != std::string::npos);
+    CHECK(text.find("# TYPE", type + 1) > last);
+}
+
+TEST_CASE(single_logger_export_is_unlabelled) {
+    Zyrnix::LogMetrics metrics;
+    metrics.record_message_logged();
+    std::string text = metrics.export_prometheus("single");
+    CHECK(text.find("single_messages_logged_total 1\n") != std::string::npos);
+    CHECK(text.find("single_messages_logged_per_second{window=\"1s\"} ") != std::string::npos);
+    CHECK(count_lines_starting_with(text, "# TYPE single_messages_logged_total ") == 1);
+}
+
+TEST_CASE(histogram_snapshot_reuses_buffer_and_counts_whole_buckets) {
+    Zyrnix::Histogram histogram;
+    for (uint64_t v = 0; v < 32; ++v) {
+        CHECK(Zyrnix::Histogram::bucket_upper_bound(Zyrnix::Histogram::bucket_index(v)) == v);
+    }
+    // 100 and 103 share the [100, 103] bucket; 104 starts the next one
+    histogram.record(100);
+    histogram.record(103);
+    histogram.record(104);
+
+    Zyrnix::Histogram::Snapshot snap;
+    histogram.snapshot(snap);
+    CHECK(snap.buckets.size() == Zyrnix::Histogram::BUCKETS);
+    CHECK(snap.count == 3);
+    CHECK(snap.count_at_or_below(99) == 0);
+    CHECK(snap.count_at_or_below(100) == 2);
+    CHECK(snap.count_at_or_below(104) == 3);
+    const uint64_t* storage = snap.buckets.data();
+
+    histogram.reset();
+    histogram.record(7);
+    histogram.snapshot(snap);
+    CHECK(snap.buckets.data() == storage);
+    CHECK(snap.count == 1);
+    CHECK(snap.sum == 7);
+    CHECK(snap.max == 7);
+    CHECK(snap.percentile(50) == 7);
+}
+
+#endif
@@ -1,7 +1,17 @@
-// Minimal test main used for local sanitizer/fuzz runs
+// Runs every TEST_CASE, or only those whose name contains argv[1]
+#include "test_framework.hpp"
 #include <iostream>
 
-int main() {
-    std::cout << "Zyrnix test stub running\n";
-    return 0;
+int main(int argc, char** argv) {
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+    int run = 0;
+    for (const auto& test : zyrnix_test::registry()) {
+        if (filter && !std::strstr(test.name, filter)) continue;
+        int before = zyrnix_test::failures();
+        test.run();
+        ++run;
+        std::cout << (zyrnix_test::failures() == before ? "[ OK ] " : "[FAIL] ") << test.name << "\n";
+    }
+    std::cout << run << " test(s), " << zyrnix_test::failures() << " failure(s)\n";
+    return zyrnix_test::failures() == 0 ? 0 : 1;
 }
@@ -0,0 +1,114 @@
+#include "test_framework.hpp"
+#include <Zyrnix/Zyrnix_features.hpp>
+
+#if defined(__linux__) && !defined(XLOG_NO_NETWORK) && !defined(XLOG_NO_METRICS)
+#include <Zyrnix/metrics_server.hpp>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <string>
+
+namespace {
+
+int connect_to(uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    timeval timeout{2, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Sends @p request and reads until the server closes or @p responses status lines arrived
+std::string exchange(uint16_t port, const std::string& request, size_t responses = 1,
+                     bool half_close = false) {
+    int fd = connect_to(port);
+    if (fd == -1) return std::string();
+    send(fd, request.data(), request.size(), MSG_NOSIGNAL);
+    if (half_close) {
+        shutdown(fd, SHUT_WR);
+    }
+    std::string reply;
+    char buffer[4096];
+    size_t seen = 0;
+    while (seen < responses) {
+        ssize_t got = recv(fd, buffer, sizeof(buffer), 0);
+        if (got <= 0) break;
+        reply.append(buffer, static_cast<size_t>(got));
+        seen = 0;
+        for (size_t pos = reply.find("HTTP/1.1 "); pos != std::string::npos; pos = reply.find("HTTP/1.1 ", pos + 1)) {
+            ++seen;
+        }
+    }
+    close(fd);
+    return reply;
+}
+
+size_t count(const std::string& text, const std::string& needle) {
+    size_t n = 0;
+    for (size_t pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) ++n;
+    return n;
+}
+
+Zyrnix::MetricsServerOptions test_options() {
+    Zyrnix::MetricsServerOptions options;
+    options.port = 0;
+    return options;
+}
+
+}
+
+TEST_CASE(metrics_server_rejects_wrapping_content_length) {
+    Zyrnix::MetricsServer server(test_options());
+    REQUIRE(server.start());
+    // body_start + this length used to wrap to 0 and re-serve the request forever
+    std::string reply = exchange(server.port(),
+        "GET /nope HTTP/1.1\r\nConnection: keep-alive\r\nContent-Length: 18446744073709551556\r\n\r\n");
+    CHECK(reply.rfind("HTTP/1.1 413", 0) == 0);
+    CHECK(exchange(server.port(), "GET /nope HTTP/1.1\r\nContent-Length: 0\r\n\r\n").rfind("HTTP/1.1 404", 0) == 0);
+    server.stop();
+}
+
+TEST_CASE(metrics_server_rejects_malformed_content_length) {
+    Zyrnix::MetricsServer server(test_options());
+    REQUIRE(server.start());
+    CHECK(exchange(server.port(), "POST /loglevel HTTP/1.1\r\nContent-Length: 12abc\r\n\r\n").rfind("HTTP/1.1 400", 0) == 0);
+    CHECK(exchange(server.port(), "POST /loglevel HTTP/1.1\r\nContent-Length: -1\r\n\r\n").rfind("HTTP/1.1 400", 0) == 0);
+    server.stop();
+}
+
+TEST_CASE(metrics_server_answers_pipelined_requests) {
+    Zyrnix::MetricsServer server(test_options());
+    REQUIRE(server.start());
+    // About 22KB, well past the 8KB request buffer: the server reads in
+    // pieces as it answers instead of dropping what does not fit
+    std::string pipeline;
+    for (int i = 0; i < 1000; ++i) {
+        pipeline += "GET /nope HTTP/1.1\r\n\r\n";
+    }
+    pipeline += "GET /nope HTTP/1.1\r\nConnection: close\r\n\r\n";
+    REQUIRE(pipeline.size() > test_options().max_request_bytes * 2);
+    std::string reply = exchange(server.port(), pipeline, 1001);
+    CHECK(count(reply, "HTTP/1.1 404") == 1001);
+    server.stop();
+}
+
+TEST_CASE(metrics_server_answers_before_closing_half_closed_connection) {
+    Zyrnix::MetricsServer server(test_options());
+    REQUIRE(server.start());
+    // The client sends everything and shuts down its side before the reply
+    std::string reply = exchange(server.port(),
+        "GET /nope HTTP/1.1\r\n\r\nGET /nope HTTP/1.1\r\n\r\n", 3, true);
+    CHECK(count(reply, "HTTP/1.1 404") == 2);
+    server.stop();
+}
+
+#endif
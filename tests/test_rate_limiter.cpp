@@ -0,0 +1,39 @@
+#include "test_framework.hpp"
+#include <Zyrnix/Zyrnix_features.hpp>
+
+#ifndef XLOG_NO_RATE_LIMITING
+#include <Zyrnix/rate_limiter.hpp>
+
+TEST_CASE(thread_cache_is_kept_per_limiter) {
+    // Slow refill, so the bursts decide how many messages pass
+    Zyrnix::RateLimiter a(1, 100);
+    Zyrnix::RateLimiter b(1, 100);
+    a.set_thread_cache(10);
+    b.set_thread_cache(10);
+
+    int passed_a = 0;
+    int passed_b = 0;
+    for (int i = 0; i < 200; ++i) {
+        passed_a += a.try_log() ? 1 : 0;
+        passed_b += b.try_log() ? 1 : 0;
+    }
+
+    // With one cache slot per thread, each call evicted the other limiter's
+    // cached tokens, letting only about 10 of 100 through
+    CHECK(passed_a >= 100 && passed_a <= 102);
+    CHECK(passed_b >= 100 && passed_b <= 102);
+}
+
+TEST_CASE(thread_cache_tokens_are_dropped_on_reset) {
+    Zyrnix::RateLimiter limiter(1, 10);
+    limiter.set_thread_cache(5);
+    CHECK(limiter.try_log());
+    limiter.reset();
+    int passed = 0;
+    for (int i = 0; i < 20; ++i) {
+        passed += limiter.try_log() ? 1 : 0;
+    }
+    CHECK(passed >= 10 && passed <= 11);
+}
+
+#endif
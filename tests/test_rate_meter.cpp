@@ -0,0 +1,58 @@
+#include "test_framework.hpp"
+#include <Zyrnix/log_metrics.hpp>
+#include <chrono>
+#include <thread>
+
+using namespace Zyrnix;
+using namespace std::chrono_literals;
+
+TEST_CASE(rate_meter_seeds_every_window_with_first_rate) {
+    RateMeter meter;
+    std::this_thread::sleep_for(200ms);
+    auto rates = meter.sample(1000);
+    // At most 1000 records over at least 200ms
+    CHECK(rates.one_second > 0.0);
+    CHECK(rates.one_second <= 5000.0);
+    CHECK(rates.ten_seconds == rates.one_second);
+    CHECK(rates.one_minute == rates.one_second);
+}
+
+TEST_CASE(rate_meter_ignores_samples_closer_than_interval) {
+    RateMeter meter;
+    std::this_thread::sleep_for(200ms);
+    auto first = meter.sample(1000);
+    auto second = meter.sample(5000);
+    CHECK(second.one_second == first.one_second);
+}
+
+TEST_CASE(rate_meter_decays_after_burst) {
+    RateMeter meter;
+    std::this_thread::sleep_for(150ms);
+    auto burst = meter.sample(10000);
+    REQUIRE(burst.one_second > 0.0);
+
+    // Idle: the total stops growing, so every window decays, the short ones fastest
+    std::this_thread::sleep_for(500ms);
+    auto idle = meter.sample(10000);
+    CHECK(idle.one_second < burst.one_second * 0.7);
+    CHECK(idle.ten_seconds < burst.ten_seconds);
+    CHECK(idle.one_second < idle.ten_seconds);
+    CHECK(idle.ten_seconds < idle.one_minute);
+    CHECK(idle.one_minute <= burst.one_minute);
+
+    std::this_thread::sleep_for(1000ms);
+    auto later = meter.sample(10000);
+    CHECK(later.one_second < idle.one_second * 0.5);
+    CHECK(later.one_minute > burst.one_minute * 0.9);
+}
+
+TEST_CASE(rate_meter_reset_clears_rates) {
+    RateMeter meter;
+    std::this_thread::sleep_for(150ms);
+    meter.sample(1000);
+    meter.reset(1000);
+    auto rates = meter.rates();
+    CHECK(rates.one_second == 0.0);
+    CHECK(rates.ten_seconds == 0.0);
+    CHECK(rates.one_minute == 0.0);
+}
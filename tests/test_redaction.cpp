@@ -0,0 +1,64 @@
+#include "test_framework.hpp"
+#include <Zyrnix/Zyrnix_features.hpp>
+#include <Zyrnix/logger.hpp>
+#include <Zyrnix/log_sink.hpp>
+#include <Zyrnix/log_record.hpp>
+#include <Zyrnix/log_context.hpp>
+#include <memory>
+#include <vector>
+
+namespace {
+
+class CaptureSink : public Zyrnix::LogSink {
+public:
+    void log(const std::string&, Zyrnix::LogLevel, const std::string&) override {}
+    void log_record(const Zyrnix::LogRecord& record) override { records.push_back(record); }
+
+    std::vector<Zyrnix::LogRecord> records;
+};
+
+}
+
+TEST_CASE(redaction_covers_fields_and_context) {
+    Zyrnix::Logger logger("redaction_test");
+    auto sink = std::make_shared<CaptureSink>();
+    logger.add_sink(sink);
+    logger.set_redact_patterns({"hunter2"});
+    logger.set_redact_pii_presets({"email"});
+
+    Zyrnix::LogContext::set("user_email", "alice@example.com");
+    logger.info("login for bob@example.com", {{"password", "hunter2"}, {"attempts", 3}, {"note", "clean"}});
+    Zyrnix::LogContext::clear();
+
+    REQUIRE(sink->records.size() == 1);
+    const Zyrnix::LogRecord& record = sink->records[0];
+    CHECK(record.message.find("bob@example.com") == std::string::npos);
+    CHECK(record.get_field("password").find("hunter2") == std::string::npos);
+    CHECK(record.fields.get("attempts").as_int() == 3);
+    CHECK(record.get_field("note") == "clean");
+#ifndef XLOG_NO_CONTEXT
+    const std::string* email = record.context.find("user_email");
+    REQUIRE(email != nullptr);
+    CHECK(*email == "***");
+#endif
+}
+
+TEST_CASE(redaction_keeps_records_without_matches) {
+    Zyrnix::Logger logger("redaction_test_clean");
+    auto sink = std::make_shared<CaptureSink>();
+    logger.add_sink(sink);
+    logger.set_redact_patterns({"hunter2"});
+
+    Zyrnix::LogContext::set("request_id", "r-1");
+    logger.info("nothing secret", {{"user", "carol"}});
+    Zyrnix::LogContext::clear();
+
+    REQUIRE(sink->records.size() == 1);
+    CHECK(sink->records[0].message == "nothing secret");
+    CHECK(sink->records[0].get_field("user") == "carol");
+#ifndef XLOG_NO_CONTEXT
+    const std::string* request = sink->records[0].context.find("request_id");
+    REQUIRE(request != nullptr);
+    CHECK(*request == "r-1");
+#endif
+}
@@ -0,0 +1,56 @@
+#include "test_framework.hpp"
+#include <Zyrnix/string_intern.hpp>
+#include <Zyrnix/log_context.hpp>
+#include <string>
+
+using Zyrnix::InternedString;
+using Zyrnix::StringInterner;
+
+TEST_CASE(interned_string_compares_with_strings_and_literals) {
+    InternedString key = StringInterner::intern("request_id");
+    std::string text = "request_id";
+    std::string_view view = text;
+
+    CHECK(key == "request_id");
+    CHECK("request_id" == key);
+    CHECK(key == text);
+    CHECK(text == key);
+    CHECK(key == view);
+    CHECK(key != "user_id");
+    CHECK(std::string("user_id") != key);
+    CHECK(key == InternedString("request_id"));
+}
+
+TEST_CASE(intern_table_stops_growing_at_capacity) {
+    size_t previous = StringInterner::capacity();
+    StringInterner::set_capacity(StringInterner::size());
+
+    size_t before = StringInterner::size();
+    InternedString a = StringInterner::intern("intern_capacity_test_key");
+    InternedString b = StringInterner::intern(std::string("intern_capacity_test_key"));
+    CHECK(StringInterner::size() == before);
+    CHECK(!a.pooled());
+    CHECK(a.id() == InternedString::UNPOOLED_ID);
+    CHECK(a == b);
+    CHECK(a == "intern_capacity_test_key");
+    CHECK(a.escaped() == "intern_capacity_test_key");
+    CHECK(a != StringInterner::intern("intern_capacity_other_key"));
+
+    InternedString copy = a;
+    a = InternedString();
+    CHECK(copy == b);
+
+    // Context lookups by text still find keys that did not fit the table
+    Zyrnix::LogContext::set("intern_capacity_context_key", "value");
+    const std::string* found = Zyrnix::LogContext::find("intern_capacity_context_key");
+    REQUIRE(found != nullptr);
+    CHECK(*found == "value");
+    Zyrnix::LogContext::remove("intern_capacity_context_key");
+    CHECK(!Zyrnix::LogContext::contains("intern_capacity_context_key"));
+    Zyrnix::LogContext::clear();
+
+    StringInterner::set_capacity(previous);
+    InternedString pooled = StringInterner::intern("intern_capacity_test_key");
+    CHECK(pooled.pooled());
+    CHECK(pooled == b);
+}
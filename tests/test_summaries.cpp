@@ -0,0 +1,196 @@
+#include "test_framework.hpp"
+#include <Zyrnix/Zyrnix_features.hpp>
+
+#if !defined(XLOG_NO_FILTERS) && !defined(XLOG_NO_RATE_LIMITING)
+#include <Zyrnix/logger.hpp>
+#include <Zyrnix/log_filter.hpp>
+#include <Zyrnix/log_sink.hpp>
+#include <Zyrnix/log_record.hpp>
+#include <Zyrnix/rate_limiter.hpp>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+class CaptureSink : public Zyrnix::LogSink {
+public:
+    void log(const std::string&, Zyrnix::LogLevel, const std::string&) override {}
+    void log_record(const Zyrnix::LogRecord& record) override {
+        std::lock_guard<std::mutex> lock(mtx);
+        records.push_back(record);
+    }
+
+    std::mutex mtx;
+    std::vector<Zyrnix::LogRecord> records;
+};
+
+}
+
+TEST_CASE(dedup_summary_bypasses_other_filters) {
+    Zyrnix::Logger logger("dedup_summary_test");
+    auto sink = std::make_shared<CaptureSink>();
+    logger.add_sink(sink);
+
+    Zyrnix::DedupFilterOptions options;
+    options.window = std::chrono::milliseconds(50);
+    logger.add_filter(std::make_shared<Zyrnix::DedupFilter>(options));
+    // Passes the message itself but not "<message> (repeated N times)"
+    logger.add_filter(std::make_shared<Zyrnix::RegexFilter>("^disk full$"));
+
+    for (int i = 0; i < 4; ++i) {
+        logger.warn("disk full");
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(80));
+    logger.warn("disk full");
+
+    REQUIRE(sink->records.size() == 3);
+    CHECK(sink->records[0].message == "disk full");
+    CHECK(sink->records[1].message == "disk full (repeated 3 times)");
+    CHECK(sink->records[1].fields.get("repeated").as_uint() == 3);
+    CHECK(sink->records[1].level == Zyrnix::LogLevel::Warn);
+    CHECK(sink->records[2].message == "disk full");
+}
+
+TEST_CASE(dedup_ignores_records_rejected_by_later_filters) {
+    Zyrnix::Logger logger("dedup_order_test");
+    auto sink = std::make_shared<CaptureSink>();
+    logger.add_sink(sink);
+
+    Zyrnix::DedupFilterOptions options;
+    options.window = std::chrono::milliseconds(50);
+    logger.add_filter(std::make_shared<Zyrnix::DedupFilter>(options));
+    logger.add_filter(std::make_shared<Zyrnix::RegexFilter>("secret", true));
+
+    for (int i = 0; i < 5; ++i) {
+        logger.info("secret token=abc");
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(80));
+    logger.info("ok");
+    logger.info("ok");
+    std::this_thread::sleep_for(std::chrono::milliseconds(80));
+    logger.info("ok");
+
+    REQUIRE(sink->records.size() == 3);
+    CHECK(sink->records[0].message == "ok");
+    CHECK(sink->records[1].message == "ok (repeated 1 times)");
+    CHECK(sink->records[2].message == "ok");
+}
+
+TEST_CASE(dedup_summary_flushed_before_window_ends) {
+    auto sink = std::make_shared<CaptureSink>();
+    Zyrnix::DedupFilterOptions options;
+    options.window = std::chrono::seconds(60);
+    {
+        Zyrnix::Logger logger("dedup_flush_test");
+        logger.add_sink(sink);
+        logger.add_filter(std::make_shared<Zyrnix::DedupFilter>(options));
+        for (int i = 0; i < 4; ++i) {
+            logger.warn("disk full");
+        }
+        REQUIRE(sink->records.size() == 1);
+        logger.flush();
+        REQUIRE(sink->records.size() == 2);
+        CHECK(sink->records[1].message == "disk full (repeated 3 times)");
+
+        // Repeats still counted when the logger goes away are logged on destruction
+        logger.warn("disk full");
+        logger.warn("disk full");
+    }
+    REQUIRE(sink->records.size() == 3);
+    CHECK(sink->records[2].message == "disk full (repeated 2 times)");
+}
+
+TEST_CASE(rate_limit_summary_bypasses_filters) {
+    Zyrnix::Logger logger("rate_limit_summary_test");
+    auto sink = std::make_shared<CaptureSink>();
+    logger.add_sink(sink);
+    logger.add_filter(std::make_shared<Zyrnix::RegexFilter>("^request$"));
+
+    Zyrnix::KeyedRateLimitOptions options;
+    options.messages_per_second = 1;
+    options.burst = 1;
+    options.summary_interval = std::chrono::milliseconds(50);
+    logger.set_callsite_rate_limit(options);
+
+    auto log_request = [&] { logger.log_at("handler.cpp", 42, Zyrnix::LogLevel::Info, "request"); };
+    for (int i = 0; i < 5; ++i) {
+        log_request();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(80));
+    log_request();
+
+    REQUIRE(sink->records.size() >= 2);
+    CHECK(sink->records[0].message == "request");
+    const Zyrnix::LogRecord& summary = sink->records[1];
+    // The last call is rejected too (no token yet) and counted before the
+    // summary it triggers
+    CHECK(summary.message.find("Suppressed 5 messages") == 0);
+    CHECK(summary.get_field("rate_limit_key") == "handler.cpp:42");
+}
+
+TEST_CASE(rate_limit_summary_flushed_before_interval) {
+    auto sink = std::make_shared<CaptureSink>();
+    Zyrnix::KeyedRateLimitOptions options;
+    options.messages_per_second = 1;
+    options.burst = 1;
+    options.summary_interval = std::chrono::seconds(60);
+    {
+        Zyrnix::Logger logger("rate_limit_flush_test");
+        logger.add_sink(sink);
+        logger.set_callsite_rate_limit(options);
+        for (int i = 0; i < 5; ++i) {
+            logger.log_at("handler.cpp", 42, Zyrnix::LogLevel::Info, "request");
+        }
+        REQUIRE(sink->records.size() == 1);
+        logger.flush();
+        REQUIRE(sink->records.size() == 2);
+        CHECK(sink->records[1].message.find("Suppressed 4 messages") == 0);
+        CHECK(sink->records[1].fields.get("suppressed").as_uint() == 4);
+
+        // Counts still pending when the logger goes away are logged on destruction
+        for (int i = 0; i < 3; ++i) {
+            logger.log_at("handler.cpp", 42, Zyrnix::LogLevel::Info, "request");
+        }
+    }
+    REQUIRE(sink->records.size() == 3);
+    CHECK(sink->records[2].message.find("Suppressed 3 messages") == 0);
+}
+
+TEST_CASE(callsite_rate_limit_keys_plain_calls_by_source_location) {
+    Zyrnix::Logger logger("rate_limit_location_test");
+    auto sink = std::make_shared<CaptureSink>();
+    logger.add_sink(sink);
+
+    Zyrnix::KeyedRateLimitOptions options;
+    options.messages_per_second = 1;
+    options.burst = 1;
+    options.summary_interval = std::chrono::seconds(60);
+    logger.set_callsite_rate_limit(options);
+
+    // Same text from two lines: each line gets its own budget
+    int first_line = 0;
+    int second_line = 0;
+    for (int i = 0; i < 3; ++i) {
+        first_line = __LINE__ + 1;
+        logger.info("same text");
+        second_line = __LINE__ + 1;
+        logger.info("same text", {{"attempt", i}});
+    }
+    REQUIRE(sink->records.size() == 2);
+
+    logger.flush();
+    REQUIRE(sink->records.size() == 4);
+    CHECK(sink->records[2].message.find("Suppressed 2 messages") == 0);
+    CHECK(sink->records[3].message.find("Suppressed 2 messages") == 0);
+    std::string first_key = std::string(__FILE__) + ":" + std::to_string(first_line);
+    std::string second_key = std::string(__FILE__) + ":" + std::to_string(second_line);
+    std::string key_a = sink->records[2].get_field("rate_limit_key");
+    std::string key_b = sink->records[3].get_field("rate_limit_key");
+    CHECK((key_a == first_key && key_b == second_key) || (key_a == second_key && key_b == first_key));
+}
+
+#endif
@@ -0,0 +1,49 @@
+#include "test_framework.hpp"
+#include <Zyrnix/Zyrnix_features.hpp>
+
+#ifndef XLOG_NO_ASYNC
+#include <Zyrnix/async/task.hpp>
+#include <cstdint>
+#include <memory>
+
+namespace {
+
+struct alignas(128) OverAligned {
+    int* calls;
+    bool* aligned;
+    void operator()() {
+        *aligned = reinterpret_cast<uintptr_t>(this) % 128 == 0;
+        ++*calls;
+    }
+};
+
+}
+
+TEST_CASE(task_honours_over_aligned_callables) {
+    int calls = 0;
+    bool aligned = false;
+    Zyrnix::Task task(OverAligned{&calls, &aligned});
+    Zyrnix::Task moved(std::move(task));
+    moved();
+    CHECK(calls == 1);
+    CHECK(aligned);
+}
+
+TEST_CASE(task_runs_pooled_and_move_only_callables) {
+    int calls = 0;
+    auto payload = std::make_unique<int>(7);
+    char padding[200] = {};
+    Zyrnix::Task task([&calls, payload = std::move(payload), padding]() {
+        calls += *payload + padding[0];
+    });
+    task();
+    CHECK(calls == 7);
+}
+
+TEST_CASE(empty_task_call_is_a_no_op) {
+    Zyrnix::Task task;
+    task();
+    CHECK(!task);
+}
+
+#endif
@@ -0,0 +1,129 @@
+#include "test_framework.hpp"
+#include <Zyrnix/Zyrnix_features.hpp>
+
+#ifndef XLOG_NO_ASYNC
+#include <Zyrnix/async/work_stealing_pool.hpp>
+#include <Zyrnix/sinks/multi_sink.hpp>
+#ifndef XLOG_NO_COMPRESSION
+#include <Zyrnix/sinks/compressed_file_sink.hpp>
+#endif
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+// Fails the run instead of hanging ctest when @p body deadlocks
+template <typename Body>
+void with_watchdog(const char* name, std::chrono::seconds limit, Body body) {
+    std::atomic<bool> finished{false};
+    std::thread watchdog([&] {
+        auto deadline = std::chrono::steady_clock::now() + limit;
+        while (!finished.load() && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        if (!finished.load()) {
+            std::fprintf(stderr, "%s: no progress after %llds, presumed deadlock\n", name,
+                         static_cast<long long>(limit.count()));
+            std::_Exit(1);
+        }
+    });
+    body();
+    finished.store(true);
+    watchdog.join();
+}
+
+}
+
+TEST_CASE(task_group_wait_does_not_run_unrelated_tasks) {
+    Zyrnix::WorkStealingThreadPool pool(1);
+    std::atomic<bool> release{false};
+    pool.enqueue([&] {
+        while (!release.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    });
+
+    std::mutex ids_mtx;
+    std::vector<std::thread::id> ran_on;
+    auto record = [&] {
+        std::lock_guard<std::mutex> lock(ids_mtx);
+        ran_on.push_back(std::this_thread::get_id());
+    };
+
+    Zyrnix::TaskGroup other(pool);
+    for (int i = 0; i < 8; ++i) other.run(record);
+    Zyrnix::TaskGroup mine(pool);
+    mine.run(record);
+
+    std::thread releaser([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        release.store(true);
+    });
+    mine.wait();
+    releaser.join();
+    other.wait();
+
+    CHECK(ran_on.size() == 9);
+    for (auto id : ran_on) {
+        CHECK(id != std::this_thread::get_id());
+    }
+}
+
+TEST_CASE(task_group_nested_waits_on_workers_complete) {
+    Zyrnix::WorkStealingThreadPool pool(2);
+    std::atomic<int> leaves{0};
+    with_watchdog("nested task groups", std::chrono::seconds(30), [&] {
+        Zyrnix::TaskGroup outer(pool);
+        for (int i = 0; i < 8; ++i) {
+            outer.run([&] {
+                Zyrnix::TaskGroup inner(pool);
+                for (int j = 0; j < 8; ++j) inner.run([&] { leaves.fetch_add(1); });
+                inner.wait();
+            });
+        }
+        outer.wait();
+    });
+    CHECK(leaves.load() == 64);
+}
+
+#ifndef XLOG_NO_COMPRESSION
+TEST_CASE(compressed_sink_rotates_under_parallel_multisink) {
+    namespace fs = std::filesystem;
+    fs::path dir = fs::temp_directory_path() / ("zyrnix_task_group_" + std::to_string(getpid()));
+    fs::create_directories(dir);
+    {
+        Zyrnix::CompressionOptions options;
+        options.type = Zyrnix::CompressionType::Gzip;
+        auto file = std::make_shared<Zyrnix::CompressedFileSink>((dir / "app.log").string(), 4096, 3, options);
+
+        // The same sink twice: a fan-out task for it used to run inside its own
+        // rotate(), via TaskGroup::wait helping, and lock the sink twice
+        Zyrnix::MultiSink multi;
+        multi.add_sink(file);
+        multi.add_sink(file);
+        multi.set_parallel(true);
+
+        with_watchdog("parallel MultiSink rotation", std::chrono::seconds(60), [&] {
+            Zyrnix::LogRecord record;
+            record.logger_name = "rotation";
+            record.level = Zyrnix::LogLevel::Info;
+            record.message = std::string(200, 'x');
+            for (int i = 0; i < 2000; ++i) {
+                record.timestamp = std::chrono::system_clock::now();
+                multi.log_record(record);
+            }
+            file->flush();
+        });
+        CHECK(fs::exists(dir / "app.log"));
+        CHECK(file->get_compression_stats().files_compressed > 0 || !Zyrnix::CompressionUtils::is_gzip_available());
+    }
+    fs::remove_all(dir);
+}
+#endif
+
+#endif
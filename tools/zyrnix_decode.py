@@ -0,0 +1,354 @@
+#!/usr/bin/env python3
+"""
+zyrnix_decode.py - Decode binary log files written by BinaryFileSink and
+ColumnarFileSink.
+
+Renders either format back to the layouts produced by the text sinks or by
+StructuredJsonSink:
+- text (default): "YYYY-MM-DD HH:MM:SS.mmm [LEVEL] logger: message key=value ..."
+- --json: one JSON object per line, same keys as StructuredJsonSink
+
+A truncated tail (e.g. a file copied while the application was writing it)
+is reported on stderr; every complete record before it is still printed.
+
+--since/--until restrict output to a time range; for columnar files whole
+blocks outside the range are skipped using their min/max timestamps.
+
+Usage:
+    python tools/zyrnix_decode.py app.zlog
+    python tools/zyrnix_decode.py --json app.zlog > app.jsonl
+    python tools/zyrnix_decode.py --utc app.zlog
+    python tools/zyrnix_decode.py --since 2025-01-02T10:00 --until 2025-01-02T11:00 app.zcol
+"""
+
+import argparse
+import json
+import math
+import struct
+import sys
+from datetime import datetime, timezone
+from typing import Dict, Iterator, List, Optional, Tuple
+
+MAGIC = b"ZYRNIXB"
+COLUMNAR_MAGIC = b"ZYRNIXC"
+SUPPORTED_VERSION = 1
+
+TAG_BLOCK = 0x01
+TAG_STRING = 0x02
+TAG_RECORD = 0x03
+
+FLAG_MESSAGE_REF = 0x08
+
+LEVEL_NAMES = ["TRACE", "DEBUG", "INFO", "WARN", "ERROR", "CRITICAL"]
+
+TYPE_NULL, TYPE_INT, TYPE_UINT, TYPE_DOUBLE, TYPE_BOOL, TYPE_STRING = range(6)
+TYPE_VARIANT = 0xFF
+
+ENC_PLAIN, ENC_DICT, ENC_DELTA, ENC_VARIANT = range(4)
+
+
+class Truncated(Exception):
+    """Raised when the stream ends in the middle of an entry."""
+
+
+class DecodeError(Exception):
+    """Raised on malformed input."""
+
+
+class Reader:
+    """Cursor over the raw bytes of a binary log."""
+
+    def __init__(self, data: bytes):
+        self.data = data
+        self.pos = 0
+
+    def eof(self) -> bool:
+        return self.pos >= len(self.data)
+
+    def u8(self) -> int:
+        if self.pos >= len(self.data):
+            raise Truncated()
+        value = self.data[self.pos]
+        self.pos += 1
+        return value
+
+    def varint(self) -> int:
+        result = 0
+        shift = 0
+        while True:
+            byte = self.u8()
+            result |= (byte & 0x7F) << shift
+            if not byte & 0x80:
+                return result
+            shift += 7
+            if shift > 63:
+                raise DecodeError(f"varint too long at offset {self.pos}")
+
+    def svarint(self) -> int:
+        value = self.varint()
+        return (value >> 1) ^ -(value & 1)
+
+    def raw(self, n: int) -> bytes:
+        if self.pos + n > len(self.data):
+            raise Truncated()
+        value = self.data[self.pos:self.pos + n]
+        self.pos += n
+        return value
+
+    def double(self) -> float:
+        return struct.unpack("<d", self.raw(8))[0]
+
+    def text(self) -> str:
+        return self.raw(self.varint()).decode("utf-8", errors="replace")
+
+
+Record = Tuple[int, int, str, str, List[Tuple[str, object]]]
+
+
+def decode(data: bytes, since: Optional[int] = None,
+           until: Optional[int] = None) -> Iterator[Record]:
+    """Yield (timestamp_ns, level, logger, message, fields) tuples."""
+    reader = Reader(data)
+    if data.startswith(MAGIC):
+        records = decode_records(reader)
+    elif data.startswith(COLUMNAR_MAGIC):
+        records = decode_blocks(reader, since, until)
+    else:
+        raise DecodeError("not a Zyrnix binary log (bad magic)")
+
+    reader.pos = len(MAGIC)
+    version = reader.u8()
+    if version != SUPPORTED_VERSION:
+        raise DecodeError(f"unsupported format version {version}")
+
+    for record in records:
+        if since is not None and record[0] < since:
+            continue
+        if until is not None and record[0] > until:
+            continue
+        yield record
+
+
+def decode_records(reader: Reader) -> Iterator[Record]:
+    """Decode the record stream written by BinaryFileSink."""
+    data = reader.data
+
+    dictionary: Dict[int, str] = {}
+    timestamp = 0
+
+    while not reader.eof():
+        start = reader.pos
+        try:
+            tag = reader.u8()
+            if tag == TAG_BLOCK:
+                timestamp = reader.varint()
+                dictionary = {}
+            elif tag == TAG_STRING:
+                string_id = reader.varint()
+                dictionary[string_id] = reader.text()
+            elif tag == TAG_RECORD:
+                timestamp += reader.svarint()
+                flags = reader.u8()
+                logger = lookup(dictionary, reader.varint())
+                if flags & FLAG_MESSAGE_REF:
+                    message = lookup(dictionary, reader.varint())
+                else:
+                    message = reader.text()
+                fields = []
+                for _ in range(reader.varint()):
+                    key = lookup(dictionary, reader.varint())
+                    fields.append((key, read_value(reader)))
+                yield timestamp, flags & 0x07, logger, message, fields
+            else:
+                raise DecodeError(f"unknown tag 0x{tag:02x} at offset {start}")
+        except Truncated:
+            print(f"warning: truncated entry at offset {start}, "
+                  f"{len(data) - start} trailing bytes ignored", file=sys.stderr)
+            return
+
+
+def decode_blocks(reader: Reader, since: Optional[int],
+                  until: Optional[int]) -> Iterator[Record]:
+    """Decode the column blocks written by ColumnarFileSink."""
+    data = reader.data
+    while not reader.eof():
+        start = reader.pos
+        try:
+            tag = reader.u8()
+            if tag != TAG_BLOCK:
+                raise DecodeError(f"unknown tag 0x{tag:02x} at offset {start}")
+            rows = reader.varint()
+            min_ts = reader.varint()
+            max_ts = reader.varint()
+            body = reader.raw(reader.varint())
+        except Truncated:
+            print(f"warning: truncated block at offset {start}, "
+                  f"{len(data) - start} trailing bytes ignored", file=sys.stderr)
+            return
+
+        if (since is not None and max_ts < since) or (until is not None and min_ts > until):
+            continue
+
+        try:
+            yield from decode_block(Reader(body), rows)
+        except Truncated:
+            raise DecodeError(f"corrupt block at offset {start}") from None
+
+
+MISSING = object()
+
+
+def decode_block(body: Reader, rows: int) -> Iterator[Record]:
+    _, timestamps = read_column(body, rows)
+    _, levels = read_column(body, rows)
+    _, loggers = read_column(body, rows)
+    _, messages = read_column(body, rows)
+    field_columns = [read_column(body, rows) for _ in range(body.varint())]
+
+    for i in range(rows):
+        fields = [(name, values[i]) for name, values in field_columns
+                  if values[i] is not MISSING]
+        yield timestamps[i], levels[i], loggers[i], messages[i], fields
+
+
+def read_column(body: Reader, rows: int) -> Tuple[str, List[object]]:
+    """Read one column and return its name and one value per row."""
+    name = body.text()
+    encoding = body.u8()
+    value_type = body.u8()
+    has_validity = body.u8()
+
+    if has_validity:
+        bitmap = body.raw((rows + 7) // 8)
+        present = [bool(bitmap[i // 8] & (1 << (i % 8))) for i in range(rows)]
+    else:
+        present = [True] * rows
+    count = sum(present)
+
+    if encoding == ENC_PLAIN:
+        values = [read_typed(body, value_type) for _ in range(count)]
+    elif encoding == ENC_DICT:
+        entries = [body.text() for _ in range(body.varint())]
+        values = [entries[body.varint()] for _ in range(count)]
+    elif encoding == ENC_DELTA:
+        values = []
+        current = 0
+        for _ in range(count):
+            current += body.svarint()
+            values.append(current)
+    elif encoding == ENC_VARIANT:
+        values = [read_value(body) for _ in range(count)]
+    else:
+        raise DecodeError(f"unknown column encoding {encoding} for '{name}'")
+
+    it = iter(values)
+    column = [next(it) if p else MISSING for p in present]
+    if encoding == ENC_VARIANT:
+        # Null rows of variant columns carry an explicit Null tag
+        column = [MISSING if v is None else v for v in column]
+    return name, column
+
+
+def lookup(dictionary: Dict[int, str], string_id: int) -> str:
+    try:
+        return dictionary[string_id]
+    except KeyError:
+        raise DecodeError(f"undefined dictionary id {string_id}") from None
+
+
+def read_value(reader: Reader) -> object:
+    return read_typed(reader, reader.u8())
+
+
+def read_typed(reader: Reader, value_type: int) -> object:
+    if value_type == TYPE_NULL:
+        return None
+    if value_type == TYPE_INT:
+        return reader.svarint()
+    if value_type == TYPE_UINT:
+        return reader.varint()
+    if value_type == TYPE_DOUBLE:
+        return reader.double()
+    if value_type == TYPE_BOOL:
+        return reader.u8() != 0
+    if value_type == TYPE_STRING:
+        return reader.text()
+    raise DecodeError(f"unknown field type {value_type}")
+
+
+def level_name(level: int) -> str:
+    return LEVEL_NAMES[level] if level < len(LEVEL_NAMES) else "UNKNOWN"
+
+
+def value_text(value: object) -> str:
+    if value is None:
+        return "null"
+    if isinstance(value, bool):
+        return "true" if value else "false"
+    return str(value)
+
+
+def format_text(record: Record, utc: bool) -> str:
+    timestamp, level, logger, message, fields = record
+    seconds, nanos = divmod(timestamp, 1_000_000_000)
+    when = datetime.fromtimestamp(seconds, tz=timezone.utc if utc else None)
+    line = (f"{when.strftime('%Y-%m-%d %H:%M:%S')}.{nanos // 1_000_000:03d} "
+            f"[{level_name(level)}] {logger}: {message}")
+    for key, value in fields:
+        line += f" {key}={value_text(value)}"
+    return line
+
+
+def format_json(record: Record) -> str:
+    timestamp, level, logger, message, fields = record
+    seconds, nanos = divmod(timestamp, 1_000_000_000)
+    when = datetime.fromtimestamp(seconds, tz=timezone.utc)
+    obj = {
+        "timestamp": f"{when.strftime('%Y-%m-%dT%H:%M:%S')}.{nanos // 1_000_000:03d}Z",
+        "level": level_name(level),
+        "logger": logger,
+        "message": message,
+    }
+    for key, value in fields:
+        if isinstance(value, float) and not math.isfinite(value):
+            value = None
+        obj[key] = value
+    return json.dumps(obj, ensure_ascii=False, separators=(",", ":"))
+
+
+def parse_time(value: str) -> int:
+    """Parse an ISO-8601 time into nanoseconds since the epoch."""
+    try:
+        when = datetime.fromisoformat(value.replace("Z", "+00:00"))
+    except ValueError:
+        raise argparse.ArgumentTypeError(f"invalid time: {value}") from None
+    return int(when.timestamp()) * 1_000_000_000 + when.microsecond * 1000
+
+
+def main(argv: Optional[List[str]] = None) -> int:
+    parser = argparse.ArgumentParser(description="Decode Zyrnix binary log files")
+    parser.add_argument("files", nargs="+", help="binary log files to decode")
+    parser.add_argument("--json", action="store_true", help="emit JSON Lines")
+    parser.add_argument("--utc", action="store_true",
+                        help="print text timestamps in UTC instead of local time")
+    parser.add_argument("--since", type=parse_time,
+                        help="only records at or after this ISO-8601 time (local unless offset given)")
+    parser.add_argument("--until", type=parse_time,
+                        help="only records at or before this ISO-8601 time")
+    args = parser.parse_args(argv)
+
+    status = 0
+    for path in args.files:
+        try:
+            with open(path, "rb") as f:
+                data = f.read()
+            for record in decode(data, args.since, args.until):
+                print(format_json(record) if args.json else format_text(record, args.utc))
+        except (OSError, DecodeError) as e:
+            print(f"error: {path}: {e}", file=sys.stderr)
+            status = 1
+    return status
+
+
+if __name__ == "__main__":
+    sys.exit(main())